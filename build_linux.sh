@@ -5,14 +5,14 @@ set -euo pipefail
 mkdir -p build
 
 CXX="${CXX:-g++}"
-CXXFLAGS=(-std=c++17 -O2 -Wall -Wextra -Isrc)
+CXXFLAGS=(-std=c++17 -O2 -Wall -Wextra -pthread -Isrc)
 
 SOURCES=(
   src/main.cpp
 )
 
 # Collect all .cpp files from subfolders
-for dir in board gameengine gamelogger testsuite util stats mainmenu; do
+for dir in board gameengine gamelogger testsuite util stats mainmenu solver book bench batch selfplay mcts server; do
   while IFS= read -r -d '' f; do
     SOURCES+=("$f")
   done < <(find "src/$dir" -type f -name "*.cpp" -print0 2>/dev/null || true)
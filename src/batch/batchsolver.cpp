@@ -0,0 +1,133 @@
+#include "batchsolver.h"
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "board/bitboard.h"
+#include "book/openingbook.h"
+#include "solver/solver.h"
+#include "solver/transpositiontable.h"
+
+using namespace std;
+
+namespace {
+    struct Job {
+        size_t seq;
+        string position;
+    };
+
+    string trim(const string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == string::npos) return "";
+        size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+
+    string solveLine(const string& position, Solver& solver, const OpeningBook& book) {
+        ostringstream line;
+        line << position << ' ';
+
+        BitBoard b;
+        if (!BitBoard::fromMoves(position, b) || b.isFull()) {
+            line << "invalid - 0 0\n";
+            return line.str();
+        }
+
+        int score = 0, move = -1;
+        if (book.lookup(b, score, move)) {
+            line << score << ' ' << (move + 1) << " 0 0\n";
+            return line.str();
+        }
+
+        SearchResult res = solver.solve(b);
+        line << res.score << ' ' << (res.bestMove + 1) << ' ' << res.nodes << ' ' << res.micros << '\n';
+        return line.str();
+    }
+}
+
+size_t BatchSolver::run(istream& in, ostream& out, const Options& options) {
+    int threads = options.threads > 0 ? options.threads : (int)thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    const size_t window = options.window > 0 ? options.window : (size_t)threads * 64;
+
+    TranspositionTable tt(options.ttMegabytes);
+    OpeningBook book;
+    book.open(options.bookPath); // optional
+
+    // Begrenzter Speicher: der Leser wartet, solange `window` Zeilen gelesen,
+    // aber noch nicht ausgegeben sind (gilt auch für den Umsortierpuffer)
+    mutex m;
+    condition_variable canRead, canWork;
+    deque<Job> queue;
+    map<size_t, string> pending; // fertige Zeilen, die auf Vorgänger warten
+    size_t nextOut = 0;
+    size_t inFlight = 0;
+    bool eof = false;
+
+    auto emit = [&](size_t seq, string text) {
+        // Aufruf mit gehaltenem Lock
+        if (!options.ordered) {
+            out << text;
+            --inFlight;
+            return;
+        }
+        pending.emplace(seq, move(text));
+        for (auto it = pending.begin(); it != pending.end() && it->first == nextOut; it = pending.erase(it)) {
+            out << it->second;
+            ++nextOut;
+            --inFlight;
+        }
+    };
+
+    auto work = [&]() {
+        Solver solver(&tt);
+        while (true) {
+            Job job;
+            {
+                unique_lock<mutex> lock(m);
+                canWork.wait(lock, [&] { return !queue.empty() || eof; });
+                if (queue.empty()) return;
+                job = move(queue.front());
+                queue.pop_front();
+            }
+            string text = solveLine(job.position, solver, book);
+            {
+                lock_guard<mutex> lock(m);
+                emit(job.seq, move(text));
+            }
+            canRead.notify_one();
+        }
+    };
+
+    vector<thread> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(work);
+
+    size_t seq = 0;
+    string line;
+    while (getline(in, line)) {
+        string position = trim(line);
+        if (position.empty()) continue;
+
+        unique_lock<mutex> lock(m);
+        canRead.wait(lock, [&] { return inFlight < window; });
+        queue.push_back({seq++, move(position)});
+        ++inFlight;
+        lock.unlock();
+        canWork.notify_one();
+    }
+
+    {
+        lock_guard<mutex> lock(m);
+        eof = true;
+    }
+    canWork.notify_all();
+    for (auto& t : workers) t.join();
+    out.flush();
+    return seq;
+}
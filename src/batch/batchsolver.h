@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include "constants.h"
+
+// Nicht-interaktives Lösen vieler Stellungen (--solve):
+// pro Eingabezeile eine Zugfolge ("4453", Spalten 1..COLS), pro Stellung
+// eine Ausgabezeile "position score best_move nodes micros".
+// Ungültige Zeilen ergeben "position invalid - 0 0".
+class BatchSolver {
+public:
+    struct Options {
+        int threads = 0;                         // <= 0: alle Kerne
+        size_t ttMegabytes = TT_DEFAULT_MB;
+        std::string bookPath = OPENING_BOOK_PATH;
+        bool ordered = true;                     // Ausgabe in Eingabereihenfolge
+        size_t window = 0;                       // max. Zeilen in Arbeit; 0 = 64 pro Thread
+    };
+
+    // Rückgabe: Anzahl verarbeiteter Stellungen
+    static size_t run(std::istream& in, std::ostream& out, const Options& options);
+};
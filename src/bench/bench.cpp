@@ -0,0 +1,942 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+  #include <sys/epoll.h>
+  #include <sys/socket.h>
+  #include <sys/un.h>
+#endif
+
+#include "board/bitboard.h"
+#include "board/board.h"
+#include "board/zobrist.h"
+#include "gamelogger/gamelogger.h"
+#include "gamelogger/positiondb.h"
+#include "mainmenu/mainmenu.h"
+#include "constants.h"
+#include "mcts/batchplayout.h"
+#include "mcts/mcts.h"
+#include "selfplay/selfplay.h"
+#include "server/gameserver.h"
+#include "stats/stats.h"
+#include "stats/statswriter.h"
+#include "util/rng.h"
+#include "util/screen.h"
+#include "solver/parallelsearch.h"
+#include "solver/transpositiontable.h"
+
+#if __has_include(<filesystem>)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+  #define HAS_FILESYSTEM 1
+#else
+  #define HAS_FILESYSTEM 0
+#endif
+
+using namespace std;
+
+namespace {
+    // Mittelspiel-Stellungen (Zugfolgen, Spalten 1..7), die ein Thread in
+    // einigen Sekunden exakt löst
+    const char* MIDGAME_POSITIONS[] = {
+        "72353335",
+        "23161654",
+        "24716167",
+        "54433413",
+        "47122177",
+        "6772257244",
+    };
+
+    // Brett so, wie es vor Screen ausgegeben wurde: Bildschirm löschen, jede Zelle einzeln
+    void legacyBoard(ostream& os, const Board& board, int ghostRow, int ghostCol, char ghostSymbol) {
+        auto renderCell = [&](int r, int c) -> string {
+            char cell = (r == ghostRow && c == ghostCol) ? ghostSymbol : board.cellAt(r, c);
+            if (cell == 'X') return "●";
+            if (cell == 'O') return "○";
+            return " ";
+        };
+        os << "\033[2J\033[H\033[3J" << flush;
+        os << "\n    1   2   3   4   5   6   7\n";
+        os << "  ╔═══╦═══╦═══╦═══╦═══╦═══╦═══╗\n";
+        for (int r = 0; r < ROWS; ++r) {
+            os << "  ║";
+            for (int c = 0; c < COLS; ++c) os << " " << renderCell(r, c) << " ║";
+            os << "\n";
+            if (r != ROWS - 1) os << "  ╠═══╬═══╬═══╬═══╬═══╬═══╬═══╣\n";
+        }
+        os << "  ╚═══╩═══╩═══╩═══╩═══╩═══╩═══╝\n\n";
+    }
+
+    // Anzeige-Brett wie vor GameBoard<Rows, Cols>: char-Gitter mit
+    // Laufzeitschleifen über ROWS/COLS (Regeln machte das BitBoard)
+    class LegacyBoard {
+    public:
+        LegacyBoard() {
+            for (int r = 0; r < ROWS; ++r)
+                for (int c = 0; c < COLS; ++c) grid[r][c] = ' ';
+        }
+
+        int dropDisc(int col, char symbol) {
+            if (col < 0 || col >= COLS || grid[0][col] != ' ') return -1;
+            for (int r = ROWS - 1; r >= 0; --r)
+                if (grid[r][col] == ' ') {
+                    grid[r][col] = symbol;
+                    return r;
+                }
+            return -1;
+        }
+
+    private:
+        char grid[ROWS][COLS];
+    };
+
+    // Regeln auf dem BitBoard (wer am Zug ist, weiß es selbst: symbol zählt nicht)
+    struct BitRules {
+        static constexpr int WIDTH = COLS;
+        BitBoard bits;
+
+        bool isValidColumn(int col) const { return bits.isValidColumn(col); }
+        int dropDisc(int col, char) { return bits.dropDisc(col); }
+        bool checkWinAt(int row, int col) const { return bits.checkWinAt(row, col); }
+        bool isFull() const { return bits.isFull(); }
+    };
+
+    // 7x6 wie in der Spielschleife: Regeln auf dem BitBoard, das
+    // Anzeige-Brett bekommt jeden Stein mit
+    template <typename Display>
+    struct BitRulesWith : BitRules {
+        Display display;
+
+        int dropDisc(int col, char symbol) {
+            display.dropDisc(col, symbol);
+            return bits.dropDisc(col);
+        }
+    };
+
+    // Zufallspartien als Zugfolgen (-1 beendet eine Partie), vorab erzeugt,
+    // damit die Messung nur das Brett selbst sieht
+    template <typename B>
+    vector<int8_t> randomGames(int games, uint64_t seed) {
+        vector<int8_t> out;
+        uint64_t rng = seed;
+        for (int g = 0; g < games; ++g) {
+            B b;
+            for (int ply = 0;; ++ply) {
+                int col;
+                do col = static_cast<int>(nextRandom(rng) % B::WIDTH);
+                while (!b.isValidColumn(col));
+                const int row = b.dropDisc(col, ply % 2 ? 'O' : 'X');
+                out.push_back(static_cast<int8_t>(col));
+                if (b.checkWinAt(row, col) || b.isFull()) break;
+            }
+            out.push_back(-1);
+        }
+        return out;
+    }
+
+    // Spielt die Zugfolgen wie die Spielschleife nach: setzen, Gewinn an der
+    // Zielzelle prüfen, volles Brett prüfen. Rückgabe: Siege, Remis
+    template <typename B>
+    pair<long long, long long> replayGames(const vector<int8_t>& moves) {
+        long long wins = 0, draws = 0;
+        B b;
+        int ply = 0;
+        for (int8_t col : moves) {
+            if (col < 0) {
+                b = B();
+                ply = 0;
+                continue;
+            }
+            const int row = b.dropDisc(col, ply++ % 2 ? 'O' : 'X');
+            if (b.checkWinAt(row, col)) ++wins;
+            else if (b.isFull()) ++draws;
+        }
+        return {wins, draws};
+    }
+
+    // Menü wie vor Screen: Bildschirm löschen, Logo und Box komplett
+    // (frame dient nur dazu, an den Text des Menüs zu kommen)
+    void legacyMenu(ostream& os, Screen& frame, const vector<string>& items, int selected) {
+        MainMenu::draw(frame, items, selected);
+        os << "\033[2J\033[H";
+        for (int r = 0; r < frame.height(); ++r) os << frame.line(r) << "\n";
+    }
+
+    void writeAll(int fd, const string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n <= 0) return;
+            done += static_cast<size_t>(n);
+        }
+    }
+}
+
+void Bench::smpScaling(int maxThreads, size_t ttMegabytes, ostream& out) {
+    vector<BitBoard> boards;
+    for (const char* moves : MIDGAME_POSITIONS) {
+        BitBoard b;
+        if (BitBoard::fromMoves(moves, b)) boards.push_back(b);
+    }
+
+    out << "Lazy SMP: " << boards.size() << " Mittelspiel-Stellungen, TT " << ttMegabytes << " MB\n";
+    out << setw(8) << "Threads" << setw(12) << "Zeit(ms)" << setw(16) << "Knoten"
+        << setw(12) << "MKnoten/s" << setw(10) << "Speedup" << "\n";
+
+    double baseMs = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        long long micros = 0;
+        unsigned long long nodes = 0;
+        for (const auto& b : boards) {
+            TranspositionTable tt(ttMegabytes); // frische Tabelle pro Lauf
+            ParallelSearch search(tt, threads);
+            SearchResult res = search.solve(b);
+            micros += res.micros;
+            nodes += res.nodes;
+        }
+        double ms = micros / 1000.0;
+        if (threads == 1) baseMs = ms;
+        out << setw(8) << threads
+            << setw(12) << fixed << setprecision(1) << ms
+            << setw(16) << nodes
+            << setw(12) << setprecision(2) << (micros ? nodes / (double)micros : 0.0)
+            << setw(10) << setprecision(2) << (ms > 0 ? baseMs / ms : 0.0) << "\n";
+        out.unsetf(ios::floatfield);
+    }
+}
+
+void Bench::mcts(ostream& out) {
+    const char* positions[] = {"", "4", "4453"};
+    out << "MCTS: " << ENGINE_BUDGET_MS << " ms pro Stellung, Arena " << MCTS_DEFAULT_MB << " MB\n";
+    out << setw(12) << "Stellung" << setw(12) << "Playouts" << setw(14) << "Playouts/s"
+        << setw(10) << "Knoten" << setw(12) << "Spitze(MB)" << setw(6) << "Zug" << "\n";
+
+    auto row = [&](const string& name, const MctsResult& r) {
+        out << setw(12) << name << setw(12) << r.playouts
+            << setw(14) << fixed << setprecision(0) << r.playoutsPerSecond()
+            << setw(10) << r.nodes
+            << setw(12) << setprecision(1) << r.peakBytes / (1024.0 * 1024.0)
+            << setw(6) << r.bestMove + 1 << "\n";
+        out.unsetf(ios::floatfield);
+    };
+
+    vector<string> all(begin(positions), end(positions));
+    all.insert(all.end(), begin(MIDGAME_POSITIONS), end(MIDGAME_POSITIONS));
+    for (const auto& moves : all) {
+        BitBoard b;
+        if (!BitBoard::fromMoves(moves, b)) continue;
+        Mcts engine;
+        row(moves.empty() ? "(leer)" : moves, engine.search(b, ENGINE_BUDGET_MS));
+    }
+
+    // Wiederverwendung: zwei Züge später mit dem alten Baum weitersuchen
+    Mcts engine;
+    BitBoard b;
+    MctsResult first = engine.search(b, ENGINE_BUDGET_MS);
+    b.dropDisc(first.bestMove);
+    b.dropDisc(first.bestMove);
+    MctsResult second = engine.search(b, ENGINE_BUDGET_MS);
+    out << "Wiederverwendung nach 2 Zügen: " << second.reusedVisits << " von "
+        << first.playouts << " Playouts übernommen\n";
+}
+
+void Bench::playouts(ostream& out) {
+    using Clock = chrono::steady_clock;
+    const long long games = 4000000;
+    const BitBoard start;
+
+    out << "Zufallspartien ab leerem Brett, " << games << " pro Messung, 1 Kern\n";
+    out << setw(22) << "Verfahren" << setw(12) << "Zeit(ms)" << setw(14) << "Partien/s"
+        << setw(10) << "Ø Züge" << setw(10) << "Sieg X" << "\n";
+
+    auto row = [&](const string& name, Clock::time_point t0, const BatchPlayout::Totals& t) {
+        double ms = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+        out << setw(22) << name
+            << setw(12) << fixed << setprecision(1) << ms
+            << setw(14) << setprecision(0) << (ms > 0 ? t.games * 1000.0 / ms : 0.0)
+            << setw(10) << setprecision(2) << (t.games ? (double)t.moves / t.games : 0.0)
+            << setw(9) << setprecision(1) << (t.games ? 100.0 * t.wins[0] / t.games : 0.0) << "%\n";
+        out.unsetf(ios::floatfield);
+    };
+
+    // Referenz: eine Partie nach der anderen, wie bisher in Selbstspiel/MCTS
+    {
+        auto t0 = Clock::now();
+        BatchPlayout::Totals t;
+        uint64_t rng = 1;
+        for (long long g = 0; g < games; ++g) {
+            BitBoard b = start;
+            while (true) {
+                int p = b.currentPlayer();
+                b.dropDisc(randomBitIndex(b.possibleMask(), rng) / BitBoard::H1);
+                if (b.checkWin(p)) { ++t.wins[p]; break; }
+                if (b.isFull()) { ++t.draws; break; }
+            }
+            ++t.games;
+            t.moves += b.moveCount();
+        }
+        row("einzeln (BitBoard)", t0, t);
+    }
+
+    for (auto kernel : {BatchPlayout::Kernel::Scalar, BatchPlayout::Kernel::Avx2}) {
+        if (kernel == BatchPlayout::Kernel::Avx2 && !BatchPlayout::avx2Available()) {
+            out << setw(22) << "AVX2" << "  (von dieser CPU nicht unterstützt)\n";
+            continue;
+        }
+        auto t0 = Clock::now();
+        BatchPlayout::Totals t = BatchPlayout::run(start, games, 1, kernel);
+        row(string("Batch ") + to_string(BatchPlayout::LANES) + " Lanes, "
+            + BatchPlayout::kernelName(kernel), t0, t);
+    }
+}
+
+void Bench::logFormats(ostream& out) {
+#if HAS_FILESYSTEM
+    using Clock = chrono::steady_clock;
+    const int games = 20000;
+    const fs::path dir = fs::temp_directory_path() / "c4_bench_logs";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // Partien mit menschenähnlichen Bedenkzeiten (0..15 s)
+    Policy policies[2];
+    Policy::parse("greedy", policies[0]);
+    Policy::parse("greedy", policies[1]);
+    const string players[2] = {"Spieler 1", "Spieler 2"};
+    const char symbols[2] = {'X', 'O'};
+    vector<Move> moves;
+    uint64_t rng = 42;
+    for (int g = 0; g < games; ++g) {
+        int result = SelfPlay::playGame(policies, 4, splitmix64(g + 1), moves);
+        for (auto& m : moves) m.moveTimeMs = static_cast<long long>(nextRandom(rng) % TURN_LIMIT_MS);
+        GameLogger::save((dir / ("v2_" + to_string(g) + ".log")).string(), moves, players, symbols, result, LogFormat::V2);
+        GameLogger::save((dir / ("v3_" + to_string(g) + ".log")).string(), moves, players, symbols, result, LogFormat::V3);
+    }
+
+    out << games << " Partien pro Format\n";
+    out << setw(8) << "Format" << setw(14) << "Byte gesamt" << setw(12) << "Byte/Zug"
+        << setw(12) << "Lesen(ms)" << setw(14) << "Partien/s" << "\n";
+    for (const char* format : {"v2", "v3"}) {
+        size_t bytes = 0;
+        long long totalMoves = 0;
+        for (int g = 0; g < games; ++g) bytes += fs::file_size(dir / (string(format) + "_" + to_string(g) + ".log"));
+
+        GameLog log;
+        auto t0 = Clock::now();
+        for (int g = 0; g < games; ++g) {
+            if (GameLogger::read((dir / (string(format) + "_" + to_string(g) + ".log")).string(), log))
+                totalMoves += static_cast<long long>(log.moves.size());
+        }
+        double ms = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+        out << setw(8) << format << setw(14) << bytes
+            << setw(12) << fixed << setprecision(2) << (totalMoves ? (double)bytes / totalMoves : 0.0)
+            << setw(12) << setprecision(1) << ms
+            << setw(14) << setprecision(0) << (ms > 0 ? games * 1000.0 / ms : 0.0) << "\n";
+        out.unsetf(ios::floatfield);
+    }
+    fs::remove_all(dir);
+#else
+    out << "Messung braucht <filesystem>.\n";
+#endif
+}
+
+void Bench::statsCsv(int maxThreads, ostream& out) {
+    using Clock = chrono::steady_clock;
+    const size_t rows = 4000000;
+    const string csv = "/tmp/c4_bench_stats.csv";
+    remove(csv.c_str());
+    remove(Stats::snapshotPath(csv).c_str());
+
+    vector<GameSummary> games;
+    games.reserve(rows);
+    uint64_t rng = 7;
+    for (size_t i = 0; i < rows; ++i) {
+        GameSummary g;
+        g.players[0] = "Spieler " + to_string(nextRandom(rng) % 1000);
+        g.players[1] = "Spieler " + to_string(nextRandom(rng) % 1000);
+        g.result = static_cast<int>(nextRandom(rng) % 3);
+        for (int p = 0; p < 2; ++p) {
+            g.moves[p] = 4 + static_cast<long long>(nextRandom(rng) % 17);
+            g.totalMs[p] = static_cast<long long>(nextRandom(rng) % 200000);
+            g.fastest[p] = static_cast<long long>(nextRandom(rng) % 500);
+            g.slowest[p] = g.fastest[p] + static_cast<long long>(nextRandom(rng) % 15000);
+        }
+        g.totalGameMs = g.totalMs[0] + g.totalMs[1];
+        games.push_back(g);
+    }
+    Stats::appendGames(csv, games);
+    games.clear();
+    games.shrink_to_fit();
+
+    // Referenz: der frühere Parser (stringstream + getline + stoll pro Feld)
+    auto t0 = Clock::now();
+    size_t oldRows = 0;
+    {
+        ifstream in(csv);
+        string line;
+        getline(in, line);
+        unordered_map<string, long long> wins;
+        while (getline(in, line)) {
+            stringstream ss(line);
+            string p0, p1, tok;
+            getline(ss, p0, ',');
+            getline(ss, p1, ',');
+            getline(ss, tok, ',');
+            int result = stoi(tok);
+            long long sum = 0;
+            for (int f = 0; f < 9; ++f) {
+                getline(ss, tok, ',');
+                sum += stoll(tok);
+            }
+            wins[result == 2 ? p1 : p0] += sum > 0;
+            ++oldRows;
+        }
+    }
+    double oldMs = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+
+    out << rows << " Zeilen\n";
+    out << setw(22) << "Parser" << setw(12) << "Zeit(ms)" << setw(16) << "Zeilen/s" << "\n";
+    auto row = [&](const string& name, double ms, size_t n) {
+        out << setw(22) << name << setw(12) << fixed << setprecision(1) << ms
+            << setw(16) << setprecision(0) << (ms > 0 ? n * 1000.0 / ms : 0.0) << "\n";
+        out.unsetf(ios::floatfield);
+    };
+    row("stringstream", oldMs, oldRows);
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        remove(Stats::snapshotPath(csv).c_str());  // sonst nur der (leere) Rest
+        CsvParseInfo info;
+        auto t1 = Clock::now();
+        Stats::loadAggregated(csv, &info, threads);
+        double ms = chrono::duration_cast<chrono::microseconds>(Clock::now() - t1).count() / 1000.0;
+        row("mmap/string_view x" + to_string(threads), ms, info.rows);
+    }
+    // dasselbe mit Partien pro Spielerpaar und Elo (Statistik-Menü, Taste E)
+    remove(Stats::snapshotPath(csv).c_str());
+    CsvParseInfo info;
+    auto t2 = Clock::now();
+    Stats::loadAggregated(csv, &info, 1, true);
+    row("mit Elo x1", chrono::duration_cast<chrono::microseconds>(Clock::now() - t2).count() / 1000.0, info.rows);
+    remove(csv.c_str());
+    remove(Stats::snapshotPath(csv).c_str());
+}
+
+void Bench::statsWriter(int threads, ostream& out) {
+    using Clock = chrono::steady_clock;
+    const int perThread = 20000;
+    const string csv = "/tmp/c4_bench_writer.csv";
+    const string players[2] = {"Spieler 1", "Spieler 2"};
+    vector<Move> moves;
+    for (int i = 0; i < 20; ++i) moves.push_back({i % 2, i % 7, 100 + 37 * i});
+    const GameSummary game = Stats::summarize(players, 1, moves);
+
+    out << threads << " Erzeuger x " << perThread << " Partien\n";
+    out << setw(22) << "Verfahren" << setw(12) << "Zeit(ms)" << setw(14) << "Zeilen/s" << setw(10) << "write()" << "\n";
+    for (int mode = 0; mode < 2; ++mode) {
+        remove(csv.c_str());
+        uint64_t writes = 0;
+        auto t0 = Clock::now();
+        {
+            StatsWriter writer(csv);
+            vector<thread> producers;
+            for (int t = 0; t < threads; ++t) {
+                producers.emplace_back([&]() {
+                    for (int i = 0; i < perThread; ++i) {
+                        if (mode == 0) Stats::appendGames(csv, {game});
+                        else writer.add(game);
+                    }
+                });
+            }
+            for (auto& p : producers) p.join();
+            writer.flush();
+            writes = mode == 0 ? static_cast<uint64_t>(threads) * perThread : writer.writes();
+        }
+        double ms = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+        CsvParseInfo info;
+        remove(Stats::snapshotPath(csv).c_str());
+        Stats::loadAggregated(csv, &info, 1);
+        out << setw(22) << (mode == 0 ? "einzeln (flock)" : "StatsWriter") << setw(12) << fixed << setprecision(1) << ms
+            << setw(14) << setprecision(0) << (ms > 0 ? threads * perThread * 1000.0 / ms : 0.0)
+            << setw(10) << writes << "   (" << info.rows << " Zeilen, " << info.badRows << " kaputt)\n";
+        out.unsetf(ios::floatfield);
+    }
+    remove(csv.c_str());
+    remove(Stats::snapshotPath(csv).c_str());
+}
+
+void Bench::terminal(ostream& out) {
+    using Clock = chrono::steady_clock;
+    const int fd = ::open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        out << "/dev/null nicht beschreibbar.\n";
+        return;
+    }
+    const int repeats = 200;
+
+    // Eine Partie mit Animation: pro Zug fällt der Stein Zeile für Zeile, dann der Zugframe
+    vector<int> cols;
+    {
+        BitBoard b;
+        uint64_t rng = 7;
+        while (!b.isFull() && cols.size() < 36) {
+            int c = static_cast<int>(nextRandom(rng) % COLS);
+            if (b.getDropRow(c) < 0) continue;
+            b.dropDisc(c);
+            cols.push_back(c);
+        }
+    }
+    const string names[2] = {"Spieler 1", "Spieler 2"};
+    const char symbols[2] = {'X', 'O'};
+
+    const vector<string> items = MainMenu::entries();
+
+    out << cols.size() << " Züge mit Animation, " << 2 * items.size() << " Pfeiltasten im Menü (je "
+        << repeats << "x, Ausgabe nach /dev/null)\n";
+    out << setw(10) << "Szene" << setw(14) << "Verfahren" << setw(10) << "Frames" << setw(14) << "Byte/Frame"
+        << setw(14) << "µs/Frame" << "\n";
+
+    for (int scene = 0; scene < 2; ++scene) {
+        for (int mode = 0; mode < 2; ++mode) {
+            size_t bytes = 0, frames = 0;
+            Screen screen;
+            ostringstream legacy;
+            auto emit = [&]() {
+                if (mode == 0) {
+                    const string s = legacy.str();
+                    writeAll(fd, s);
+                    bytes += s.size();
+                    legacy.str("");
+                } else {
+                    bytes += screen.present(fd);
+                }
+                ++frames;
+            };
+
+            auto t0 = Clock::now();
+            for (int rep = 0; rep < repeats; ++rep) {
+                screen.invalidate();
+                if (scene == 0) {
+                    Board board;
+                    for (size_t i = 0; i < cols.size(); ++i) {
+                        const int player = static_cast<int>(i % 2);
+                        const string status = "Am Zug: " + names[player] + " (" + (player == 0 ? "●" : "○") + ")";
+                        const int target = board.getDropRow(cols[i]);
+                        for (int r = -1; r <= target; ++r) {
+                            // r = -1: Zugframe vor der Eingabe
+                            const int ghostCol = r < 0 ? -1 : cols[i];
+                            if (mode == 0) {
+                                legacyBoard(legacy, board, r, ghostCol, symbols[player]);
+                                legacy << status << "\n";
+                            } else {
+                                screen.clear();
+                                int row = board.draw(screen, 0, 'X', 'O', r, ghostCol, symbols[player]);
+                                screen.text(row, 0, status);
+                            }
+                            emit();
+                        }
+                        board.dropDisc(cols[i], symbols[player]);
+                    }
+                } else {
+                    for (int k = 0; k < 2 * static_cast<int>(items.size()); ++k) {
+                        const int selected = k % static_cast<int>(items.size());
+                        if (mode == 0) legacyMenu(legacy, screen, items, selected);
+                        else MainMenu::draw(screen, items, selected);
+                        emit();
+                    }
+                }
+            }
+            double us = chrono::duration_cast<chrono::nanoseconds>(Clock::now() - t0).count() / 1000.0;
+            out << setw(scene == 0 ? 10 : 11) << (scene == 0 ? "Spiel" : "Menü") << setw(14) << (mode == 0 ? "neu zeichnen" : "Screen-Diff")
+                << setw(10) << frames << setw(14) << fixed << setprecision(1) << (double)bytes / frames
+                << setw(14) << setprecision(2) << us / frames << "\n";
+            out.unsetf(ios::floatfield);
+        }
+    }
+    ::close(fd);
+}
+
+void Bench::server(ostream& out) {
+#if defined(__linux__)
+    using Clock = chrono::steady_clock;
+    const string dir = "/tmp/c4_bench_server";
+    #if HAS_FILESYSTEM
+    try { fs::remove_all(dir); } catch (...) {}
+    #endif
+    GameServer::Options options;
+    options.socketPath = dir + ".sock";
+    options.logDir = dir;
+    options.csvPath = dir + "/stats.csv";
+    GameServer server(options);
+    string error;
+    if (!server.listen(&error)) {
+        out << "Server: " << error << "\n";
+        return;
+    }
+    thread serverThread([&]() { server.run(); });
+
+    // Lastgenerator: jede Verbindung hält slots Partien gleichzeitig offen und
+    // schickt für jede sofort den nächsten Zug, sobald die Antwort da ist
+    // (gegen greedy, zufällige legale Züge, beendete Partien werden ersetzt)
+    struct Client {
+        int fd = -1;
+        string in;
+        string out;
+        deque<pair<int, Clock::time_point>> inflight;   // Platz, Sendezeit
+        vector<string> ids;
+    };
+    const int scenarios[][2] = {{1, 1}, {16, 16}, {64, 64}};
+    const double seconds = 2.0;
+    uint64_t rng = 2026;
+
+    out << "Unix-Socket, Gegner greedy, je " << seconds << " s; Zeit = Anfrage bis Antwort beim Client\n";
+    out << setw(12) << "Verbindungen" << setw(9) << "Partien" << setw(11) << "Züge/s" << setw(13) << "Partien/s"
+        << setw(10) << "p50(µs)" << setw(10) << "p99(µs)" << setw(10) << "max(µs)" << "\n";
+    for (const auto& scenario : scenarios) {
+        const int connections = scenario[0], slots = scenario[1];
+        vector<Client> clients(static_cast<size_t>(connections));
+        const int ep = ::epoll_create1(EPOLL_CLOEXEC);
+        bool ok = ep >= 0;
+        for (size_t i = 0; i < clients.size() && ok; ++i) {
+            Client& c = clients[i];
+            c.fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            memcpy(addr.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+            ok = c.fd >= 0 && ::connect(c.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = i;
+            ok = ok && ::epoll_ctl(ep, EPOLL_CTL_ADD, c.fd, &ev) == 0;
+            c.ids.assign(static_cast<size_t>(slots), string());
+        }
+        if (!ok) {
+            out << "Verbindungsaufbau fehlgeschlagen: " << strerror(errno) << "\n";
+            for (auto& c : clients) if (c.fd >= 0) ::close(c.fd);
+            if (ep >= 0) ::close(ep);
+            break;
+        }
+
+        vector<uint32_t> micros;
+        micros.reserve(1 << 20);
+        uint64_t moves = 0, errors = 0;
+        const uint64_t finishedBefore = server.counters().gamesFinished;
+        auto send = [&](Client& c, int slot, const string& line) {
+            c.out += line;
+            c.inflight.emplace_back(slot, Clock::now());
+        };
+        for (auto& c : clients) {
+            for (int s = 0; s < slots; ++s) send(c, s, "NEW greedy 1 Bench\n");
+            if (::send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL) < 0) ++errors;
+            c.out.clear();
+        }
+
+        const auto t0 = Clock::now();
+        const auto end = t0 + chrono::duration<double>(seconds);
+        epoll_event events[256];
+        char buf[65536];
+        string_view words[4];
+        while (Clock::now() < end) {
+            int n = ::epoll_wait(ep, events, 256, 100);
+            for (int e = 0; e < n; ++e) {
+                Client& c = clients[events[e].data.u64];
+                ssize_t got = ::read(c.fd, buf, sizeof(buf));
+                if (got <= 0) { ++errors; continue; }
+                c.in.append(buf, static_cast<size_t>(got));
+                const auto now = Clock::now();
+                size_t start = 0, nl;
+                while ((nl = c.in.find('\n', start)) != string::npos) {
+                    const string_view line(c.in.data() + start, nl - start);
+                    start = nl + 1;
+                    const auto [slot, sent] = c.inflight.front();
+                    c.inflight.pop_front();
+                    micros.push_back(static_cast<uint32_t>(chrono::duration_cast<chrono::microseconds>(now - sent).count()));
+
+                    int count = 0;
+                    for (size_t i = 0; i < line.size() && count < 4;) {
+                        size_t sp = line.find(' ', i);
+                        if (sp == string_view::npos) sp = line.size();
+                        words[count++] = line.substr(i, sp - i);
+                        i = sp + 1;
+                    }
+                    if (count < 4 || words[0] != "OK") {
+                        ++errors;
+                        send(c, slot, "NEW greedy 1 Bench\n");
+                        continue;
+                    }
+                    // Antwort auf NEW: neue Nummer, sonst war es ein Zug
+                    if (c.ids[slot] != words[1]) c.ids[slot] = string(words[1]);
+                    else ++moves;
+                    if (words[3].substr(0, 4) != "TURN") {
+                        send(c, slot, "NEW greedy 1 Bench\n");
+                        continue;
+                    }
+                    BitBoard board;
+                    if (words[2] != "-") for (char col : words[2]) board.dropDisc(col - '1');
+                    const int col = randomBitIndex(board.possibleMask(), rng) / BitBoard::H1;
+                    send(c, slot, "MOVE " + c.ids[slot] + " " + to_string(col + 1) + "\n");
+                }
+                c.in.erase(0, start);
+                if (!c.out.empty()) {
+                    if (::send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL) < 0) ++errors;
+                    c.out.clear();
+                }
+            }
+        }
+        const double elapsed = chrono::duration<double>(Clock::now() - t0).count();
+        for (auto& c : clients) ::close(c.fd);
+        ::close(ep);
+
+        auto percentile = [&](double p) -> uint32_t {
+            if (micros.empty()) return 0;
+            size_t k = min(micros.size() - 1, static_cast<size_t>(p / 100.0 * micros.size()));
+            nth_element(micros.begin(), micros.begin() + static_cast<long>(k), micros.end());
+            return micros[k];
+        };
+        const uint32_t p50 = percentile(50), p99 = percentile(99);
+        const uint32_t worst = micros.empty() ? 0 : *max_element(micros.begin(), micros.end());
+        out << setw(12) << connections << setw(9) << connections * slots << setw(11) << fixed << setprecision(0)
+            << moves / elapsed << setw(13) << (server.counters().gamesFinished - finishedBefore) / elapsed
+            << setw(10) << p50 << setw(10) << p99 << setw(10) << worst;
+        if (errors) out << "   (" << errors << " Fehler)";
+        out << "\n";
+        out.unsetf(ios::floatfield);
+    }
+
+    server.stop();
+    serverThread.join();
+    const auto& c = server.counters();
+    out << "Server: " << c.gamesFinished << " Partien beendet (Log + stats.csv), " << c.moves << " Züge, "
+        << c.connections << " Verbindungen\n";
+    #if HAS_FILESYSTEM
+    try { fs::remove_all(dir); } catch (...) {}
+    #endif
+#else
+    out << "Nur unter Linux (epoll).\n";
+#endif
+}
+
+void Bench::boards(ostream& out) {
+    using Clock = chrono::steady_clock;
+    const int games = 200000;
+    const int repeats = 10;
+
+    out << "Spielschleife (setzen, checkWinAt, isFull), " << games << " Zufallspartien x " << repeats
+        << ", 1 Kern\n";
+    out << setw(28) << "Brett" << setw(12) << "Zeit(ms)" << setw(14) << "Züge/s" << setw(10) << "Siege" << setw(10) << "Remis" << "\n";
+
+    auto measure = [&](const string& name, const vector<int8_t>& moves, auto replay) {
+        long long wins = 0, draws = 0;
+        auto t0 = Clock::now();
+        for (int rep = 0; rep < repeats; ++rep) {
+            const auto r = replay(moves);
+            wins += r.first;
+            draws += r.second;
+        }
+        const double ms = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+        const long long plies = static_cast<long long>(count_if(moves.begin(), moves.end(),
+                                                                [](int8_t c) { return c >= 0; })) * repeats;
+        out << setw(28) << name << setw(12) << fixed << setprecision(1) << ms
+            << setw(14) << setprecision(0) << (ms > 0 ? plies * 1000.0 / ms : 0.0)
+            << setw(10) << wins / repeats << setw(10) << draws / repeats << "\n";
+        out.unsetf(ios::floatfield);
+    };
+
+    // dieselben Partien für alle 7x6-Varianten; die Spielschleife setzt vor
+    // und nach GameBoard auf BitBoard + Anzeige-Brett
+    const vector<int8_t> standard = randomGames<Board>(games, 1);
+    measure("7x6 BitBoard", standard, replayGames<BitRules>);
+    measure("7x6 GameBoard<6, 7>", standard, replayGames<Board>);
+    measure("7x6 BitBoard + Board (alt)", standard, replayGames<BitRulesWith<LegacyBoard>>);
+    measure("7x6 BitBoard + GameBoard", standard, replayGames<BitRulesWith<Board>>);
+    measure("8x7 GameBoard<7, 8>", randomGames<GameBoard<7, 8>>(games, 1), replayGames<GameBoard<7, 8>>);
+    measure("5x4 GameBoard<4, 5>", randomGames<GameBoard<4, 5>>(games, 1), replayGames<GameBoard<4, 5>>);
+}
+
+void Bench::positionKeys(ostream& out) {
+    using Clock = chrono::steady_clock;
+    const int games = 20000;
+    const int repeats = 20;
+
+    // Archiv-Ersatz: Greedy gegen Greedy nach 4 Zufallszügen, wie Selbstspiel-Logs
+    Policy policies[2];
+    Policy::parse("greedy", policies[0]);
+    policies[1] = policies[0];
+    vector<vector<Move>> archive(games);
+    for (int g = 0; g < games; ++g) SelfPlay::playGame(policies, 4, SelfPlay::gameSeed(1, g), archive[g]);
+
+    // Jede Stellung jeder Partie (ohne Startstellung) über alle Präfixe
+    unordered_set<uint64_t> raw, canonical, zobrist;
+    long long positions = 0;
+    for (const auto& moves : archive) {
+        BitBoard b;
+        ZobristKey z;
+        for (const Move& m : moves) {
+            const int player = b.currentPlayer();
+            z.drop(player, b.dropDisc(m.col), m.col);
+            ++positions;
+            raw.insert(b.key());
+            canonical.insert(b.canonicalKey());
+            zobrist.insert(z.canonical());
+        }
+    }
+    out << games << " Partien (Greedy, 4 Zufallszüge), " << positions << " Stellungen\n";
+    out << setw(34) << "verschieden nach key(): " << raw.size() << "\n";
+    out << setw(34) << "verschieden nach canonicalKey(): " << canonical.size() << " ("
+        << fixed << setprecision(1) << 100.0 * canonical.size() / raw.size() << "%)\n";
+    out << setw(34) << "Zobrist-Kollisionen: " << static_cast<long long>(canonical.size()) - static_cast<long long>(zobrist.size())
+        << "\n";
+
+    // Eröffnungen (wie im Buch): alle Stellungen bis Halbzug 8
+    raw.clear();
+    canonical.clear();
+    auto expand = [&](auto&& self, const BitBoard& b, int plies) -> void {
+        if (!raw.insert(b.key()).second) return;
+        canonical.insert(b.canonicalKey());
+        if (plies == 0) return;
+        for (int c = 0; c < COLS; ++c) {
+            if (!b.isValidColumn(c)) continue;
+            BitBoard child = b;
+            const int player = child.currentPlayer();
+            child.dropDisc(c);
+            if (!child.checkWin(player)) self(self, child, plies - 1);
+        }
+    };
+    expand(expand, BitBoard(), 8);
+    out << "alle Stellungen bis Halbzug 8: " << raw.size() << ", kanonisch " << canonical.size() << " ("
+        << setprecision(1) << 100.0 * canonical.size() / raw.size() << "%)\n\n";
+    out.unsetf(ios::floatfield);
+
+    // Kosten pro Stellung beim Nachspielen aller Partien; die Summe landet in
+    // sink, damit der Compiler die Schlüssel nicht wegoptimiert
+    [[maybe_unused]] static volatile uint64_t sink;
+    out << "Nachspielen mit Schlüssel, " << repeats << "x, 1 Kern\n";
+    out << setw(26) << "Schlüssel" << setw(12) << "Zeit(ms)" << setw(12) << "ns/Zug" << "\n";
+    auto measure = [&](const string& name, auto keyOf) {
+        uint64_t sum = 0;
+        auto t0 = Clock::now();
+        for (int rep = 0; rep < repeats; ++rep)
+            for (const auto& moves : archive) {
+                BitBoard b;
+                ZobristKey z;
+                for (const Move& m : moves) sum += keyOf(b, z, m.col);
+            }
+        sink = sum;
+        const double ms = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+        out << setw(28) << name << setw(12) << fixed << setprecision(1) << ms
+            << setw(12) << setprecision(2) << ms * 1e6 / (static_cast<double>(positions) * repeats) << "\n";
+        out.unsetf(ios::floatfield);
+    };
+    measure("nur Züge", [](BitBoard& b, ZobristKey&, int col) { return static_cast<uint64_t>(b.dropDisc(col)); });
+    measure("key()", [](BitBoard& b, ZobristKey&, int col) { b.dropDisc(col); return b.key(); });
+    measure("canonicalKey()", [](BitBoard& b, ZobristKey&, int col) { b.dropDisc(col); return b.canonicalKey(); });
+    measure("Zobrist inkrementell", [](BitBoard& b, ZobristKey& z, int col) {
+        const int player = b.currentPlayer();
+        z.drop(player, b.dropDisc(col), col);
+        return z.canonical();
+    });
+}
+
+void Bench::positionDb(int maxThreads, ostream& out) {
+#if HAS_FILESYSTEM
+    using Clock = chrono::steady_clock;
+    const int games = 20000, later = 1000;
+    const fs::path dir = fs::temp_directory_path() / "c4_bench_positions";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    Policy policies[2];
+    Policy::parse("greedy", policies[0]);
+    policies[1] = policies[0];
+    const string players[2] = {"Spieler 1", "Spieler 2"};
+    const char symbols[2] = {'X', 'O'};
+    vector<Move> moves;
+    auto writeLogs = [&](int from, int to) {
+        for (int g = from; g < to; ++g) {
+            const int result = SelfPlay::playGame(policies, 4, SelfPlay::gameSeed(3, g), moves);
+            GameLogger::save((dir / ("game_" + to_string(g) + ".log")).string(), moves, players, symbols, result);
+        }
+    };
+    writeLogs(0, games);
+    const string db = (dir / PositionDb::FILE_NAME).string();
+    auto elapsedMs = [](Clock::time_point t0) {
+        return chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count() / 1000.0;
+    };
+
+    out << games << " Logs (Greedy, 4 Zufallszüge)\n";
+    out << setw(28) << "Aufbau" << setw(10) << "Threads" << setw(12) << "Zeit(ms)" << setw(12) << "Logs/s" << "\n";
+    stringstream quiet;
+    for (int t = 1; t <= maxThreads; t *= 2) {
+        fs::remove(db);
+        auto t0 = Clock::now();
+        PositionDb::update(dir.string(), t, quiet);
+        const double ms = elapsedMs(t0);
+        out << setw(28) << "komplett" << setw(10) << t << setw(12) << fixed << setprecision(1) << ms
+            << setw(12) << setprecision(0) << games * 1000.0 / ms << "\n";
+        out.unsetf(ios::floatfield);
+    }
+    writeLogs(games, games + later);
+    auto t0 = Clock::now();
+    PositionDb::update(dir.string(), maxThreads, quiet);
+    double ms = elapsedMs(t0);
+    out << setw(28) << "+" + to_string(later) + " Logs (inkrementell)" << setw(10) << maxThreads << setw(12)
+        << fixed << setprecision(1) << ms << "\n";
+    t0 = Clock::now();
+    PositionDb::update(dir.string(), maxThreads, quiet);
+    out << setw(28) << "nichts Neues" << setw(10) << maxThreads << setw(12) << elapsedMs(t0) << "\n";
+    out.unsetf(ios::floatfield);
+
+    // Abfragen: jede Stellung der ersten 2000 Partien, einzeln gestoppt
+    PositionDb explorer;
+    string status;
+    t0 = Clock::now();
+    explorer.open(dir.string(), &status);
+    out << "open(): " << fixed << setprecision(2) << elapsedMs(t0) << " ms, " << status << ", "
+        << setprecision(1) << fs::file_size(db) / 1048576.0 << " MB\n";
+    out.unsetf(ios::floatfield);
+    vector<BitBoard> queries;
+    for (int g = 0; g < 2000; ++g) {
+        SelfPlay::playGame(policies, 4, SelfPlay::gameSeed(3, g), moves);
+        BitBoard b;
+        queries.push_back(b);
+        for (const Move& m : moves) {
+            b.dropDisc(m.col);
+            queries.push_back(b);
+        }
+    }
+    vector<double> micros;
+    micros.reserve(queries.size());
+    size_t found = 0;
+    PositionDb::Info info;
+    for (const BitBoard& b : queries) {
+        auto q0 = Clock::now();
+        found += explorer.lookup(b, info);
+        micros.push_back(chrono::duration<double, micro>(Clock::now() - q0).count());
+    }
+    sort(micros.begin(), micros.end());
+    out << queries.size() << " Abfragen (" << found << " gefunden): p50 " << fixed << setprecision(2)
+        << micros[micros.size() / 2] << " µs, p99 " << micros[micros.size() * 99 / 100] << " µs, max "
+        << micros.back() << " µs\n";
+    out.unsetf(ios::floatfield);
+    explorer.close();
+    fs::remove_all(dir);
+#else
+    (void)maxThreads;
+    out << "Braucht <filesystem>.\n";
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+
+// Messungen für Performance-Vergleiche (Aufruf über --bench NAME)
+class Bench {
+public:
+    // Lazy SMP: Knoten/s und Zeit bis zur Lösung für 1, 2, 4, ... Threads
+    static void smpScaling(int maxThreads, size_t ttMegabytes, std::ostream& out);
+
+    // MCTS: Playouts/s und Speicher bei ENGINE_BUDGET_MS pro Stellung
+    static void mcts(std::ostream& out);
+
+    // Zufallspartien: eine nach der anderen (BitBoard) gegen den Batch-Kernel
+    static void playouts(std::ostream& out);
+
+    // Logformate: Größe und Lesezeit V2 (Text) gegen V3 (binär, mmap)
+    static void logFormats(std::ostream& out);
+
+    // stats.csv mit 4 Mio. Zeilen: zeilenweiser stringstream-Parser gegen
+    // mmap/string_view mit 1, 2, 4 .. maxThreads Threads
+    static void statsCsv(int maxThreads, std::ostream& out);
+
+    // threads Erzeuger hängen Partien an eine stats.csv: jede Partie einzeln
+    // (Stats::appendGames) gegen einen gemeinsamen StatsWriter
+    static void statsWriter(int threads, std::ostream& out);
+
+    // Terminalausgabe: Byte und Zeit pro Frame für Spielzüge mit fallendem
+    // Stein und für Pfeiltasten im Menü, bisheriges Neuzeichnen gegen Screen-Diff
+    static void terminal(std::ostream& out);
+
+    // Spielserver (--serve) unter Last: Verbindungen mit vielen offenen
+    // Partien auf einem Unix-Socket; Züge/s und Antwortzeit (p50/p99)
+    static void server(std::ostream& out);
+
+    // Brett in der Spielschleife: 7x6 auf BitBoard gegen GameBoard<6, 7>,
+    // mit altem und neuem Anzeige-Brett, dazu die anderen Größen
+    static void boards(std::ostream& out);
+
+    // Stellungsschlüssel über ein Partienarchiv: verschiedene Stellungen mit
+    // und ohne Spiegelung, Kosten von key(), canonicalKey() und Zobrist
+    static void positionKeys(std::ostream& out);
+
+    // Stellungsdatenbank: Aufbau aus 20000 Logs mit 1, 2, 4 .. maxThreads
+    // Threads, inkrementelles Nachtragen, Antwortzeit einzelner Abfragen
+    static void positionDb(int maxThreads, std::ostream& out);
+};
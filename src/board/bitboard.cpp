@@ -0,0 +1,68 @@
+#include "bitboard.h"
+
+BitBoard::BitBoard() { reset(); }
+
+void BitBoard::reset() {
+    current = 0;
+    mask = 0;
+    threats[0] = threats[1] = 0;
+    moves = 0;
+    for (int c = 0; c < COLS; ++c) heights[c] = 0;
+}
+
+bool BitBoard::fromMoves(const std::string& moves, BitBoard& out) {
+    out.reset();
+    for (char ch : moves) {
+        int col = ch - '1';
+        if (col < 0 || col >= COLS || !out.isValidColumn(col)) return false;
+        int p = out.currentPlayer();
+        out.dropDisc(col);
+        if (out.checkWin(p)) return false;
+    }
+    return true;
+}
+
+BitBoard BitBoard::fromKey(uint64_t key) {
+    BitBoard b;
+    // key + BOTTOM_ROW: höchstes gesetztes Bit jeder Spalte markiert die Höhe
+    const uint64_t marked = key + BOTTOM_ROW;
+    for (int c = 0; c < COLS; ++c) {
+        uint64_t col = (marked >> (c * H1)) & ((uint64_t(1) << H1) - 1);
+        int h = 0;
+        while (h + 1 < H1 && (col >> (h + 1))) ++h;
+        b.heights[c] = h;
+        b.mask |= ((uint64_t(1) << h) - 1) << (c * H1);
+    }
+    b.current = key - b.mask;
+    b.moves = __builtin_popcountll(b.mask);
+
+    const int me = b.currentPlayer();
+    b.threats[me] = winningCells(b.current, b.mask);
+    b.threats[1 - me] = winningCells(b.current ^ b.mask, b.mask);
+    return b;
+}
+
+int BitBoard::cell(int row, int col) const {
+    if (row < 0 || row >= ROWS || col < 0 || col >= COLS) return -1;
+    uint64_t bit = cellBit(row, col);
+    if (!(mask & bit)) return -1;
+    return (current & bit) ? currentPlayer() : 1 - currentPlayer();
+}
+
+bool BitBoard::checkWinAt(int row, int col) const {
+    int owner = cell(row, col);
+    if (owner < 0) return false;
+
+    const uint64_t stones = playerMask(owner);
+    const uint64_t start = cellBit(row, col);
+
+    // Wächterbits sind nie belegt, daher kein Überlauf in Nachbarspalten
+    const int shifts[4] = {1, H1, H1 - 1, H1 + 1};
+    for (int s : shifts) {
+        int count = 1;
+        for (uint64_t b = start << s; (b & stones) && count < 4; b <<= s) ++count;
+        for (uint64_t b = start >> s; (b & stones) && count < 4; b >>= s) ++count;
+        if (count >= 4) return true;
+    }
+    return false;
+}
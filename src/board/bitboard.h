@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "constants.h"
+
+// Spielfeld als Bitboard: zwei 64-Bit-Masken (Steine des Spielers am Zug +
+// belegte Felder) plus Spaltenhöhen. Regeln identisch zu Board, aber jede
+// Operation besteht nur aus wenigen Bit-Operationen.
+//
+// Layout: spaltenweise, pro Spalte ROWS+1 Bits (oberstes Bit bleibt als
+// Wächter leer), Bit 0 einer Spalte = unterste Reihe.
+// Reihen-Indizes nach außen wie bei Board: 0 = oben, ROWS-1 = unten.
+class BitBoard {
+public:
+    static constexpr int H1 = ROWS + 1;
+    static_assert(H1 * COLS <= 64, "Spielfeld passt nicht in 64 Bit");
+
+    BitBoard();
+
+    void reset();
+
+    bool isValidColumn(int col) const {
+        return col >= 0 && col < COLS && heights[col] < ROWS;
+    }
+
+    int getDropRow(int col) const {
+        return isValidColumn(col) ? ROWS - 1 - heights[col] : -1;
+    }
+
+    // Setzt einen Stein für den Spieler am Zug (Spieler 0 beginnt).
+    // Rückgabe: Zielreihe (0 = oben) oder -1 bei ungültiger Spalte.
+    int dropDisc(int col) {
+        if (!isValidColumn(col)) return -1;
+        int player = currentPlayer();
+        current ^= mask;
+        mask |= mask + bottomMask(col);
+        ++moves;
+
+        // Drohungen fortschreiben: nur der Setzende kann neue bekommen,
+        // beim Gegner fällt höchstens das gerade belegte Feld weg.
+        threats[player] = winningCells(current ^ mask, mask);
+        threats[1 - player] &= ~mask;
+        return ROWS - 1 - heights[col]++;
+    }
+
+    bool isFull() const { return moves == ROWS * COLS; }
+
+    bool checkWin(int player) const { return hasAlignment(playerMask(player)); }
+
+    // Prüft nur die vier Linien durch (row, col) – gedacht für das Feld,
+    // das dropDisc gerade zurückgegeben hat. O(1) statt ganzes Brett.
+    bool checkWinAt(int row, int col) const;
+
+    // Drohungen = leere Felder, die für den Spieler eine Vierer-Reihe
+    // vervollständigen würden (offene Dreier). Wird in dropDisc mitgeführt.
+    int threatCount(int player) const { return __builtin_popcountll(threats[player]); }
+    uint64_t threatCells(int player) const { return threats[player]; }
+
+    int currentPlayer() const { return moves & 1; }
+    int moveCount() const { return moves; }
+
+    // -1 = leer, sonst Spielerindex 0/1
+    int cell(int row, int col) const;
+
+    uint64_t playerMask(int player) const {
+        return (player == currentPlayer()) ? current : (current ^ mask);
+    }
+    uint64_t currentMask() const { return current; }
+    uint64_t occupiedMask() const { return mask; }
+
+    // Eindeutiger Schlüssel der Stellung (belegt H1*COLS Bits): die
+    // Wächterbits über jeder Spalte kodieren die Höhen, current die Farben
+    uint64_t key() const { return current + mask; }
+
+    // Schlüssel unter Spiegelung (links/rechts) zusammengefasst: die
+    // kleinere der beiden Varianten. isMirrored = Stellung ist die gespiegelte.
+    uint64_t canonicalKey(bool* isMirrored = nullptr) const {
+        uint64_t k = key();
+        uint64_t m = mirrorColumns(k);
+        if (isMirrored) *isMirrored = m < k;
+        return m < k ? m : k;
+    }
+
+    // Spalten in umgekehrter Reihenfolge (funktioniert für Masken und Schlüssel,
+    // da current + mask nie über eine Spalte hinaus überträgt)
+    static uint64_t mirrorColumns(uint64_t bits) {
+        const uint64_t col0 = (uint64_t(1) << H1) - 1;
+        uint64_t r = 0;
+        for (int c = 0; c < COLS; ++c)
+            r |= ((bits >> (c * H1)) & col0) << ((COLS - 1 - c) * H1);
+        return r;
+    }
+
+    // Stellung aus Zugfolge "4453" (Spalten 1..COLS). false bei ungültigem
+    // Zeichen, voller Spalte oder wenn das Spiel vorher schon entschieden ist
+    static bool fromMoves(const std::string& moves, BitBoard& out);
+
+    // Stellung aus key() zurückgewinnen (z.B. für Einträge im Eröffnungsbuch)
+    static BitBoard fromKey(uint64_t key);
+
+    // Felder, in die der Spieler am Zug jetzt setzen kann (je Spalte ein Bit)
+    uint64_t possibleMask() const { return (mask + BOTTOM_ROW) & BOARD_MASK; }
+
+    // Spieler am Zug gewinnt mit dem nächsten Stein
+    bool canWinNext() const { return (threats[currentPlayer()] & possibleMask()) != 0; }
+
+    // Züge, nach denen der Gegner nicht sofort gewinnen kann.
+    // 0 = jeder Zug verliert (z.B. doppelte Drohung des Gegners).
+    uint64_t nonLosingMoves() const {
+        uint64_t possible = possibleMask();
+        const uint64_t opp = threats[1 - currentPlayer()];
+        const uint64_t forced = possible & opp;
+        if (forced) {
+            if (forced & (forced - 1)) return 0; // zwei Drohungen gleichzeitig
+            possible = forced;
+        }
+        return possible & ~(opp >> 1); // nicht unter eine gegnerische Drohung setzen
+    }
+
+    // true, wenn in pos vier Bits in einer Linie liegen
+    static bool hasAlignment(uint64_t pos) {
+        // horizontal
+        uint64_t m = pos & (pos >> H1);
+        if (m & (m >> (2 * H1))) return true;
+        // diagonal steigend
+        m = pos & (pos >> (H1 + 1));
+        if (m & (m >> (2 * (H1 + 1)))) return true;
+        // diagonal fallend
+        m = pos & (pos >> (H1 - 1));
+        if (m & (m >> (2 * (H1 - 1)))) return true;
+        // vertikal
+        m = pos & (pos >> 1);
+        return (m & (m >> 2)) != 0;
+    }
+
+    // Leere Felder (bezogen auf mask), die pos zu einer Vierer-Reihe ergänzen
+    static uint64_t winningCells(uint64_t pos, uint64_t mask) {
+        // vertikal: nur nach oben möglich
+        uint64_t r = (pos << 1) & (pos << 2) & (pos << 3);
+
+        // horizontal + beide Diagonalen
+        r |= winningLine(pos, H1);
+        r |= winningLine(pos, H1 - 1);
+        r |= winningLine(pos, H1 + 1);
+        return r & (BOARD_MASK ^ mask);
+    }
+
+    static constexpr uint64_t bottomMask(int col) { return uint64_t(1) << (col * H1); }
+    static constexpr uint64_t topMask(int col) { return uint64_t(1) << (ROWS - 1 + col * H1); }
+    static constexpr uint64_t cellBit(int row, int col) {
+        return uint64_t(1) << (ROWS - 1 - row + col * H1);
+    }
+    static constexpr uint64_t columnMask(int col) {
+        return ((uint64_t(1) << ROWS) - 1) << (col * H1);
+    }
+
+    // unterste Reihe aller Spalten
+    static constexpr uint64_t BOTTOM_ROW = [] {
+        uint64_t m = 0;
+        for (int c = 0; c < COLS; ++c) m |= uint64_t(1) << (c * H1);
+        return m;
+    }();
+
+    // alle spielbaren Felder (ohne Wächterbits)
+    static constexpr uint64_t BOARD_MASK = [] {
+        uint64_t m = 0;
+        for (int c = 0; c < COLS; ++c) m |= ((uint64_t(1) << ROWS) - 1) << (c * H1);
+        return m;
+    }();
+
+private:
+    // Lücken-Felder einer Linienrichtung (Shift s), die pos zu vier ergänzen
+    static uint64_t winningLine(uint64_t pos, int s) {
+        uint64_t p = (pos << s) & (pos << (2 * s));
+        uint64_t r = p & (pos << (3 * s));
+        r |= p & (pos >> s);
+        p = (pos >> s) & (pos >> (2 * s));
+        r |= p & (pos << s);
+        r |= p & (pos >> (3 * s));
+        return r;
+    }
+
+    uint64_t current = 0; // Steine des Spielers am Zug
+    uint64_t mask = 0;    // alle belegten Felder
+    uint64_t threats[2] = {0, 0};
+    int heights[COLS];
+    int moves = 0;
+};
@@ -1,25 +1,190 @@
 #pragma once
 
-#include "constants.h"
+#include <array>
+#include <cstdint>
+#include <string>
 
-// Spielfeld / Regeln rund um das Setzen und Gewinnen
-class Board {
-private:
-    char grid[ROWS][COLS];
+#include "constants.h"
+#include "util/screen.h"
 
+// Spielfeld / Regeln rund um das Setzen und Gewinnen, Größe zur
+// Compilezeit: jede Instanz bekommt ihre Gewinnlinien als constexpr-
+// Tabellen, Schleifen über Reihen/Spalten haben feste Grenzen.
+// Reihe 0 = oben, Rows-1 = unten.
+template <int Rows, int Cols>
+class GameBoard {
 public:
-    Board();
+    // Spalten 1-8: so viele kann ein Zug im Log (V3) kodieren
+    static_assert(Rows >= 4 && Cols >= 4 && Cols <= 8 && Rows * Cols <= 255, "Brettgröße nicht unterstützt");
+
+    static constexpr int HEIGHT = Rows;
+    static constexpr int WIDTH = Cols;
+    static constexpr int CELLS = Rows * Cols;
+
+    // alle Vierer-Linien, als Feldindizes (Reihe * Cols + Spalte)
+    static constexpr int LINE_COUNT = Rows * (Cols - 3) + (Rows - 3) * Cols + 2 * (Rows - 3) * (Cols - 3);
+    using Line = std::array<uint8_t, 4>;
+
+    static constexpr std::array<Line, LINE_COUNT> LINES = [] {
+        std::array<Line, LINE_COUNT> lines{};
+        int n = 0;
+        const int dirs[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        for (const auto& d : dirs)
+            for (int r = 0; r < Rows; ++r)
+                for (int c = 0; c < Cols; ++c) {
+                    const int lastRow = r + 3 * d[0], lastCol = c + 3 * d[1];
+                    if (lastRow >= Rows || lastCol < 0 || lastCol >= Cols) continue;
+                    for (int k = 0; k < 4; ++k)
+                        lines[n][k] = static_cast<uint8_t>((r + k * d[0]) * Cols + c + k * d[1]);
+                    ++n;
+                }
+        return lines;
+    }();
+
+    // Linien durch jedes Feld: höchstens vier pro Richtung
+    struct CellLines {
+        uint8_t count = 0;
+        std::array<uint16_t, 16> lines{};
+    };
+
+    static constexpr std::array<CellLines, CELLS> CELL_LINES = [] {
+        std::array<CellLines, CELLS> through{};
+        for (int i = 0; i < LINE_COUNT; ++i)
+            for (uint8_t cell : LINES[i]) {
+                CellLines& c = through[cell];
+                c.lines[c.count++] = static_cast<uint16_t>(i);
+            }
+        return through;
+    }();
+
+    GameBoard() { reset(); }
+
+    void reset() {
+        for (char& c : cells) c = ' ';
+        for (uint8_t& h : heights) h = 0;
+        moves = 0;
+    }
+
+    bool isValidColumn(int col) const {
+        return col >= 0 && col < Cols && heights[col] < Rows;
+    }
 
-    void reset();
-    bool isValidColumn(int col) const;
-    int dropDisc(int col, char symbol);
-    bool isFull() const;
-    bool checkWin(char s) const;
+    // Rückgabe: Zielreihe oder -1 bei ungültiger/voller Spalte
+    int dropDisc(int col, char symbol) {
+        if (!isValidColumn(col)) return -1;
+        const int row = Rows - 1 - heights[col]++;
+        cells[row * Cols + col] = symbol;
+        ++moves;
+        return row;
+    }
 
-    int getDropRow(int col) const;
+    bool isFull() const { return moves == CELLS; }
+    int moveCount() const { return moves; }
 
-    // "Bildschirmmaske": hübsches Brett (Box Drawing)
-    void printPretty(char p1Symbol, char p2Symbol,
-                     int ghostRow = -1, int ghostCol = -1, char ghostSymbol = '\0') const;
+    bool checkWin(char s) const {
+        for (const Line& l : LINES)
+            if (cells[l[0]] == s && cells[l[1]] == s && cells[l[2]] == s && cells[l[3]] == s) return true;
+        return false;
+    }
 
+    // nur die Linien durch (row, col)
+    bool checkWinAt(int row, int col) const {
+        if (row < 0 || row >= Rows || col < 0 || col >= Cols) return false;
+        const int at = row * Cols + col;
+        const char s = cells[at];
+        if (s == ' ') return false;
+        const CellLines& through = CELL_LINES[at];
+        for (int i = 0; i < through.count; ++i) {
+            const Line& l = LINES[through.lines[i]];
+            if (cells[l[0]] == s && cells[l[1]] == s && cells[l[2]] == s && cells[l[3]] == s) return true;
+        }
+        return false;
+    }
+
+    int getDropRow(int col) const {
+        return isValidColumn(col) ? Rows - 1 - heights[col] : -1;
+    }
+
+    // Zellinhalt (' ' = leer), z.B. für den Abgleich mit BitBoard
+    char cellAt(int row, int col) const { return cells[row * Cols + col]; }
+
+    // "Bildschirmmaske": hübsches Brett (Box Drawing) ab Zeile top.
+    // Rückgabe: erste freie Zeile darunter
+    int draw(Screen& screen, int top, char p1Symbol, char p2Symbol,
+             int ghostRow = -1, int ghostCol = -1, char ghostSymbol = '\0') const {
+        auto renderCell = [&](int r, int c) -> const char* {
+            char cell = (r == ghostRow && c == ghostCol && ghostSymbol != '\0') ? ghostSymbol : cellAt(r, c);
+            if (cell == p1Symbol) return "●";
+            if (cell == p2Symbol) return "○";
+            return " ";
+        };
+
+        const Frame& f = frame();
+        int row = top + 1;
+        screen.text(row++, 0, f.labels);
+        screen.text(row++, 0, f.top);
+        for (int r = 0; r < Rows; ++r) {
+            screen.text(row, 0, "  ║");
+            for (int c = 0; c < Cols; ++c) {
+                screen.text(row, 4 + 4 * c, renderCell(r, c));
+                screen.text(row, 6 + 4 * c, "║");
+            }
+            ++row;
+            if (r != Rows - 1)
+                screen.text(row++, 0, f.middle);
+        }
+        screen.text(row++, 0, f.bottom);
+        return row + 1;
+    }
+
+private:
+    // Spaltennummern und Rahmenlinien, einmal pro Größe gebaut
+    struct Frame {
+        std::string labels, top, middle, bottom;
+    };
+
+    static const Frame& frame() {
+        static const Frame f = [] {
+            Frame out;
+            auto border = [](const char* left, const char* join, const char* right) {
+                std::string line = std::string("  ") + left;
+                for (int c = 0; c < Cols; ++c) {
+                    line += "═══";
+                    line += c + 1 < Cols ? join : right;
+                }
+                return line;
+            };
+            out.labels = "  ";
+            for (int c = 0; c < Cols; ++c) out.labels += "  " + std::to_string(c + 1) + " ";
+            out.labels.pop_back();
+            out.top = border("╔", "╦", "╗");
+            out.middle = border("╠", "╬", "╣");
+            out.bottom = border("╚", "╩", "╝");
+            return out;
+        }();
+        return f;
+    }
+
+    char cells[CELLS];
+    uint8_t heights[Cols];
+    int moves = 0;
 };
+
+// Standardbrett: Spiel gegen den Computer, Eröffnungsbuch, Statistik
+using Board = GameBoard<ROWS, COLS>;
+
+// Brettgrößen (Spalten x Reihen), für die Spiel, Replay und Log-Prüfung
+// instanziiert sind
+inline constexpr const char* BOARD_SIZES = "7x6, 8x7, 5x4";
+
+// Ruft f mit einem leeren Brett der Größe rows x cols auf, so dass der
+// Aufrufer genau einmal pro Größe instanziiert wird.
+// false = keine Instanz für diese Größe
+template <typename F>
+bool withBoardSize(int rows, int cols, F&& f) {
+    if (rows == ROWS && cols == COLS) f(Board());
+    else if (rows == 7 && cols == 8) f(GameBoard<7, 8>());
+    else if (rows == 4 && cols == 5) f(GameBoard<4, 5>());
+    else return false;
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "board/bitboard.h"
+#include "constants.h"
+#include "util/rng.h"
+
+// Zobrist-Schlüssel als Alternative zu BitBoard::key(): XOR einer festen
+// Zufallszahl pro (Spieler, Feld). Nicht eindeutig wie key(), aber
+// gleichmäßig über alle 64 Bit verteilt und unabhängig vom Bitlayout.
+// Das Spiegelbild wird bei jedem Zug mitgeführt, canonical() kostet also
+// nur einen Vergleich. Wer am Zug ist, folgt aus der Steinzahl.
+class ZobristKey {
+public:
+    // Stein von player (0/1) auf (row, col), Reihe 0 = oben wie bei BitBoard
+    void drop(int player, int row, int col) {
+        hash ^= TABLE[player][row * COLS + col];
+        mirror ^= TABLE[player][row * COLS + COLS - 1 - col];
+    }
+
+    uint64_t value() const { return hash; }
+    uint64_t mirroredValue() const { return mirror; }
+
+    // Wie BitBoard::canonicalKey: der kleinere der beiden Werte
+    uint64_t canonical(bool* isMirrored = nullptr) const {
+        if (isMirrored) *isMirrored = mirror < hash;
+        return mirror < hash ? mirror : hash;
+    }
+
+    // Schlüssel einer fertigen Stellung (jeder Stein einzeln)
+    static ZobristKey of(const BitBoard& board) {
+        ZobristKey z;
+        for (int r = 0; r < ROWS; ++r)
+            for (int c = 0; c < COLS; ++c) {
+                const int owner = board.cell(r, c);
+                if (owner >= 0) z.drop(owner, r, c);
+            }
+        return z;
+    }
+
+private:
+    // fest (nicht pro Lauf), damit Schlüssel in Dateien gültig bleiben
+    static constexpr std::array<std::array<uint64_t, ROWS * COLS>, 2> TABLE = [] {
+        std::array<std::array<uint64_t, ROWS * COLS>, 2> t{};
+        uint64_t x = 0x5A0B2157C0FFEEULL;
+        for (auto& player : t)
+            for (uint64_t& v : player) v = x = splitmix64(x);
+        return t;
+    }();
+
+    uint64_t hash = 0;
+    uint64_t mirror = 0;
+};
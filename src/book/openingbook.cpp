@@ -0,0 +1,212 @@
+#include "openingbook.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#include "constants.h"
+#include "solver/solver.h"
+#include "solver/transpositiontable.h"
+
+using namespace std;
+
+namespace {
+    const char BOOK_MAGIC[8] = {'C', '4', 'B', 'O', 'O', 'K', '0', '1'};
+
+    void collect(const BitBoard& b, int maxPly, unordered_set<uint64_t>& seen) {
+        // gespiegelte Stellung schon besucht => gleicher (gespiegelter) Teilbaum
+        if (!seen.insert(b.canonicalKey()).second) return;
+        if (b.moveCount() >= maxPly) return;
+
+        for (int c = 0; c < COLS; ++c) {
+            if (!b.isValidColumn(c)) continue;
+            BitBoard child = b;
+            int p = child.currentPlayer();
+            child.dropDisc(c);
+            if (child.checkWin(p) || child.isFull()) continue; // Spiel vorbei
+            collect(child, maxPly, seen);
+        }
+    }
+
+    // Prüft, ob move in b den Score wirklich hält
+    bool moveHoldsScore(Solver& solver, const BitBoard& b, int move, int score) {
+        if (!b.isValidColumn(move)) return false;
+        BitBoard child = b;
+        int p = child.currentPlayer();
+        child.dropDisc(move);
+        if (child.checkWin(p)) return score == (ROWS * COLS + 1 - b.moveCount()) / 2;
+        return -solver.solve(child).score == score;
+    }
+}
+
+bool OpeningBook::open(const string& filename, string* error) {
+    close();
+    auto fail = [&](const string& msg) {
+        if (error) *error = msg;
+        close();
+        return false;
+    };
+
+    if (!file.open(filename)) return fail("Datei nicht lesbar");
+    if (file.size() < sizeof(BookHeader)) return fail("Datei zu klein");
+
+    BookHeader h;
+    memcpy(&h, file.data(), sizeof(h));
+    if (memcmp(h.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0) return fail("kein Eröffnungsbuch");
+    if (h.rows != (uint32_t)ROWS || h.cols != (uint32_t)COLS)
+        return fail("veraltet: erzeugt für " + to_string(h.cols) + "x" + to_string(h.rows));
+    if (h.entrySize != sizeof(BookEntry)) return fail("falsche Eintragsgröße");
+    // nicht count * sizeof ausrechnen: ein kaputtes count liefe über
+    const size_t body = file.size() - sizeof(BookHeader);
+    if (body % sizeof(BookEntry) != 0 || body / sizeof(BookEntry) != h.count)
+        return fail("Dateigröße passt nicht zum Header");
+
+    entries = reinterpret_cast<const BookEntry*>(file.data() + sizeof(BookHeader));
+    count = static_cast<size_t>(h.count);
+    ply = static_cast<int>(h.maxPly);
+    return true;
+}
+
+void OpeningBook::close() {
+    file.close();
+    entries = nullptr;
+    count = 0;
+    ply = 0;
+}
+
+bool OpeningBook::lookup(const BitBoard& board, int& score, int& bestMove) const {
+    if (count == 0 || board.moveCount() > ply) return false;
+
+    bool mirrored = false;
+    const uint64_t key = board.canonicalKey(&mirrored);
+    const BookEntry* end = entries + count;
+    const BookEntry* it = lower_bound(entries, end, key,
+        [](const BookEntry& e, uint64_t k) { return e.key < k; });
+    if (it == end || it->key != key) return false;
+
+    score = it->score;
+    bestMove = mirrored ? COLS - 1 - it->bestMove : it->bestMove;
+    return true;
+}
+
+vector<uint64_t> OpeningBook::collectPositions(int maxPly) {
+    unordered_set<uint64_t> seen;
+    collect(BitBoard(), maxPly, seen);
+    return vector<uint64_t>(seen.begin(), seen.end());
+}
+
+bool OpeningBook::write(const string& filename, vector<BookEntry> list, int maxPly) {
+    sort(list.begin(), list.end(),
+         [](const BookEntry& a, const BookEntry& b) { return a.key < b.key; });
+
+    BookHeader h{};
+    memcpy(h.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    h.rows = ROWS;
+    h.cols = COLS;
+    h.maxPly = static_cast<uint32_t>(maxPly);
+    h.entrySize = sizeof(BookEntry);
+    h.count = list.size();
+
+    // erst in Temp-Datei, dann umbenennen: ein laufendes Spiel sieht nie
+    // ein halb geschriebenes Buch
+    const string tmp = filename + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(list.data()),
+                  static_cast<streamsize>(list.size() * sizeof(BookEntry)));
+        if (!out) return false;
+    }
+    return rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+bool OpeningBook::generate(const string& filename, int maxPly, size_t ttMegabytes,
+                           int threads, ostream& log) {
+    auto t0 = chrono::steady_clock::now();
+    vector<uint64_t> keys = collectPositions(maxPly);
+    log << keys.size() << " Stellungen bis Halbzug " << maxPly << " (ohne Spiegelungen)" << endl;
+
+    // Tiefe Stellungen zuerst: deren Ergebnisse stehen dann in der
+    // Transpositionstabelle, wenn die flacheren gelöst werden
+    vector<pair<int, uint64_t>> order;
+    order.reserve(keys.size());
+    for (uint64_t k : keys) order.push_back({BitBoard::fromKey(k).moveCount(), k});
+    sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    if (threads <= 0) threads = static_cast<int>(thread::hardware_concurrency());
+    if (threads <= 0) threads = 1;
+
+    // Jeder Thread holt sich die nächste Stellung (geteilte Tabelle)
+    TranspositionTable tt(ttMegabytes);
+    vector<BookEntry> list(order.size());
+    atomic<size_t> next{0};
+    atomic<size_t> done{0};
+    mutex logMutex;
+
+    auto work = [&]() {
+        Solver solver(&tt);
+        for (size_t i = next++; i < order.size(); i = next++) {
+            SearchResult res = solver.solve(BitBoard::fromKey(order[i].second));
+            list[i].key = order[i].second;
+            list[i].score = static_cast<int8_t>(res.score);
+            list[i].bestMove = static_cast<uint8_t>(res.bestMove);
+
+            size_t n = ++done;
+            if (n % 100 == 0 || n == order.size()) {
+                lock_guard<mutex> lock(logMutex);
+                long long s = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - t0).count();
+                log << "\r" << n << "/" << order.size() << " gelöst (Halbzug "
+                    << order[i].first << ", " << s << " s)" << flush;
+            }
+        }
+    };
+    vector<thread> helpers;
+    for (int t = 1; t < threads; ++t) helpers.emplace_back(work);
+    work();
+    for (auto& t : helpers) t.join();
+    log << "\n";
+
+    if (!write(filename, move(list), maxPly)) {
+        log << "Fehler: " << filename << " konnte nicht geschrieben werden.\n";
+        return false;
+    }
+    log << "Eröffnungsbuch geschrieben: " << filename << "\n";
+    return true;
+}
+
+int OpeningBook::verify(const string& filename, int samples, unsigned seed,
+                        size_t ttMegabytes, ostream& log) {
+    OpeningBook book;
+    string error;
+    if (!book.open(filename, &error)) {
+        log << "Eröffnungsbuch nicht ladbar: " << error << "\n";
+        return -1;
+    }
+
+    TranspositionTable tt(ttMegabytes);
+    Solver solver(&tt);
+    mt19937_64 rng(seed);
+    int mismatches = 0;
+    int n = static_cast<int>(min<size_t>(samples, book.count));
+
+    for (int i = 0; i < n; ++i) {
+        const BookEntry& e = book.entries[rng() % book.count];
+        BitBoard b = BitBoard::fromKey(e.key);
+        int score = solver.solve(b).score;
+        if (score != e.score || !moveHoldsScore(solver, b, e.bestMove, e.score)) {
+            ++mismatches;
+            log << "Abweichung: key " << e.key << " Buch " << (int)e.score << "/" << (int)e.bestMove
+                << ", neu gelöst " << score << "\n";
+        }
+    }
+    log << n << " Einträge geprüft, " << mismatches << " Abweichungen.\n";
+    return mismatches;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "board/bitboard.h"
+#include "util/mappedfile.h"
+
+// Dateiformat (native Byte-Reihenfolge, wird per mmap gelesen):
+//   BookHeader
+//   BookEntry[count], aufsteigend nach key sortiert
+// key ist BitBoard::canonicalKey(), gespiegelte Stellungen stehen also nur
+// einmal drin; bestMove bezieht sich auf die kanonische Orientierung.
+struct BookHeader {
+    char magic[8];      // "C4BOOK01"
+    uint32_t rows;      // ROWS beim Erzeugen
+    uint32_t cols;      // COLS beim Erzeugen
+    uint32_t maxPly;    // enthält alle Stellungen mit <= maxPly Steinen
+    uint32_t entrySize; // sizeof(BookEntry)
+    uint64_t count;
+};
+
+struct BookEntry {
+    uint64_t key;
+    int8_t score;       // exakter Solver-Score aus Sicht des Spielers am Zug
+    uint8_t bestMove;
+    uint8_t reserved[6];
+};
+
+// Eröffnungsbuch: offline vorberechnete exakte Bewertungen früher Stellungen
+class OpeningBook {
+public:
+    bool open(const std::string& filename, std::string* error = nullptr);
+    void close();
+
+    bool isOpen() const { return count > 0; }
+    size_t size() const { return count; }
+    int maxPly() const { return ply; }
+
+    // Binäre Suche; bestMove wird in die Orientierung von board übersetzt
+    bool lookup(const BitBoard& board, int& score, int& bestMove) const;
+
+    // --- Offline-Werkzeuge ---------------------------------------------
+
+    // Alle offenen Stellungen bis maxPly (kanonisch, ohne Duplikate)
+    static std::vector<uint64_t> collectPositions(int maxPly);
+
+    // Sortiert die Einträge und schreibt Header + Daten
+    static bool write(const std::string& filename, std::vector<BookEntry> entries, int maxPly);
+
+    // Löst alle Stellungen bis maxPly exakt und schreibt das Buch.
+    // threads <= 0: alle Kerne (teilen sich eine Transpositionstabelle)
+    static bool generate(const std::string& filename, int maxPly, size_t ttMegabytes,
+                         int threads, std::ostream& log);
+
+    // Löst eine Zufallsstichprobe neu. Rückgabe: Anzahl Abweichungen,
+    // -1 wenn das Buch nicht geladen werden konnte
+    static int verify(const std::string& filename, int samples, unsigned seed,
+                      size_t ttMegabytes, std::ostream& log);
+
+private:
+    MappedFile file;
+    const BookEntry* entries = nullptr;
+    size_t count = 0;
+    int ply = 0;
+};
@@ -1,8 +1,25 @@
 #pragma once
 
+#include <cstddef>
+
 // Spielfeldgröße für "4 Gewinnt"
 inline constexpr int ROWS = 6;
 inline constexpr int COLS = 7;
 
 inline constexpr long long TURN_LIMIT_MS = 15000; // 15 Sekunden pro Zug
 
+// Fallender Stein: Dauer pro Zeile (änderbar mit --anim-ms, 0 = sofort)
+inline constexpr int ANIMATION_FRAME_MS = 60;
+
+// Bedenkzeit des Computers: nur ein Bruchteil des Zeitlimits
+inline constexpr long long ENGINE_BUDGET_MS = TURN_LIMIT_MS / 15;
+
+// Standardgröße der Transpositionstabelle (änderbar mit --tt-mb)
+inline constexpr size_t TT_DEFAULT_MB = 64;
+
+// Eröffnungsbuch (optional, erzeugt mit --book-gen)
+inline constexpr const char* OPENING_BOOK_PATH = "data/opening.book";
+
+
+// Knoten-Arena der Monte-Carlo-Suche (beide Hälften zusammen)
+inline constexpr size_t MCTS_DEFAULT_MB = 64;
@@ -1,18 +1,32 @@
 #include "gameengine.h"
 
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <ctime>
+#include <deque>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
-#include <vector>
 #include <thread>
-#include <chrono>
+#include <type_traits>
+#include <vector>
 
 #include "board/board.h"
+#include "board/bitboard.h"
 #include "gamelogger/gamelogger.h"
+#include "gamelogger/logcatalog.h"
+#include "gamelogger/positiondb.h"
 #include "move.h"
+#include "util/eventloop.h"
+#include "util/rawmode.h"
+#include "util/screen.h"
 #include "util/util.h"
 #include "stats/stats.h"
+#include "solver/parallelsearch.h"
+#include "solver/solver.h"
 
 #if __has_include(<filesystem>)
   #include <filesystem>
@@ -39,53 +53,227 @@ namespace {
     #endif
     }
 
-    // Rückgabe:
-    // -1 => Abbruch
-    //  0..6 => gültige Spalte
-    int readColumnOrAbort(const string &playerName) {
-        while (true) {
-            cout << "Du hast " << (TURN_LIMIT_MS/1000) << " Sekunden.\n";
-            cout << playerName << " wählt Spalte (1-7) | 0/q = Abbruch: ";
-            string input;
-            cin >> input;
-
-            if (input == "0" || input == "q" || input == "Q") return -1;
-
-            if (!isNumber(input)) {
-                cout << "Ungültig. Bitte 1-7 oder 0/q.\n";
-                continue;
-            }
+    // Eingabe bei der Spaltenwahl.
+    // Rückgabe: 0..cols-1 = Spalte, -1 = Abbruch (0/q), -2 = ungültig
+    int parseColumn(const string &input, int cols) {
+        if (input == "0" || input == "q" || input == "Q") return -1;
+        int col = isNumber(input) && input.size() < 3 ? stoi(input) : 0;
+        return (col >= 1 && col <= cols) ? col - 1 : -2;
+    }
 
-            int col = stoi(input);
-            if (col < 1 || col > 7) {
-                cout << "Bitte nur 1 bis 7 (oder 0/q).\n";
-                continue;
-            }
-            return col - 1;
-        }
+    // Kurzbeschreibung der Computer-Bewertung für die Statuszeile
+    string describeScore(const SearchResult& res, const BitBoard& before) {
+        if (!res.exact) return "offen (Tiefe " + to_string(res.depth) + ")";
+        if (res.score == 0) return "Remis";
+        int n = Solver::movesToEnd(res.score, before);
+        return (res.score > 0 ? "Sieg in " : "Niederlage in ") + to_string(n) + " Zügen";
     }
 
-    void showGameOverScreen(const Board& board,
+    template <typename B>
+    void showGameOverScreen(const B& board,
                             char p1Symbol, char p2Symbol,
                             const std::string& headline,
                             const std::string& detail) {
-        clearScreen();
-        board.printPretty(p1Symbol, p2Symbol);
+        Screen& screen = Screen::terminal();
+        screen.clear();
+        int row = board.draw(screen, 0, p1Symbol, p2Symbol);
+        screen.text(row++, 0, "========================================");
+        screen.text(row++, 0, "               SPIEL ENDE");
+        screen.text(row++, 0, "========================================");
+        screen.text(row++, 0, headline);
+        if (!detail.empty()) screen.text(row++, 0, detail);
+        screen.text(row++, 0, "========================================");
+        screen.text(row++, 0, "");
+        screen.present();
+
+        // Eingaben liest die Ereignisschleife zeilenweise: nichts mehr zu verwerfen
+        cout << "Weiter mit Enter...";
+        string dummy;
+        getline(cin, dummy);
+    }
+
+    // Explorer-Panel ab row: wie oft die Stellung in den Partien des
+    // Log-Ordners vorkam, Ausgang und folgende Züge. Rückgabe: nächste Zeile
+    int drawExplorer(Screen& screen, int row, const PositionDb& db, const BitBoard& board) {
+        PositionDb::Info info;
+        if (!db.lookup(board, info)) {
+            screen.text(row++, 0, "Explorer: Stellung kommt in keiner Partie vor");
+            return row;
+        }
+        const char* toMove = board.currentPlayer() == 0 ? "●" : "○";
+        screen.text(row++, 0, "Explorer: " + to_string(info.visits) + " von " + to_string(db.games())
+                                  + " Partien, " + toMove + " am Zug");
+        const uint32_t decided = info.wins + info.draws + info.losses;
+        if (decided > 0) {
+            auto percent = [&](uint32_t n) { return to_string((n * 100 + decided / 2) / decided) + "%"; };
+            screen.text(row++, 0, string("  für ") + toMove + ": " + percent(info.wins) + " Sieg | "
+                                      + percent(info.draws) + " Remis | " + percent(info.losses) + " Niederlage");
+        }
+        int order[COLS];
+        for (int c = 0; c < COLS; ++c) order[c] = c;
+        stable_sort(order, order + COLS, [&](int a, int b) { return info.next[a] > info.next[b]; });
+        string line = "  danach:";
+        for (int c : order)
+            if (info.next[c] > 0) line += "  " + to_string(c + 1) + " (" + to_string(info.next[c]) + "x)";
+        if (info.next[order[0]] > 0) screen.text(row++, 0, line);
+        return row;
+    }
+
+    // Replay auf einem Brett der Größe des Logs (start = leeres Brett).
+    // explorer: Stellungsdatenbank für das Panel unter dem Brett (nur 7x6)
+    template <typename B>
+    void replay(const B& start, const string& filename, const GameLog& game,
+                const string& problem, size_t valid, int animationMs, const PositionDb* explorer) {
+        const vector<Move>& moves = game.moves;
+        const char* symbols = game.symbols;
+
+        // Stellung nach jedem gültigen Zug vorab: Springen kostet nur noch die Anzeige
+        vector<B> positions(1, start);
+        positions.reserve(valid + 1);
+        for (size_t i = 0; i < valid; ++i) {
+            positions.push_back(positions.back());
+            positions.back().dropDisc(moves[i].col, symbols[moves[i].playerIndex]);
+        }
+
+        clearInputLine();   // falls vorher cin >> benutzt wurde
+
+        Screen& screen = Screen::terminal();
+        screen.invalidate();
+        auto show = [&](size_t pos, int ghostRow) {
+            screen.clear();
+            screen.text(0, 0, "=== Replay: " + filename + " ===");
+            string status;
+            if (pos == 0) {
+                status = "Startstellung (" + to_string(valid) + " Züge)";
+            } else {
+                const Move& m = moves[pos - 1];
+                status = "Zug " + to_string(pos) + "/" + to_string(valid) + ": " + game.players[m.playerIndex]
+                       + " -> Spalte " + to_string(m.col + 1);
+                if (m.moveTimeMs > 0) status += " (" + to_string(m.moveTimeMs) + " ms)";
+            }
+            screen.text(1, 0, status);
+            int row;
+            if (ghostRow >= 0) {
+                const Move& m = moves[pos - 1];
+                row = positions[pos - 1].draw(screen, 2, symbols[0], symbols[1], ghostRow, m.col, symbols[m.playerIndex]);
+            } else {
+                row = positions[pos].draw(screen, 2, symbols[0], symbols[1]);
+            }
+            if constexpr (is_same_v<B, Board>) {
+                if (explorer) {
+                    BitBoard bits;
+                    for (size_t i = 0; i < pos; ++i) bits.dropDisc(moves[i].col);
+                    drawExplorer(screen, row, *explorer, bits);
+                }
+            }
+            screen.present();
+        };
+
+        size_t pos = 0;
+        auto settle = [&]() {
+            show(pos, -1);
+            if (pos == valid) {
+                if (!problem.empty()) {
+                    cout << "Log fehlerhaft: " << problem << "\n";
+                } else {
+                    cout << "Ergebnis: ";
+                    if (game.result == 0) cout << "Unentschieden\n";
+                    else if (game.result == 1) cout << "Sieg " << game.players[0] << "\n";
+                    else if (game.result == 2) cout << "Sieg " << game.players[1] << "\n";
+                    else cout << "Unbekannt\n";
+                }
+            }
+            cout << "Enter = vor | b = zurück | Nummer = zu Zug springen | s/e = Start/Ende | q/0 = beenden: " << flush;
+        };
+
+        // Animationsframes sind Zeitgeber mit der Nummer ihrer Animation; kommt
+        // vorher ein Befehl, gilt der Zug als fertig und die Frames verfallen
+        EventLoop loop;
+        unsigned animation = 0;
+        bool animating = false;
+        loop.onLine([&](const string& line) {
+            if (animating) {
+                ++animation;
+                animating = false;
+            }
+            if (line == "q" || line == "Q" || line == "0") {
+                cout << "Replay beendet.\n\n";
+                loop.stop();
+                return;
+            }
+            if (line.empty() || line == "n") {
+                if (pos < valid) {
+                    // Animation nur beim Schritt nach vorn
+                    const int targetRow = positions[pos].getDropRow(moves[pos].col);
+                    ++pos;
+                    if (animationMs > 0 && targetRow > 0) {
+                        const unsigned current = ++animation;
+                        animating = true;
+                        for (int r = 0; r < targetRow; ++r) {
+                            loop.after(r * animationMs, [&, current, r]() {
+                                if (current == animation) show(pos, r);
+                            });
+                        }
+                        loop.after(targetRow * animationMs, [&, current]() {
+                            if (current != animation) return;
+                            animating = false;
+                            settle();
+                        });
+                        return;
+                    }
+                }
+            } else if (line == "b") {
+                if (pos > 0) --pos;
+            } else if (line == "s") {
+                pos = 0;
+            } else if (line == "e") {
+                pos = valid;
+            } else if (isNumber(line) && line.size() < 6) {
+                pos = min(valid, static_cast<size_t>(stoul(line)));
+            }
+            settle();
+        });
+        settle();
+        loop.run();
+    }
+}
 
-        cout << "========================================\n";
-        cout << "               SPIEL ENDE\n";
-        cout << "========================================\n";
-        cout << headline << "\n";
-        if (!detail.empty()) cout << detail << "\n";
-        cout << "========================================\n\n";
+GameEngine::GameEngine(size_t ttMegabytes, const string& bookPath, int threads, int animationMs)
+    : tt(ttMegabytes), searchThreads(threads), animationMs(animationMs) {
+    string error;
+    if (book.open(bookPath, &error)) {
+        bookStatus = "Eröffnungsbuch: " + to_string(book.size()) + " Stellungen bis Halbzug "
+                   + to_string(book.maxPly());
+    } else {
+        bookStatus = "Eröffnungsbuch nicht geladen (" + bookPath + ": " + error + ")";
+    }
+}
 
-        pressEnterToContinue();
+bool GameEngine::setBoardSize(int rows, int cols) {
+    if (!withBoardSize(rows, cols, [](auto) {})) return false;
+    boardRows = rows;
+    boardCols = cols;
+    return true;
+}
+
+void GameEngine::startNewGame(OpponentType opponent) {
+    // Solver, MCTS und Buch rechnen auf dem BitBoard (ROWS x COLS)
+    if (opponent != OpponentType::Human && (boardRows != ROWS || boardCols != COLS)) {
+        cout << "Computergegner nur auf " << COLS << "x" << ROWS << ", die Partie läuft auf diesem Brett.\n";
+        play(Board(), opponent);
+        return;
     }
+    withBoardSize(boardRows, boardCols, [&](auto board) { play(board, opponent); });
 }
 
-void GameEngine::startNewGame() {
+template <typename B>
+void GameEngine::play(B board, OpponentType opponent) {
+    // 7x6: Regeln auf dem BitBoard (auch Stellung für den Computer), board
+    // nur Anzeige. Andere Größen: Regeln und Anzeige auf board
+    constexpr bool standard = B::HEIGHT == ROWS && B::WIDTH == COLS;
+    const string columns = "1-" + to_string(B::WIDTH);
     clearScreen();
-    Board board;
+    BitBoard bits;
     string players[2];
     char symbols[2] = {'X', 'O'};
     vector<Move> moves;
@@ -95,142 +283,295 @@ void GameEngine::startNewGame() {
     moves.clear();
     currentPlayer = 0;
 
+    bool isComputer[2] = {false, false};
+    ParallelSearch solver(tt, searchThreads);
+    string lastInfo;
+
     clearInputLine2(); 
     cout << "\n============ Neues Spiel =============\n";
-    cout << "Name Spieler 1 (Symbol X / Anzeige ●): ";
-    getline(cin >> ws, players[0]);
-    if (players[0].empty()) players[0] = "Spieler 1";
-
-    cout << "Name Spieler 2 (Symbol O / Anzeige ○): ";
-    getline(cin >> ws, players[1]);
-    if (players[1].empty()) players[1] = "Spieler 2";
+    if (opponent == OpponentType::Human) {
+        cout << "Name Spieler 1 (Symbol X / Anzeige ●): ";
+        getline(cin >> ws, players[0]);
+        if (players[0].empty()) players[0] = "Spieler 1";
+
+        cout << "Name Spieler 2 (Symbol O / Anzeige ○): ";
+        getline(cin >> ws, players[1]);
+        if (players[1].empty()) players[1] = "Spieler 2";
+    } else {
+        string name, first;
+        cout << "Dein Name: ";
+        getline(cin >> ws, name);
+        if (name.empty()) name = "Spieler 1";
+
+        cout << "Wer beginnt? (1 = du, 2 = Computer): ";
+        cin >> first;
+        int cpu = (first == "2") ? 0 : 1;
+        isComputer[cpu] = true;
+        players[cpu] = (opponent == OpponentType::Mcts) ? "Computer (MCTS)" : "Computer";
+        players[1 - cpu] = name;
+        if (opponent == OpponentType::Mcts) {
+            mcts.clear();
+            lastInfo = "MCTS: " + to_string(ENGINE_BUDGET_MS) + " ms pro Zug, Arena "
+                     + to_string(mcts.capacity()) + " Knoten";
+        } else {
+            lastInfo = bookStatus;
+        }
+    }
 
-    bool gameOver = false;
     int result = -1; // 0 draw, 1 p0 win, 2 p1 win, -1 none
+    bool finished = false;
+    string endHeadline = "Spiel wurde abgebrochen.", endDetail = "Kein Log wird gespeichert.";
+
+    // Brett und Statuszeilen; die Animationsframes unterscheiden sich davon
+    // nur im fallenden Stein, present() schreibt also nur diese Zellen
+    Screen& screen = Screen::terminal();
+    auto drawTurn = [&](int ghostRow, int ghostCol) {
+        screen.clear();
+        int row = board.draw(screen, 0, symbols[0], symbols[1], ghostRow, ghostCol, symbols[currentPlayer]);
+        if (!lastInfo.empty()) row = screen.lines(row, 0, lastInfo);
+        screen.text(row++, 0, "Am Zug: " + players[currentPlayer] + " (" + (currentPlayer == 0 ? "●" : "○") + ")");
+        return row;
+    };
 
-    while (!gameOver) {
-        clearScreen();
-        board.printPretty(symbols[0], symbols[1]);
-
-        const string &pName = players[currentPlayer];
-        char sym = symbols[currentPlayer];
+    // Ablauf als Ereignisse: Zug anfordern -> Stein fällt (ein Frame pro
+    // Zeile per Zeitgeber) -> setzen -> nächster Zug. Jeder Zug hat eine
+    // Nummer; Zeitgeber und Suchergebnisse eines alten Zugs verfallen.
+    // Das Zeitlimit ist ein Zeitgeber auf turnStart + TURN_LIMIT_MS, der
+    // Countdown einer pro Sekunde: dazwischen schläft select().
+    EventLoop loop;
+    unsigned turn = 0;
+    bool awaitingInput = false;   // Mensch am Zug, Eingabefeld offen
+    bool dropping = false;        // Stein fällt, Zug steht fest
+    auto turnStart = EventLoop::Clock::now();
+    string typed, message;        // Eingabefeld, Hinweis darunter
+    deque<string> queued;         // während Animation/Suche abgeschickt
+    int escapeBytes = 0;          // Rest einer Escape-Folge (Pfeiltasten)
+    thread engine;
+    function<void()> beginTurn;
+    function<void(const string&)> submit;
+
+    auto elapsedMs = [&]() {
+        return chrono::duration_cast<chrono::milliseconds>(EventLoop::Clock::now() - turnStart).count();
+    };
 
-        cout << "Am Zug: " << pName << " (" << (currentPlayer == 0 ? "●" : "○") << ")\n";
+    auto finish = [&](int res, const string& headline, const string& detail) {
+        result = res;
+        finished = true;
+        endHeadline = headline;
+        endDetail = detail;
+        loop.stop();
+    };
 
-        auto tStart = chrono::steady_clock::now();
-        int col = readColumnOrAbort(pName);
-        auto tEnd = chrono::steady_clock::now();
-        long long ms = chrono::duration_cast<chrono::milliseconds>(tEnd - tStart).count();
+    auto timeOut = [&](long long ms) {
+        finish(currentPlayer == 0 ? 2 : 1, "Zeitlimit überschritten!",
+               "Sieg für " + players[1 - currentPlayer] + " (zu langsam: " + to_string(ms) + " ms).");
+    };
 
-        if (ms > TURN_LIMIT_MS) {
-            string winner = players[1 - currentPlayer];
-            result = (currentPlayer == 0) ? 2 : 1;
-            gameOver = true;
-
-            showGameOverScreen(
-                board, symbols[0], symbols[1],
-                "Zeitlimit überschritten!",
-                "Sieg für " + winner + " (zu langsam: " + to_string(ms) + " ms)."
-            );
-            break;
+    // Frame während der Bedenkzeit: Countdown, Eingabefeld bzw. Suchhinweis
+    auto drawWaiting = [&]() {
+        int row = drawTurn(-1, -1);
+        const long long left = (TURN_LIMIT_MS - elapsedMs() + 999) / 1000;
+        screen.text(row++, 0, "Zeitlimit: " + to_string(max(0LL, left)) + " s");
+        if (isComputer[currentPlayer]) {
+            screen.text(row++, 0, "Computer denkt nach...");
+        } else {
+            int col = screen.text(row, 0, players[currentPlayer] + " wählt Spalte (" + columns + ") | 0/q = Abbruch: ");
+            col = screen.text(row, col, typed);
+            screen.cursorAt(row++, col);
+            if (!message.empty()) screen.text(row++, 0, message);
         }
+        screen.present();
+    };
 
+    auto place = [&](int col, long long ms) {
+        dropping = false;
+        const int finalRow = board.dropDisc(col, symbols[currentPlayer]);
+        moves.push_back({currentPlayer, col, ms});
 
-        if (col == -1) {
-            showGameOverScreen(
-                board, symbols[0], symbols[1],
-                "Spiel wurde abgebrochen.",
-                "Kein Log wird gespeichert."
-            );
-            return; // zurück ins Menü
+        bool won, full;
+        if constexpr (standard) {
+            const int bitRow = bits.dropDisc(col);
+            won = bits.checkWinAt(bitRow, col);
+            full = bits.isFull();
+        } else {
+            won = board.checkWinAt(finalRow, col);
+            full = board.isFull();
         }
-
-
-        int targetRow = board.getDropRow(col);
-        if (targetRow == -1) {
-            cout << "Diese Spalte ist voll. Bitte eine andere Spalte wählen.\n";
-            pressEnterToContinue();
-            clearInputLine();
-            continue;
+        if (won) {
+            finish(currentPlayer + 1, "Sieg!", "Gewonnen hat: " + players[currentPlayer]);
+        } else if (full) {
+            finish(0, "Unentschieden!", "Das Brett ist voll.");
+        } else {
+            currentPlayer = 1 - currentPlayer;
+            beginTurn();
         }
+    };
 
-        // Animation: Stein fällt von oben bis targetRow
-        for (int r = 0; r <= targetRow; ++r) {
-            clearScreen();
-            board.printPretty(symbols[0], symbols[1], r, col, sym);
-            this_thread::sleep_for(chrono::milliseconds(60));
+    auto playMove = [&](int col, long long ms) {
+        awaitingInput = false;
+        if (ms > TURN_LIMIT_MS) {
+            timeOut(ms);
+            return;
+        }
+        dropping = true;
+        // Animation: Stein fällt von oben bis zur Zielzeile, danach setzen
+        const int targetRow = board.getDropRow(col);
+        if (animationMs > 0) {
+            for (int r = 0; r <= targetRow; ++r) {
+                loop.after(r * animationMs, [&, r, col]() {
+                    drawTurn(r, col);
+                    screen.present();
+                });
+            }
         }
+        loop.after((targetRow + 1) * animationMs, [&, col, ms]() { place(col, ms); });
+    };
 
-        // Final wirklich setzen
-        int finalRow = board.dropDisc(col, sym);
-        if (finalRow == -1) {
-            cout << "Interner Fehler beim Setzen. Bitte erneut.\n";
-            continue;
+    auto awaitInput = [&]() {
+        awaitingInput = true;
+        if (!queued.empty()) {
+            const string next = queued.front();
+            queued.pop_front();
+            loop.after(0, [&, next]() { submit(next); });
+        } else if (loop.inputClosed()) {
+            loop.stop();   // es kommt keine Eingabe mehr: Abbruch
         }
+    };
 
-        // Logging wie bisher
-        moves.push_back({currentPlayer, col, ms});
+    submit = [&](const string& line) {
+        // wie früher cin >> input: ein Wort, Leerzeilen zählen nicht
+        string input;
+        istringstream(line) >> input;
+        if (input.empty()) return;
+        if (!awaitingInput) {
+            queued.push_back(input);
+            return;
+        }
 
-        if (board.checkWin(sym)) {
-            result = currentPlayer + 1;
-            gameOver = true;
-
-            showGameOverScreen(
-                board, symbols[0], symbols[1],
-                "Sieg!",
-                "Gewonnen hat: " + pName
-            );
-        } else if (board.isFull()) {
-            result = 0;
-            gameOver = true;
-
-            showGameOverScreen(
-                board, symbols[0], symbols[1],
-                "Unentschieden!",
-                "Das Brett ist voll."
-            );
-        } else {
-            currentPlayer = 1 - currentPlayer;
+        const long long ms = elapsedMs();
+        const int col = parseColumn(input, B::WIDTH);
+        if (col == -1) {
+            loop.stop();
+            return;
+        }
+        if (col == -2 || board.getDropRow(col) < 0) {
+            message = col == -2 ? "Ungültig. Bitte " + columns + " oder 0/q."
+                                : "Diese Spalte ist voll. Bitte eine andere Spalte wählen.";
+            drawWaiting();
+            awaitInput();
+            return;
         }
+        message.clear();
+        playMove(col, ms);
+    };
 
-    }
+    auto tick = [&](unsigned id, int second, auto& self) -> void {
+        if (id != turn || dropping) return;
+        drawWaiting();
+        const auto next = turnStart + chrono::seconds(second + 1);
+        if (next < turnStart + chrono::milliseconds(TURN_LIMIT_MS))
+            loop.at(next, [&, id, second, self]() { self(id, second + 1, self); });
+    };
 
-    // Statistiken sammeln
-    long long totalGameMs = 0;
-    long long movesP0 = 0, movesP1 = 0;
-    long long totalMsP0 = 0, totalMsP1 = 0;
-    long long fastestP0 = -1, fastestP1 = -1;
-    long long slowestP0 = -1, slowestP1 = -1;
+    beginTurn = [&]() {
+        const unsigned id = ++turn;
+        turnStart = EventLoop::Clock::now();
+        message.clear();
+        // genau am Limit, egal ob Mensch tippt oder Computer rechnet
+        loop.at(turnStart + chrono::milliseconds(TURN_LIMIT_MS), [&, id]() {
+            if (id == turn && !dropping) timeOut(elapsedMs());
+        });
+        tick(id, 0, tick);
+
+        if (!isComputer[currentPlayer]) {
+            awaitInput();
+            return;
+        }
 
-    auto upd = [](long long v, long long& mn, long long& mx){
-        if (mn < 0 || v < mn) mn = v;
-        if (mx < 0 || v > mx) mx = v;
+        // Suche in eigenem Thread: die Schleife zeigt weiter den Countdown
+        // und liest Tasten; das Ergebnis kommt per post() zurück
+        if (engine.joinable()) engine.join();
+        engine = thread([&, id, position = bits]() {
+            SearchResult res;
+            ostringstream info;
+            int col;
+            if (opponent == OpponentType::Mcts) {
+                MctsResult mr = mcts.search(position, ENGINE_BUDGET_MS);
+                col = mr.bestMove;
+                info << "Computer (MCTS): Spalte " << (col + 1) << " ("
+                     << mr.micros / 1000 << " ms, " << mr.playouts << " Playouts, "
+                     << fixed << setprecision(0) << mr.playoutsPerSecond() << " Playouts/s, "
+                     << "Gewinnchance " << mr.winRate * 100.0 << "%)\n"
+                     << "Baum: " << mr.nodes << " Knoten (" << mr.reusedVisits
+                     << " Besuche übernommen), Speicher Spitze " << setprecision(1)
+                     << mr.peakBytes / (1024.0 * 1024.0) << " MB von "
+                     << mr.arenaBytes / (1024.0 * 1024.0) << " MB";
+            } else if (book.lookup(position, res.score, res.bestMove)) {
+                res.exact = true;
+                col = res.bestMove;
+                info << "Computer: Spalte " << (col + 1) << " (Eröffnungsbuch, Bewertung: "
+                     << describeScore(res, position) << ")";
+            } else {
+                res = solver.search(position, ENGINE_BUDGET_MS);
+                col = res.bestMove;
+                info << "Computer: Spalte " << (col + 1) << " ("
+                     << res.micros / 1000 << " ms, " << res.nodes << " Knoten, "
+                     << solver.threadCount() << " Threads, Bewertung: "
+                     << describeScore(res, position) << ")\n"
+                     << fixed << setprecision(1)
+                     << "TT: Treffer " << res.tt.hitRate() * 100.0 << "%, Kollisionen "
+                     << res.tt.collisions << ", Füllgrad " << tt.fillRatio() * 100.0 << "%";
+            }
+            loop.post([&, id, col, text = info.str()]() {
+                if (id != turn) return;
+                lastInfo = text;
+                playMove(col, elapsedMs());
+            });
+        });
     };
 
-    for (const auto& m : moves) {
-        totalGameMs += m.moveTimeMs;
-        if (m.playerIndex == 0) {
-            movesP0++; totalMsP0 += m.moveTimeMs;
-            upd(m.moveTimeMs, fastestP0, slowestP0);
-        } else {
-            movesP1++; totalMsP1 += m.moveTimeMs;
-            upd(m.moveTimeMs, fastestP1, slowestP1);
+    // Tasten einzeln (RawMode): das Eingabefeld zeichnen wir selbst
+    loop.onKey([&](char ch) {
+        if (escapeBytes > 0) {
+            --escapeBytes;
+        } else if (ch == '\033') {
+            escapeBytes = 2;
+        } else if (ch == '\n' || ch == '\r') {
+            string line;
+            line.swap(typed);
+            submit(line);
+            return;
+        } else if (ch == 127 || ch == '\b') {
+            if (!typed.empty()) typed.pop_back();
+        } else if (isprint(static_cast<unsigned char>(ch)) && typed.size() < 8) {
+            typed += ch;
         }
+        if (awaitingInput) drawWaiting();
+    });
+    loop.onClosed([&]() {
+        if (awaitingInput && queued.empty()) loop.stop();
+    });
+    loop.after(0, [&]() { beginTurn(); });
+    {
+        RawMode raw;
+        // endet ohne finish() bei Abbruch oder wenn die Eingabe zu ist
+        loop.run();
     }
+    if (engine.joinable()) engine.join();   // läuft höchstens noch ENGINE_BUDGET_MS
+
+    showGameOverScreen(board, symbols[0], symbols[1], endHeadline, endDetail);
+    if (!finished) return; // zurück ins Menü, ohne Log
 
     // Spiel in stats.csv schreiben
     #if HAS_FILESYSTEM
     try { fs::create_directories("logs"); } catch (...) {}
     #endif
 
-    Stats::appendGame("logs/stats.csv", players, result, totalGameMs,
-                    movesP0, movesP1, totalMsP0, totalMsP1,
-                    fastestP0, fastestP1, slowestP0, slowestP1);
-
+    Stats::appendGames("logs/stats.csv", {Stats::summarize(players, result, moves)});
 
     // speichern
     string fn = makeLogFileName();
-    if (GameLogger::save(fn, moves, players, symbols, result)) {
+    if (GameLogger::save(fn, moves, players, symbols, result, LogFormat::V3, B::HEIGHT, B::WIDTH)) {
         cout << "Log gespeichert: " << fn << "\n\n";
     } else {
         cout << "Fehler: Log konnte nicht gespeichert werden.\n\n";
@@ -241,84 +582,109 @@ void GameEngine::startNewGame() {
     cin >> plyagain;
     //clearInputLine();
     if (!plyagain.empty() && (plyagain[0] == 'j' || plyagain[0] == 'J')) {
-        startNewGame();
+        startNewGame(opponent);
     } 
 }
 
-void GameEngine::replayFromFile(const string &filename) {
-    vector<Move> moves;
-    string players[2];
-    char symbols[2];
-    int result = -1;
-
-    if (!GameLogger::load(filename, moves, players, symbols, result)) {
+void GameEngine::replayFromFile(const string &filename, int animationMs) {
+    GameLog game;
+    if (!GameLogger::read(filename, game)) {
         cout << "Replay fehlgeschlagen: Datei nicht lesbar oder falsches Format.\n\n";
         return;
     }
+    string problem;
+    size_t valid = 0;
+    GameLogger::verify(game, &problem, &valid);
+    const int rows = game.rows ? game.rows : ROWS, cols = game.cols ? game.cols : COLS;
+    // Explorer aus den Partien im Ordner des Logs
+    PositionDb explorer;
+    if (rows == ROWS && cols == COLS) {
+        const size_t slash = filename.find_last_of('/');
+        // neue Logs einlesen kann dauern: Fortschritt zeigen statt still zu warten
+        explorer.open(slash == string::npos ? "." : filename.substr(0, slash), nullptr, &cout);
+    }
+    const PositionDb* db = explorer.isOpen() ? &explorer : nullptr;
+    if (!withBoardSize(rows, cols, [&](auto board) { replay(board, filename, game, problem, valid, animationMs, db); }))
+        cout << "Replay fehlgeschlagen: " << problem << " wird nicht unterstützt.\n\n";
+}
 
-    clearInputLine();   // falls vorher cin >> benutzt wurde
-
-    Board board;
-    int moveNr = 1;
+string GameEngine::browseLogs(const string &folder) {
+    constexpr size_t PAGE = 15;
+    LogCatalog catalog;
+    string status;
+    if (!catalog.open(folder, &status)) {
+        cout << "Keine Logs: " << status << ".\n\n";
+        waitEnterPlain();
+        return "";
+    }
 
-    auto printHeader = [&](const Move& m) {
-        cout << "=== Replay: " << filename << " ===\n";
-        cout << "Zug " << moveNr << ": " << players[m.playerIndex]
-             << " -> Spalte " << (m.col + 1);
-        if (m.moveTimeMs > 0) cout << " (" << m.moveTimeMs << " ms)";
-        cout << "\n\n";
-    };
+    LogCatalog::Filter filter;
+    vector<uint32_t> hits = catalog.select(filter);
+    size_t page = 0;
+    string notice;   // Hinweis zur letzten Eingabe
 
-    for (size_t i = 0; i < moves.size(); ++i) {
-        const auto& m = moves[i];
-        // Validierung + Zielreihe (für Animation)
-        int targetRow = board.getDropRow(m.col);
-        if (targetRow == -1) {
-            clearScreen();
-            cout << "=== Replay: " << filename << " ===\n\n";
-            board.printPretty(symbols[0], symbols[1]);
-            cout << "Replay abgebrochen: Ungültiger Zug im Log (Spalte voll).\n\n";
-            break;
+    while (true) {
+        clearScreen();
+        cout << "=== Replays (" << status << ") ===\n";
+        if (!notice.empty()) cout << notice << "\n";
+        notice.clear();
+        if (!filter.player.empty() || filter.result != -2 || !filter.date.empty()) {
+            cout << "Filter:";
+            if (!filter.player.empty()) cout << " Spieler '" << filter.player << "'";
+            if (filter.result != -2) cout << " Ergebnis " << filter.result;
+            if (!filter.date.empty()) cout << " Datum " << filter.date << "*";
+            cout << "\n";
         }
 
-        // Animation (wenn du sie willst)
-        for (int r = 0; r <= targetRow; ++r) {
-            clearScreen();
-            printHeader(m);
-            board.printPretty(symbols[0], symbols[1], r, m.col, symbols[m.playerIndex]);
-            this_thread::sleep_for(chrono::milliseconds(60));
+        const size_t pages = hits.empty() ? 1 : (hits.size() + PAGE - 1) / PAGE;
+        if (page >= pages) page = pages - 1;
+        const size_t first = page * PAGE;
+        const size_t last = min(first + PAGE, hits.size());
+
+        cout << "\n";
+        if (hits.empty()) cout << "  (keine passenden Logs)\n";
+        for (size_t i = first; i < last; ++i) {
+            const CatalogEntry& e = catalog.entry(hits[i]);
+            cout << "  " << setw(4) << (i + 1) << ") " << LogCatalog::formatTime(e.timestamp) << "  "
+                 << e.players[0] << " vs. " << e.players[1] << "  ";
+            if (e.result == 0) cout << "Remis";
+            else if (e.result == 1 || e.result == 2) cout << "Sieg " << e.players[e.result - 1];
+            else cout << "offen";
+            cout << ", " << int(e.moveCount) << " Züge\n";
         }
 
-        // Final setzen
-        board.dropDisc(m.col, symbols[m.playerIndex]);
-
-        // Final anzeigen
-        clearScreen();
-        printHeader(m);
-        board.printPretty(symbols[0], symbols[1]);
+        cout << "\nSeite " << (page + 1) << "/" << pages << " (" << hits.size() << " Logs)\n"
+             << "Nummer = abspielen | n/p = nächste/vorige Seite | f = Filter | 0 = zurück: ";
+        string cmd;
+        if (!(cin >> cmd)) {
+            clearInputLine();
+            return "";
+        }
 
-        // Prompt für nächster Zug / Abbruch
-        bool isLast = (i + 1 == moves.size());
-        if (!isLast) {
-            cout << "Enter = nächster Zug | q/0 = abbrechen: ";
+        if (cmd == "0" || cmd == "q") return "";
+        if (cmd == "n") { if (page + 1 < pages) ++page; continue; }
+        if (cmd == "p") { if (page > 0) --page; continue; }
+        if (cmd == "f") {
+            clearInputLine();
             string line;
+            cout << "Spielername (Teil, leer = alle): ";
+            getline(cin, filter.player);
+            cout << "Ergebnis (0 = Remis, 1/2 = Sieg Spieler 1/2, leer = alle): ";
             getline(cin, line);
-            if (!line.empty() && (line[0] == 'q' || line[0] == 'Q' || line[0] == '0')) {
-                cout << "Replay abgebrochen.\n\n";
-                return;
+            filter.result = (line == "0" || line == "1" || line == "2") ? stoi(line) : -2;
+            cout << "Datum (JJJJ, JJJJ-MM oder JJJJ-MM-TT, leer = alle): ";
+            getline(cin, filter.date);
+            hits = catalog.select(filter);
+            page = 0;
+            continue;
+        }
+        if (isNumber(cmd) && cmd.size() < 9) {
+            size_t nr = stoul(cmd);
+            if (nr >= 1 && nr <= hits.size()) {
+                const string path = catalog.path(catalog.entry(hits[nr - 1]));
+                if (!path.empty()) return path;
+                notice = "Log " + to_string(nr) + " gibt es nicht mehr.";
             }
         }
-
-        ++moveNr;
     }
-
-    // Ergebnis am Ende
-    cout << "Replay beendet. Ergebnis: ";
-    if (result == 0) cout << "Unentschieden\n\n";
-    else if (result == 1) cout << "Sieg " << players[0] << "\n\n";
-    else if (result == 2) cout << "Sieg " << players[1] << "\n\n";
-    else cout << "Unbekannt\n\n";
-    return;
 }
-
-
@@ -1,9 +1,53 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
+#include "book/openingbook.h"
+#include "constants.h"
+#include "mcts/mcts.h"
+#include "solver/transpositiontable.h"
+
+// Wer spielt gegen Spieler 1?
+enum class OpponentType {
+    Human,      // zwei Menschen an einer Tastatur
+    Computer,   // Solver (Negamax / Alpha-Beta)
+    Mcts        // Monte-Carlo-Baumsuche
+};
+
 class GameEngine {
 public:
-    void startNewGame();
-    static void replayFromFile(const std::string &filename);
+    // threads <= 0: alle Kerne; animationMs: Dauer eines Animationsschritts (0 = sofort)
+    explicit GameEngine(size_t ttMegabytes = TT_DEFAULT_MB,
+                        const std::string& bookPath = OPENING_BOOK_PATH,
+                        int threads = 0,
+                        int animationMs = ANIMATION_FRAME_MS);
+
+    // Brettgröße künftiger Partien (siehe BOARD_SIZES); false = nicht unterstützt
+    bool setBoardSize(int rows, int cols);
+
+    // Spiel und Replay laufen in einer EventLoop: Animationen sind
+    // Zeitgeber, Eingaben werden währenddessen gelesen und gepuffert.
+    // Die Partie läuft auf dem GameBoard ihrer Größe; Computergegner
+    // gibt es nur auf dem Standardbrett
+    void startNewGame(OpponentType opponent = OpponentType::Human);
+    static void replayFromFile(const std::string &filename, int animationMs = ANIMATION_FRAME_MS);
+
+    // Blättert seitenweise durch den Katalog von folder (mit Filtern).
+    // Rückgabe: gewählte Logdatei, leer = abgebrochen
+    static std::string browseLogs(const std::string &folder = "logs");
+
+private:
+    template <typename B>
+    void play(B board, OpponentType opponent);
+
+    int boardRows = ROWS;
+    int boardCols = COLS;
+    // bleibt über Partien hinweg gefüllt (Schlüssel sind eindeutig)
+    TranspositionTable tt;
+    int searchThreads;
+    int animationMs;
+    Mcts mcts;
+    OpeningBook book;
+    std::string bookStatus;
 };
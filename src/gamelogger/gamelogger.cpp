@@ -1,29 +1,286 @@
 #include "gamelogger.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <iostream>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+
+#include "board/bitboard.h"
+#include "board/board.h"
+#include "constants.h"
+#include "gamelogger/logcatalog.h"
+#include "util/mappedfile.h"
+#include "util/util.h"
 
 using namespace std;
 
+namespace {
+    const char V3_MAGIC[16] = {'C', 'O', 'N', 'N', 'E', 'C', 'T', '4', '_', 'L', 'O', 'G', '_', 'V', '3', '\n'};
+    constexpr size_t V3_FIXED = sizeof(V3_MAGIC) + 5;
+
+    uint32_t fnv1a(const uint8_t* data, size_t size) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    void putVarint(vector<uint8_t>& out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) return false;
+            uint8_t b = *p++;
+            v |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // V1/V2: zeilenweise Text
+    bool loadText(const string& filename, GameLog& out) {
+        ifstream in(filename);
+        if (!in) return false;
+
+        out.moves.clear();
+        out.players[0] = "Spieler 1";
+        out.players[1] = "Spieler 2";
+        out.symbols[0] = 'X';
+        out.symbols[1] = 'O';
+        out.result = -1;
+        out.rows = 0;
+        out.cols = 0;
+        out.movesOffset = 0;
+
+        string header;
+        if (!getline(in, header)) return false;
+
+        bool v2 = (header == "CONNECT4_LOG_V2");
+        bool v1 = (header == "CONNECT4_LOG_V1");
+        if (!v1 && !v2) return false;
+
+        string line;
+        streamoff lineStart = in.tellg();
+        for (; getline(in, line); lineStart = in.tellg()) {
+            if (line.rfind("PLAYER0:", 0) == 0) out.players[0] = line.substr(8);
+            else if (line.rfind("PLAYER1:", 0) == 0) out.players[1] = line.substr(8);
+            else if (line.rfind("SYMBOL0:", 0) == 0) out.symbols[0] = (line.size() > 8 ? line[8] : 'X');
+            else if (line.rfind("SYMBOL1:", 0) == 0) out.symbols[1] = (line.size() > 8 ? line[8] : 'O');
+            else if (line.rfind("RESULT:", 0) == 0) out.result = stoi(line.substr(7));
+            else if (line.rfind("MOVE;", 0) == 0) {
+                if (out.moves.empty()) out.movesOffset = static_cast<size_t>(lineStart);
+                stringstream ss(line);
+                string tok;
+                Move m{0, 0, 0};
+
+                getline(ss, tok, ';'); // MOVE
+                getline(ss, tok, ';'); m.playerIndex = stoi(tok);
+                getline(ss, tok, ';'); m.col = stoi(tok);
+                if (v2) {
+                    getline(ss, tok, ';');
+                    m.moveTimeMs = tok.empty() ? 0 : stoll(tok);
+                } else {
+                    m.moveTimeMs = 0; // v1 hatte keine Zeiten
+                }
+                out.moves.push_back(m);
+            }
+        }
+        return true;
+    }
+
+    // movesOffset: Byte-Position der ersten MOVE-Zeile
+    bool saveText(const string& filename, const GameLog& g, size_t& movesOffset) {
+        ofstream out(filename);
+        if (!out) return false;
+
+        out << "CONNECT4_LOG_V2\n";
+        out << "PLAYER0:" << g.players[0] << "\n";
+        out << "PLAYER1:" << g.players[1] << "\n";
+        out << "SYMBOL0:" << g.symbols[0] << "\n";
+        out << "SYMBOL1:" << g.symbols[1] << "\n";
+        out << "RESULT:" << g.result << "\n";
+
+        movesOffset = static_cast<size_t>(out.tellp());
+        for (const auto &m : g.moves) {
+            out << "MOVE;" << m.playerIndex << ";" << m.col << ";" << m.moveTimeMs << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool writeFile(const string& filename, const vector<uint8_t>& data) {
+        ofstream out(filename, ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+        return static_cast<bool>(out);
+    }
+
+    // Züge nachspielen bis zum ersten Fehler (Grund in why).
+    // Rückgabe: gültige Züge; winner = Spieler, dessen Zug einen Vierer ergab
+    template <typename B>
+    size_t playMoves(B& board, const GameLog& game, int& winner, string& why) {
+        for (size_t i = 0; i < game.moves.size(); ++i) {
+            const Move& m = game.moves[i];
+            auto at = [&]() { return "Zug " + to_string(i + 1) + ": "; };
+            if (winner >= 0) { why = at() + "nach Spielende"; return i; }
+            if (m.playerIndex != static_cast<int>(i & 1)) { why = at() + "falscher Spieler"; return i; }
+            int row;
+            if constexpr (is_same_v<B, BitBoard>) row = board.dropDisc(m.col);
+            else row = board.dropDisc(m.col, m.playerIndex == 0 ? 'X' : 'O');
+            if (row < 0) { why = at() + "Spalte " + to_string(m.col + 1) + " ungültig oder voll"; return i; }
+            if (board.checkWinAt(row, m.col)) winner = m.playerIndex;
+        }
+        return game.moves.size();
+    }
+}
+
+bool GameLogger::encode(const GameLog& g, vector<uint8_t>& out, size_t* movesOffset) {
+    const size_t start = out.size();
+    out.insert(out.end(), V3_MAGIC, V3_MAGIC + sizeof(V3_MAGIC));
+    out.push_back(static_cast<uint8_t>(g.rows > 0 ? g.rows : ROWS));
+    out.push_back(static_cast<uint8_t>(g.cols > 0 ? g.cols : COLS));
+    out.push_back(static_cast<uint8_t>(g.symbols[0]));
+    out.push_back(static_cast<uint8_t>(g.symbols[1]));
+    out.push_back(static_cast<uint8_t>(static_cast<int8_t>(g.result)));
+    for (int p = 0; p < 2; ++p) {
+        const size_t len = utf8Length(g.players[p], 255);   // Längenbyte im V3-Header
+        out.push_back(static_cast<uint8_t>(len));
+        out.insert(out.end(), g.players[p].begin(), g.players[p].begin() + len);
+    }
+
+    if (movesOffset) *movesOffset = out.size() - start;
+    putVarint(out, g.moves.size());
+    for (size_t i = 0; i < g.moves.size(); ++i) {
+        const Move& m = g.moves[i];
+        if (m.playerIndex != static_cast<int>(i % 2) || m.col < 0 || m.col > 7) {
+            out.resize(start);
+            return false;
+        }
+        uint64_t ms = m.moveTimeMs > 0 ? static_cast<uint64_t>(m.moveTimeMs) : 0;
+        uint8_t b = static_cast<uint8_t>(m.col | ((ms & 15) << 3));
+        if (ms >> 4) {
+            out.push_back(b | 0x80);
+            putVarint(out, ms >> 4);
+        } else {
+            out.push_back(b);
+        }
+    }
+
+    uint32_t sum = fnv1a(out.data() + start, out.size() - start);
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(sum >> (8 * i)));
+    return true;
+}
+
+bool GameLogger::decode(const uint8_t* data, size_t size, GameLog& out) {
+    if (size < V3_FIXED + 2 + 1 + 4 || memcmp(data, V3_MAGIC, sizeof(V3_MAGIC)) != 0) return false;
+
+    const uint8_t* end = data + size - 4;
+    uint32_t stored = uint32_t(end[0]) | uint32_t(end[1]) << 8 | uint32_t(end[2]) << 16 | uint32_t(end[3]) << 24;
+    if (fnv1a(data, size - 4) != stored) return false;
+
+    const uint8_t* p = data + sizeof(V3_MAGIC);
+    out.rows = p[0];
+    out.cols = p[1];
+    out.symbols[0] = static_cast<char>(p[2]);
+    out.symbols[1] = static_cast<char>(p[3]);
+    out.result = static_cast<int8_t>(p[4]);
+    p += 5;
+    if (out.cols < 1 || out.cols > 8 || out.rows < 1) return false;
+
+    for (int i = 0; i < 2; ++i) {
+        if (p == end) return false;
+        size_t len = *p++;
+        if (static_cast<size_t>(end - p) < len) return false;
+        out.players[i].assign(reinterpret_cast<const char*>(p), len);
+        p += len;
+    }
+
+    out.movesOffset = static_cast<size_t>(p - data);
+    uint64_t count;
+    if (!getVarint(p, end, count) || count > static_cast<uint64_t>(out.rows) * out.cols) return false;
+    out.moves.resize(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i) {
+        if (p == end) return false;
+        const uint8_t b = *p++;
+        Move& m = out.moves[i];
+        m.playerIndex = static_cast<int>(i & 1);
+        m.col = b & 7;
+        uint64_t ms = (b >> 3) & 15;
+        if (b & 0x80) {
+            uint64_t high;
+            if (!getVarint(p, end, high)) return false;
+            ms |= high << 4;
+        }
+        m.moveTimeMs = static_cast<long long>(ms);
+        if (m.col >= out.cols) return false;
+    }
+    return p == end;
+}
+
+bool GameLogger::read(const string& filename, GameLog& out) {
+    {
+        MappedFile file;
+        if (!file.open(filename)) return false;
+        if (file.size() >= sizeof(V3_MAGIC) && memcmp(file.data(), V3_MAGIC, sizeof(V3_MAGIC)) == 0)
+            return decode(file.data(), file.size(), out);
+    }
+    try {
+        return loadText(filename, out);
+    } catch (...) {
+        return false; // kaputte Zahl in einer Textzeile
+    }
+}
+
 bool GameLogger::save(const string &filename,
                       const vector<Move> &moves,
                       const string players[2],
                       const char symbols[2],
-                      int result) {
-    ofstream out(filename);
-    if (!out) return false;
+                      int result,
+                      LogFormat format,
+                      int rows,
+                      int cols) {
+    if (format == LogFormat::V2 && (rows != ROWS || cols != COLS)) return false;
+    GameLog g;
+    g.rows = rows;
+    g.cols = cols;
+    g.players[0] = players[0];
+    g.players[1] = players[1];
+    g.symbols[0] = symbols[0];
+    g.symbols[1] = symbols[1];
+    g.result = result;
+    g.moves = moves;
 
-    out << "CONNECT4_LOG_V2\n";
-    out << "PLAYER0:" << players[0] << "\n";
-    out << "PLAYER1:" << players[1] << "\n";
-    out << "SYMBOL0:" << symbols[0] << "\n";
-    out << "SYMBOL1:" << symbols[1] << "\n";
-    out << "RESULT:" << result << "\n";
-
-    for (const auto &m : moves) {
-        out << "MOVE;" << m.playerIndex << ";" << m.col << ";" << m.moveTimeMs << "\n";
+    // über Temp-Datei + rename: auch Überschreiben ändert die Ordnerzeit,
+    // an der Katalog und Stellungsdatenbank ihren Stand erkennen
+    LogCatalog::Update catalog(filename);
+    const string tmp = filename + ".tmp";
+    vector<uint8_t> data;
+    bool ok;
+    if (format == LogFormat::V2) {
+        ok = saveText(tmp, g, g.movesOffset);
+    } else {
+        data.reserve(64 + moves.size() * 2);
+        ok = encode(g, data, &g.movesOffset) && writeFile(tmp, data);
     }
-    return true;
+    ok = ok && rename(tmp.c_str(), filename.c_str()) == 0;
+    if (!ok) remove(tmp.c_str());
+    if (ok) catalog.commit(g);
+    return ok;
 }
 
 bool GameLogger::load(const string &filename,
@@ -31,46 +288,142 @@ bool GameLogger::load(const string &filename,
                       string players[2],
                       char symbols[2],
                       int &result) {
-    ifstream in(filename);
-    if (!in) return false;
-
-    moves.clear();
-    players[0] = "Spieler 1";
-    players[1] = "Spieler 2";
-    symbols[0] = 'X';
-    symbols[1] = 'O';
-    result = -1;
-
-    string header;
-    if (!getline(in, header)) return false;
-
-    bool v2 = (header == "CONNECT4_LOG_V2");
-    bool v1 = (header == "CONNECT4_LOG_V1");
-    if (!v1 && !v2) return false;
-
-    string line;
-    while (getline(in, line)) {
-        if (line.rfind("PLAYER0:", 0) == 0) players[0] = line.substr(8);
-        else if (line.rfind("PLAYER1:", 0) == 0) players[1] = line.substr(8);
-        else if (line.rfind("SYMBOL0:", 0) == 0) symbols[0] = (line.size() > 8 ? line[8] : 'X');
-        else if (line.rfind("SYMBOL1:", 0) == 0) symbols[1] = (line.size() > 8 ? line[8] : 'O');
-        else if (line.rfind("RESULT:", 0) == 0) result = stoi(line.substr(7));
-        else if (line.rfind("MOVE;", 0) == 0) {
-            stringstream ss(line);
-            string tok;
-            Move m{0, 0, 0};
-
-            getline(ss, tok, ';'); // MOVE
-            getline(ss, tok, ';'); m.playerIndex = stoi(tok);
-            getline(ss, tok, ';'); m.col = stoi(tok);
-            if (v2) {
-                getline(ss, tok, ';');
-                m.moveTimeMs = tok.empty() ? 0 : stoll(tok);
-            } else {
-                m.moveTimeMs = 0; // v1 hatte keine Zeiten
-            }
-            moves.push_back(m);
+    GameLog g;
+    g.moves.swap(moves);
+    bool ok = read(filename, g);
+    // fremde Brettgröße: Replay/Regeln kennen nur ROWS x COLS
+    if (ok && g.rows != 0 && (g.rows != ROWS || g.cols != COLS)) ok = false;
+    moves.swap(g.moves);
+    if (!ok) {
+        moves.clear();
+        return false;
+    }
+    players[0] = g.players[0];
+    players[1] = g.players[1];
+    symbols[0] = g.symbols[0];
+    symbols[1] = g.symbols[1];
+    result = g.result;
+    return true;
+}
+
+int GameLogger::convertDirectory(const string &folder, ostream &log) {
+    int converted = 0, skipped = 0, failed = 0;
+    size_t bytesBefore = 0, bytesAfter = 0;
+    GameLog g;
+    vector<uint8_t> data;
+
+    for (const string& fn : listLogFiles(folder)) {
+        MappedFile file;
+        if (!file.open(fn)) { ++failed; continue; }
+        if (file.size() >= sizeof(V3_MAGIC) && memcmp(file.data(), V3_MAGIC, sizeof(V3_MAGIC)) == 0) {
+            ++skipped;
+            continue;
+        }
+        const size_t before = file.size();
+        file.close();
+
+        data.clear();
+        if (!read(fn, g) || !encode(g, data)) {
+            log << "Nicht konvertierbar: " << fn << "\n";
+            ++failed;
+            continue;
         }
+        // erst in Temp-Datei, dann umbenennen: nie ein halbes Log
+        const string tmp = fn + ".tmp";
+        if (!writeFile(tmp, data) || rename(tmp.c_str(), fn.c_str()) != 0) {
+            remove(tmp.c_str());
+            log << "Schreiben fehlgeschlagen: " << fn << "\n";
+            ++failed;
+            continue;
+        }
+        bytesBefore += before;
+        bytesAfter += data.size();
+        ++converted;
+    }
+
+    log << converted << " Logs nach V3 konvertiert (" << bytesBefore << " -> " << bytesAfter
+        << " Byte), " << skipped << " waren schon V3, " << failed << " Fehler.\n";
+    return failed;
+}
+
+bool GameLogger::verify(const GameLog &game, string *error, size_t *validMoves) {
+    auto fail = [&](size_t valid, const string& why) {
+        if (error) *error = why;
+        if (validMoves) *validMoves = valid;
+        return false;
+    };
+    const int rows = game.rows ? game.rows : ROWS, cols = game.cols ? game.cols : COLS;
+
+    int winner = -1;
+    bool full = false;
+    size_t valid = 0;
+    string why;
+    if (rows == ROWS && cols == COLS) {
+        BitBoard bits;
+        valid = playMoves(bits, game, winner, why);
+        full = bits.isFull();
+    } else if (!withBoardSize(rows, cols, [&](auto board) {
+                   valid = playMoves(board, game, winner, why);
+                   full = board.isFull();
+               })) {
+        return fail(0, "Brettgröße " + to_string(cols) + "x" + to_string(rows));
+    }
+    if (valid < game.moves.size()) return fail(valid, why);
+    if (validMoves) *validMoves = game.moves.size();
+
+    const size_t n = game.moves.size();
+    int expected = winner >= 0 ? winner + 1 : full ? 0 : -1;
+    // offenes Brett: abgebrochen oder Zeitlimit des Spielers am Zug
+    const bool ok = expected >= 0 ? game.result == expected
+                                  : game.result == -1 || game.result == 2 - static_cast<int>(n % 2);
+    if (!ok) {
+        if (error) *error = "RESULT:" + to_string(game.result) + ", Brett ergibt "
+                          + (expected >= 0 ? to_string(expected) : "-1 oder " + to_string(2 - static_cast<int>(n % 2)));
+        return false;
     }
     return true;
 }
+
+int GameLogger::verifyDirectory(const string &folder, int threads, ostream &log) {
+    const auto t0 = chrono::steady_clock::now();
+    const vector<string> files = listLogFiles(folder);
+    if (threads <= 0) threads = static_cast<int>(thread::hardware_concurrency());
+    threads = max(1, min(threads, static_cast<int>(files.size())));
+
+    vector<string> errors(files.size());
+    atomic<size_t> next{0};
+    atomic<long long> totalMoves{0};
+    auto work = [&]() {
+        GameLog g;
+        long long moves = 0;
+        for (size_t i = next++; i < files.size(); i = next++) {
+            string why;
+            if (!read(files[i], g)) {
+                errors[i] = "nicht lesbar";   // g hält noch die vorige Partie: nicht mitzählen
+                continue;
+            }
+            if (!verify(g, &why)) errors[i] = why;
+            moves += static_cast<long long>(g.moves.size());
+        }
+        totalMoves += moves;
+    };
+    vector<thread> helpers;
+    for (int t = 1; t < threads; ++t) helpers.emplace_back(work);
+    work();
+    for (auto& t : helpers) t.join();
+
+    int failed = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (errors[i].empty()) continue;
+        if (++failed <= 20) log << files[i] << ": " << errors[i] << "\n";
+    }
+    if (failed > 20) log << "... und " << (failed - 20) << " weitere\n";
+
+    const double seconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count() / 1e6;
+    log << files.size() << " Logs geprüft, " << failed << " fehlerhaft (" << threads << " Threads, "
+        << fixed << setprecision(2) << seconds << " s, "
+        << setprecision(0) << (seconds > 0 ? files.size() / seconds : 0.0) << " Logs/s, "
+        << (seconds > 0 ? totalMoves.load() / seconds : 0.0) << " Züge/s)\n";
+    log.unsetf(ios::floatfield);
+    return failed;
+}
@@ -1,13 +1,40 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
+#include "constants.h"
 #include "move.h"
 
+// Eine Partie aus einem Log. Für Massen-Auswertungen dasselbe Objekt
+// immer wieder an read()/decode() geben: moves behält seine Kapazität.
+struct GameLog {
+    std::string players[2];
+    char symbols[2] = {'X', 'O'};
+    int result = -1;
+    int rows = 0;   // 0 = unbekannt (V1/V2 kennen nur das Standardbrett)
+    int cols = 0;
+    size_t movesOffset = 0;  // Byte-Position der Zugdaten in der Datei
+    std::vector<Move> moves;
+};
+
+enum class LogFormat { V2, V3 };
+
 class GameLogger {
 public:
-    // Format (V2, enthält moveTimeMs):
+    // Format V3 (binär, Standard beim Speichern):
+    //   "CONNECT4_LOG_V3\n"                        16 Byte
+    //   rows, cols, symbol0, symbol1, result       je 1 Byte (result: int8)
+    //   len0, player0[len0], len1, player1[len1]   Namen max. 255 Byte
+    //   varint Anzahl Züge
+    //   pro Zug: Byte = Spalte (Bit 0-2) | Zeit & 15 (Bit 3-6) | weiter (Bit 7),
+    //            bei "weiter" folgt varint(Zeit >> 4); Spieler = Zugnummer % 2
+    //   uint32 FNV-1a über alle vorherigen Bytes (little endian)
+    //
+    // Format V2 (Text, enthält moveTimeMs), V1 ohne Zeiten:
     // CONNECT4_LOG_V2
     // PLAYER0:...
     // PLAYER1:...
@@ -15,15 +42,49 @@ public:
     // SYMBOL1:O
     // RESULT:0/1/2
     // MOVE;playerIndex;col;moveTimeMs
+    //
+    // V3 setzt abwechselnde Spieler voraus (Spieler 0 beginnt); save
+    // schlägt sonst fehl, ebenso V2 mit anderer Brettgröße als ROWS x COLS.
+    // Liegt im Zielordner ein Katalog (LogCatalog), trägt save die neue
+    // Datei dort ein.
     static bool save(const std::string &filename,
                      const std::vector<Move> &moves,
                      const std::string players[2],
                      const char symbols[2],
-                     int result);
+                     int result,
+                     LogFormat format = LogFormat::V3,
+                     int rows = ROWS,
+                     int cols = COLS);
 
+    // Liest V1, V2 und V3 (nur Partien auf dem Standardbrett)
     static bool load(const std::string &filename,
                      std::vector<Move> &moves,
                      std::string players[2],
                      char symbols[2],
                      int &result);
+
+    // Wie load, V3 wird per mmap ohne Zwischenkopie dekodiert
+    static bool read(const std::string &filename, GameLog &out);
+
+    // V3 aus einem Puffer (prüft Länge, Werte und Prüfsumme)
+    static bool decode(const uint8_t *data, size_t size, GameLog &out);
+
+    // V3 in einen Puffer (wird angehängt); false wenn Spieler nicht abwechseln.
+    // movesOffset: Position der Zugdaten ab Beginn des angehängten Logs
+    static bool encode(const GameLog &game, std::vector<uint8_t> &out, size_t *movesOffset = nullptr);
+
+    // Alle V1/V2-Logs im Ordner nach V3 umschreiben (atomar per rename).
+    // Rückgabe: Anzahl Dateien, die nicht konvertiert werden konnten
+    static int convertDirectory(const std::string &folder, std::ostream &log);
+
+    // Spielt die Partie auf einem Brett ihrer Größe nach (BitBoard bzw.
+    // GameBoard, siehe BOARD_SIZES): jeder Zug legal und vom
+    // richtigen Spieler, kein Zug nach Spielende, RESULT passt zu
+    // checkWin/isFull (ohne Vierer/volles Brett: -1 = offen oder Sieg des
+    // Gegners durch Zeitüberschreitung). validMoves = Züge bis zum ersten Fehler
+    static bool verify(const GameLog &game, std::string *error = nullptr, size_t *validMoves = nullptr);
+
+    // verify für alle Logs im Ordner, verteilt auf threads (<= 0: alle Kerne).
+    // Rückgabe: Anzahl fehlerhafter Logs
+    static int verifyDirectory(const std::string &folder, int threads, std::ostream &log);
 };
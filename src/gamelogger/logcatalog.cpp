@@ -0,0 +1,325 @@
+#include "logcatalog.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/util.h"
+
+using namespace std;
+
+namespace {
+    const char CATALOG_MAGIC[8] = {'C', '4', 'C', 'A', 'T', 'L', 'G', '2'};
+    const char* const LOCK_NAME = "catalog.lock";
+
+    string folderOf(const string& file) {
+        size_t slash = file.find_last_of('/');
+        if (slash == string::npos) return ".";
+        return slash == 0 ? "/" : file.substr(0, slash);
+    }
+
+    string baseName(const string& file) {
+        size_t slash = file.find_last_of('/');
+        return slash == string::npos ? file : file.substr(slash + 1);
+    }
+
+    bool validHeader(const uint8_t* data, size_t size, CatalogHeader& h) {
+        if (size < sizeof(CatalogHeader)) return false;
+        memcpy(&h, data, sizeof(h));
+        return memcmp(h.magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC)) == 0
+            && h.entrySize == sizeof(CatalogEntry)
+            // ein abgebrochenes Anhängen hinterlässt höchstens Überhang
+            && size >= sizeof(CatalogHeader) + h.count * sizeof(CatalogEntry);
+    }
+
+    // Schlüssel eines Logs im Katalog: der Name, so weit er ins Feld passt
+    string fileKey(const string& name) {
+        return name.substr(0, utf8Length(name, sizeof(CatalogEntry::file) - 1));
+    }
+
+    void makeEntry(const string& name, const GameLog& g, const struct stat& st, CatalogEntry& e) {
+        memset(&e, 0, sizeof(e));
+        const string key = fileKey(name);
+        memcpy(e.file, key.data(), key.size());
+        if (key.size() < name.size()) e.flags |= CatalogEntry::LONG_NAME;
+        for (int p = 0; p < 2; ++p)
+            memcpy(e.players[p], g.players[p].data(), utf8Length(g.players[p], sizeof(e.players[p]) - 1));
+        e.timestamp = static_cast<int64_t>(st.st_mtime);
+        e.fileSize = static_cast<uint64_t>(st.st_size);
+        e.movesOffset = static_cast<uint32_t>(g.movesOffset);
+        e.result = static_cast<int8_t>(g.result);
+        e.moveCount = static_cast<uint8_t>(min<size_t>(g.moves.size(), 255));
+    }
+
+    // Sperre für Neuaufbau, Update und KeepCurrent. Nicht catalog.idx selbst:
+    // rename ersetzt die Datei, die Sperre hinge dann am alten Inode. Auch
+    // nicht der Ordner: den hält PositionDb::update während des ganzen
+    // Einlesens, Speichern soll darauf nicht warten.
+    // create: Sperrdatei anlegen (nur der Neuaufbau). -1 = kein Katalog
+    int lockCatalog(const string& folder, bool create) {
+        int fd = ::open((folder + "/" + LOCK_NAME).c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+        if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    void unlockCatalog(int fd) {
+        if (fd < 0) return;
+        flock(fd, LOCK_UN);
+        ::close(fd);
+    }
+
+    string lower(string s) {
+        for (char& c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+}
+
+bool LogCatalog::rebuild(const string& folder, const MappedFile& old, size_t* added) {
+    struct Lock {
+        int fd;
+        ~Lock() { unlockCatalog(fd); }
+    } lock{lockCatalog(folder, true)};
+    if (lock.fd < 0) return false;
+
+    // Temp-Datei anlegen, bevor die Ordnerzeit gelesen wird: danach ändert
+    // nur noch das rename den Ordner. Ändert er sich vorher, kam während
+    // des Lesens etwas hinzu, das nicht gesperrt schreibt
+    const string catalogPath = folder + "/" + FILE_NAME;
+    const string tmp = catalogPath + ".tmp";
+    ofstream out(tmp, ios::binary | ios::trunc);
+    if (!out) return false;
+    const int64_t before = dirMtimeNs(folder);
+
+    // alte Einträge nach Dateiname, falls die Datei sich nicht geändert hat
+    unordered_map<string, const CatalogEntry*> known;
+    CatalogHeader oldHeader;
+    if (old.isOpen() && validHeader(old.data(), old.size(), oldHeader)) {
+        const CatalogEntry* e = reinterpret_cast<const CatalogEntry*>(old.data() + sizeof(CatalogHeader));
+        for (size_t i = 0; i < oldHeader.count; ++i) known.emplace(e[i].file, &e[i]);
+    }
+
+    vector<CatalogEntry> list;
+    list.reserve(known.size() + 16);
+    GameLog g;
+    for (const string& path : listLogFiles(folder)) {
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0) continue;
+        const string name = baseName(path);
+
+        auto it = known.find(fileKey(name));
+        if (it != known.end() && it->second->timestamp == static_cast<int64_t>(st.st_mtime)
+            && it->second->fileSize == static_cast<uint64_t>(st.st_size)) {
+            list.push_back(*it->second);
+            continue;
+        }
+        if (GameLogger::read(path, g)) {
+            CatalogEntry e;
+            makeEntry(name, g, st, e);
+            list.push_back(e);
+            if (added) ++*added;
+        }
+    }
+    sort(list.begin(), list.end(), [](const CatalogEntry& a, const CatalogEntry& b) {
+        return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : strcmp(a.file, b.file) < 0;
+    });
+
+    CatalogHeader h{};
+    memcpy(h.magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+    h.entrySize = sizeof(CatalogEntry);
+    h.count = list.size();
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(list.data()),
+              static_cast<streamsize>(list.size() * sizeof(CatalogEntry)));
+    out.close();
+    if (!out) return false;
+    const bool complete = dirMtimeNs(folder) == before;
+    if (rename(tmp.c_str(), catalogPath.c_str()) != 0) return false;
+    if (!complete) return true; // ohne Zeitstempel: gilt als veraltet
+
+    // erst jetzt: das Umbenennen selbst ändert den Ordner noch einmal
+    int fd = ::open(catalogPath.c_str(), O_WRONLY);
+    if (fd < 0) return false;
+    h.dirMtimeNs = dirMtimeNs(folder);
+    bool ok = pwrite(fd, &h.dirMtimeNs, sizeof(h.dirMtimeNs), offsetof(CatalogHeader, dirMtimeNs))
+              == static_cast<ssize_t>(sizeof(h.dirMtimeNs));
+    ::close(fd);
+    return ok;
+}
+
+bool LogCatalog::map(int64_t dirMtime, bool anyTime) {
+    CatalogHeader h;
+    if (!file.open(folder + "/" + FILE_NAME) || !validHeader(file.data(), file.size(), h)) return false;
+    if (!anyTime && h.dirMtimeNs != dirMtime) return false;
+    entries = reinterpret_cast<const CatalogEntry*>(file.data() + sizeof(CatalogHeader));
+    count = static_cast<size_t>(h.count);
+    return true;
+}
+
+bool LogCatalog::open(const string& logFolder, string* status) {
+    close();
+    folder = logFolder;
+    const int64_t mt = dirMtimeNs(folder);
+    if (mt < 0) {
+        if (status) *status = "Ordner '" + folder + "' fehlt";
+        return false;
+    }
+    if (map(mt)) {
+        if (status) *status = to_string(count) + " Logs (Katalog aktuell)";
+        return true;
+    }
+
+    // Kam während des Aufbaus etwas hinzu, noch einmal (schon gelesene Logs
+    // werden übernommen). Hört der Ordner nicht auf, sich zu ändern, zeigen
+    // wir den letzten Stand; der nächste open() baut dann wieder auf
+    size_t added = 0;
+    bool current = false;
+    for (int attempt = 0; attempt < 3 && !current; ++attempt) {
+        if (!rebuild(folder, file, &added)) {
+            close();
+            if (status) *status = "Katalog konnte nicht geschrieben werden";
+            return false;
+        }
+        current = map(dirMtimeNs(folder));
+    }
+    if (!current && !map(0, true)) {
+        close();
+        if (status) *status = "Katalog konnte nicht gelesen werden";
+        return false;
+    }
+    if (status)
+        *status = to_string(count) + " Logs (Katalog neu aufgebaut, " + to_string(added) + " Logs gelesen"
+                + (current ? ")" : ", Ordner ändert sich noch)");
+    return true;
+}
+
+void LogCatalog::close() {
+    file.close();
+    entries = nullptr;
+    count = 0;
+}
+
+string LogCatalog::path(const CatalogEntry& e) const {
+    if (!(e.flags & CatalogEntry::LONG_NAME)) return folder + "/" + e.file;
+    const size_t prefix = strlen(e.file);
+    for (const string& p : listLogFiles(folder)) {
+        const string name = baseName(p);
+        struct stat st{};
+        if (name.size() > prefix && name.compare(0, prefix, e.file) == 0 && stat(p.c_str(), &st) == 0
+            && static_cast<int64_t>(st.st_mtime) == e.timestamp && static_cast<uint64_t>(st.st_size) == e.fileSize)
+            return p;
+    }
+    return "";
+}
+
+string LogCatalog::formatTime(int64_t timestamp) {
+    time_t t = static_cast<time_t>(timestamp);
+    tm lt{};
+    localtime_r(&t, &lt);
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &lt);
+    return buf;
+}
+
+vector<uint32_t> LogCatalog::select(const Filter& filter) const {
+    const string player = lower(filter.player);
+    vector<uint32_t> out;
+    for (size_t i = count; i-- > 0;) {
+        const CatalogEntry& e = entries[i];
+        if (filter.result != -2 && e.result != filter.result) continue;
+        if (!player.empty() && lower(e.players[0]).find(player) == string::npos
+            && lower(e.players[1]).find(player) == string::npos) continue;
+        if (!filter.date.empty() && formatTime(e.timestamp).compare(0, filter.date.size(), filter.date) != 0)
+            continue;
+        out.push_back(static_cast<uint32_t>(i));
+    }
+    return out;
+}
+
+LogCatalog::Update::Update(const string& file) : logFile(file), folder(folderOf(file)) {
+    lockFd = lockCatalog(folder, false);
+    if (lockFd < 0) return; // kein Katalog in diesem Ordner
+    fd = ::open((folder + "/" + FILE_NAME).c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) return;
+
+    uint8_t buf[sizeof(CatalogHeader)];
+    struct stat st{};
+    // validHeader liest nur den Kopf, prüft aber die Länge der ganzen Datei
+    if (pread(fd, buf, sizeof(buf), 0) != static_cast<ssize_t>(sizeof(buf)) || fstat(fd, &st) != 0
+        || !validHeader(buf, static_cast<size_t>(st.st_size), header))
+        return;
+
+    struct stat existing{};
+    if (stat(logFile.c_str(), &existing) == 0) {
+        // Überschreiben ändert den Ordner nicht: Katalog als veraltet markieren
+        header.dirMtimeNs = 0;
+        if (pwrite(fd, &header.dirMtimeNs, sizeof(header.dirMtimeNs), offsetof(CatalogHeader, dirMtimeNs)) < 0) {
+            // nicht schreibbar: dann wird eben auch nichts eingetragen
+        }
+        return;
+    }
+    current = header.dirMtimeNs == dirMtimeNs(folder);
+}
+
+void LogCatalog::Update::commit(const GameLog& game) {
+    if (!current) return;
+    current = false;
+
+    struct stat st{};
+    CatalogEntry e;
+    if (stat(logFile.c_str(), &st) != 0) return;
+    makeEntry(baseName(logFile), game, st, e);
+
+    // Eintrag zuerst, Kopf danach: bricht das ab, fehlt nur der Eintrag und
+    // der veraltete Zeitstempel erzwingt beim nächsten open() den Neuaufbau
+    off_t at = static_cast<off_t>(sizeof(CatalogHeader) + header.count * sizeof(CatalogEntry));
+    if (pwrite(fd, &e, sizeof(e), at) != static_cast<ssize_t>(sizeof(e))) return;
+    header.count++;
+    header.dirMtimeNs = dirMtimeNs(folder);
+    if (pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        // Eintrag steht im Überhang, der Katalog gilt beim nächsten open() als veraltet
+    }
+}
+
+LogCatalog::Update::~Update() {
+    if (fd >= 0) ::close(fd);
+    unlockCatalog(lockFd);
+}
+
+LogCatalog::KeepCurrent::KeepCurrent(const string& logFolder) : folder(logFolder) {
+    lockFd = lockCatalog(folder, false);
+    if (lockFd < 0) return; // kein Katalog in diesem Ordner
+    fd = ::open((folder + "/" + FILE_NAME).c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) return;
+
+    uint8_t buf[sizeof(CatalogHeader)];
+    struct stat st{};
+    CatalogHeader header;
+    current = pread(fd, buf, sizeof(buf), 0) == static_cast<ssize_t>(sizeof(buf)) && fstat(fd, &st) == 0
+              && validHeader(buf, static_cast<size_t>(st.st_size), header)
+              && header.dirMtimeNs == dirMtimeNs(folder);
+}
+
+LogCatalog::KeepCurrent::~KeepCurrent() {
+    if (current) {
+        const int64_t mtime = dirMtimeNs(folder);
+        if (pwrite(fd, &mtime, sizeof(mtime), offsetof(CatalogHeader, dirMtimeNs)) < 0) {
+            // nicht schreibbar: der nächste open() baut eben neu auf
+        }
+    }
+    if (fd >= 0) ::close(fd);
+    unlockCatalog(lockFd);
+}
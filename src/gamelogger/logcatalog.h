@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gamelogger/gamelogger.h"
+#include "util/mappedfile.h"
+
+// Katalog eines Log-Ordners (<ordner>/catalog.idx, native Byte-Reihenfolge,
+// wird per mmap gelesen):
+//   CatalogHeader
+//   CatalogEntry[count], aufsteigend nach timestamp
+// dirMtimeNs ist die Änderungszeit des Ordners, zu der der Katalog zuletzt
+// vollständig war. Weicht sie ab (Datei von außen angelegt/gelöscht), wird
+// beim nächsten open() neu aufgebaut; unveränderte Einträge werden dabei
+// übernommen, nur neue Logs werden gelesen.
+// Neuaufbau, Update und KeepCurrent schreiben unter flock auf
+// <ordner>/catalog.lock (bleibt liegen, catalog.idx wird per rename ersetzt).
+// Ändert sich der Ordner während des Neuaufbaus, bleibt dirMtimeNs 0.
+struct CatalogHeader {
+    char magic[8];          // "C4CATLG2"
+    uint32_t entrySize;     // sizeof(CatalogEntry)
+    uint32_t reserved;
+    int64_t dirMtimeNs;
+    uint64_t count;
+};
+
+struct CatalogEntry {
+    static constexpr uint8_t LONG_NAME = 1;   // file ist nur der Anfang des Namens
+
+    char file[64];          // Dateiname ohne Ordner, NUL-terminiert
+    char players[2][32];    // gekürzt (ganze UTF-8-Zeichen), NUL-terminiert
+    int64_t timestamp;      // Änderungszeit der Logdatei (Unix-Sekunden)
+    uint64_t fileSize;
+    uint32_t movesOffset;   // Byte-Position der Zugdaten in der Logdatei
+    int8_t result;          // wie im Log: 0 Remis, 1/2 Sieg Spieler 1/2, -1 unbekannt
+    uint8_t moveCount;
+    uint8_t flags;
+    uint8_t reserved;
+};
+
+class LogCatalog {
+public:
+    static constexpr const char* FILE_NAME = "catalog.idx";
+
+    struct Filter {
+        std::string player;     // Teilstring eines Namens (ohne Groß/Klein), leer = alle
+        int result = -2;        // -2 = alle, sonst wie CatalogEntry::result
+        std::string date;       // Präfix von "JJJJ-MM-TT", leer = alle
+    };
+
+    // Öffnet den Katalog, baut ihn bei Bedarf neu auf. status: kurze Meldung
+    bool open(const std::string& folder, std::string* status = nullptr);
+    void close();
+
+    size_t size() const { return count; }
+    const CatalogEntry& entry(size_t index) const { return entries[index]; }
+    // Pfad der Logdatei; bei LONG_NAME wird der volle Name im Ordner gesucht
+    // (Anfang, Größe und Zeit passen). Leer, wenn es die Datei nicht mehr gibt
+    std::string path(const CatalogEntry& e) const;
+
+    // Indizes der passenden Einträge, neueste zuerst. Danach kostet jede
+    // Seite nur noch O(Seitengröße).
+    std::vector<uint32_t> select(const Filter& filter) const;
+
+    // "JJJJ-MM-TT HH:MM" (Ortszeit)
+    static std::string formatTime(int64_t timestamp);
+
+    // Hält den Katalog während GameLogger::save gesperrt und trägt
+    // die neue Datei danach ein – nur wenn der Katalog vorher aktuell war,
+    // sonst baut der nächste open() ohnehin neu auf.
+    class Update {
+    public:
+        explicit Update(const std::string& logFile);
+        ~Update();
+        Update(const Update&) = delete;
+        Update& operator=(const Update&) = delete;
+
+        void commit(const GameLog& game);
+
+    private:
+        std::string logFile;
+        std::string folder;
+        int lockFd = -1;
+        int fd = -1;
+        bool current = false;
+        CatalogHeader header{};
+    };
+
+    // Für Dateien im Ordner, die keine Logs sind (z.B. positions.db):
+    // Anlegen/Umbenennen ändert die Ordnerzeit. Hält den Katalog solange
+    // gesperrt und trägt am Ende die neue Zeit ein – nur wenn der Katalog
+    // vorher aktuell war
+    class KeepCurrent {
+    public:
+        explicit KeepCurrent(const std::string& folder);
+        ~KeepCurrent();
+        KeepCurrent(const KeepCurrent&) = delete;
+        KeepCurrent& operator=(const KeepCurrent&) = delete;
+
+    private:
+        std::string folder;
+        int lockFd = -1;
+        int fd = -1;
+        bool current = false;
+    };
+
+private:
+    std::string folder;
+    MappedFile file;
+    const CatalogEntry* entries = nullptr;
+    size_t count = 0;
+
+    bool map(int64_t dirMtimeNs, bool anyTime = false);
+    static bool rebuild(const std::string& folder, const MappedFile& old, size_t* added);
+};
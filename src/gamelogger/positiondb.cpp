@@ -0,0 +1,382 @@
+#include "positiondb.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gamelogger/gamelogger.h"
+#include "gamelogger/logcatalog.h"
+#include "util/util.h"
+
+using namespace std;
+
+namespace {
+    const char DB_MAGIC[8] = {'C', '4', 'P', 'O', 'S', 'D', 'B', '2'};
+
+    // Tabelle höchstens zu 2/3 voll: kurze Sondierketten auch bei Fehltreffern
+    uint64_t capacityFor(uint64_t entries) {
+        uint64_t c = 1024;
+        while (2 * c < 3 * entries) c *= 2;
+        return c;
+    }
+
+    string baseName(const string& file) {
+        size_t slash = file.find_last_of('/');
+        return slash == string::npos ? file : file.substr(slash + 1);
+    }
+
+    bool validHeader(const uint8_t* data, size_t size, PositionDbHeader& h) {
+        if (size < sizeof(PositionDbHeader)) return false;
+        memcpy(&h, data, sizeof(h));
+        return memcmp(h.magic, DB_MAGIC, sizeof(DB_MAGIC)) == 0
+            && h.rows == ROWS && h.cols == COLS && h.entrySize == sizeof(PositionEntry)
+            && h.capacity >= 1 && (h.capacity & (h.capacity - 1)) == 0 && h.count < h.capacity
+            && (size - sizeof(PositionDbHeader)) / sizeof(PositionEntry) >= h.capacity   // kein Überlauf unten
+            && size >= sizeof(PositionDbHeader) + h.capacity * sizeof(PositionEntry) + h.files * sizeof(PositionDbFile);
+    }
+
+    // Ordnerzeit eintragen, zu der alle Logs eingelesen waren
+    void stamp(const string& path, int64_t dirMtime) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        if (pwrite(fd, &dirMtime, sizeof(dirMtime), offsetof(PositionDbHeader, dirMtimeNs)) < 0) {
+            // nicht schreibbar: open() sieht dann eben wieder alle Logs an
+        }
+        ::close(fd);
+    }
+
+    const PositionDbFile* filesOf(const MappedFile& f, const PositionDbHeader& h) {
+        return reinterpret_cast<const PositionDbFile*>(f.data() + sizeof(PositionDbHeader) + h.capacity * sizeof(PositionEntry));
+    }
+
+    // Logs im Ordner gegen die eingelesenen (known): noch nicht gelesene
+    // nach fresh/paths. false = ein eingelesenes Log fehlt oder hat sich
+    // geändert, die Zähler stimmen dann nicht mehr
+    bool compareLogs(const string& folder, const PositionDbFile* known, uint64_t knownCount,
+                     vector<PositionDbFile>& fresh, vector<string>& paths) {
+        unordered_map<string, const PositionDbFile*> byName;
+        for (uint64_t i = 0; i < knownCount; ++i)
+            byName.emplace(string(known[i].name, strnlen(known[i].name, sizeof(known[i].name))), &known[i]);
+        size_t seen = 0;
+        for (const string& path : listLogFiles(folder)) {
+            struct stat st{};
+            const string name = baseName(path);
+            if (name.size() >= sizeof(PositionDbFile::name) || stat(path.c_str(), &st) != 0) continue;
+            auto it = byName.find(name);
+            if (it != byName.end()) {
+                if (it->second->mtime != static_cast<int64_t>(st.st_mtime)
+                    || it->second->size != static_cast<uint64_t>(st.st_size))
+                    return false;
+                ++seen;
+                continue;
+            }
+            PositionDbFile f{};
+            memcpy(f.name, name.data(), name.size());
+            f.mtime = static_cast<int64_t>(st.st_mtime);
+            f.size = static_cast<uint64_t>(st.st_size);
+            fresh.push_back(f);
+            paths.push_back(path);
+        }
+        return seen == byName.size();
+    }
+
+    // Sperre auf den Ordner selbst (keine zusätzliche Datei): ein Schreiber
+    // zur Zeit, auch über Prozesse hinweg
+    class FolderLock {
+    public:
+        explicit FolderLock(const string& folder) : fd(::open(folder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) {
+            if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        ~FolderLock() {
+            if (fd < 0) return;
+            flock(fd, LOCK_UN);
+            ::close(fd);
+        }
+        FolderLock(const FolderLock&) = delete;
+        FolderLock& operator=(const FolderLock&) = delete;
+
+        bool locked() const { return fd >= 0; }
+
+    private:
+        int fd;
+    };
+
+    PositionEntry emptyEntry(uint64_t key) {
+        PositionEntry e{};
+        e.key = key;
+        return e;
+    }
+
+    void add(PositionEntry& into, const PositionEntry& e) {
+        into.visits += e.visits;
+        into.wins += e.wins;
+        into.draws += e.draws;
+        into.losses += e.losses;
+        for (int c = 0; c < COLS; ++c) into.next[c] += e.next[c];
+    }
+
+    // Eintrag für key in einer offenen Tabelle (legt ihn bei Bedarf an)
+    PositionEntry& slot(vector<PositionEntry>& table, uint64_t key, uint64_t& count) {
+        const uint64_t mask = table.size() - 1;
+        for (uint64_t i = PositionDb::slotOf(key, table.size());; i = (i + 1) & mask) {
+            if (table[i].key == key) return table[i];
+            if (table[i].key == PositionDb::EMPTY) {
+                table[i] = emptyEntry(key);
+                ++count;
+                return table[i];
+            }
+        }
+    }
+
+    using Positions = unordered_map<uint64_t, PositionEntry>;
+
+    // Alle Stellungen einer Partie (Start bis Ende) in positions zählen.
+    // Spielt nur bis zum ersten ungültigen Zug bzw. bis zum Vierer
+    void addGame(const GameLog& g, Positions& positions) {
+        BitBoard b;
+        size_t i = 0;
+        while (true) {
+            bool mirrored = false;
+            const uint64_t key = b.canonicalKey(&mirrored);
+            auto it = positions.try_emplace(key, emptyEntry(key)).first;
+            PositionEntry& e = it->second;
+            ++e.visits;
+            if (g.result == 0) ++e.draws;
+            else if (g.result == 1 || g.result == 2) ++(g.result - 1 == b.currentPlayer() ? e.wins : e.losses);
+
+            if (i == g.moves.size()) break;
+            const int col = g.moves[i++].col;
+            const int player = b.currentPlayer();
+            if (b.dropDisc(col) < 0) break;
+            ++e.next[mirrored ? COLS - 1 - col : col];
+            if (b.checkWin(player) && i < g.moves.size()) {
+                // Züge nach dem Vierer gehören nicht mehr zur Partie
+                i = g.moves.size();
+            }
+        }
+    }
+}
+
+bool PositionDb::map(const string& path) {
+    PositionDbHeader h;
+    if (!file.open(path) || !validHeader(file.data(), file.size(), h)) {
+        file.close();
+        return false;
+    }
+    table = reinterpret_cast<const PositionEntry*>(file.data() + sizeof(PositionDbHeader));
+    capacity = h.capacity;
+    count = static_cast<size_t>(h.count);
+    gameCount = h.games;
+    return true;
+}
+
+bool PositionDb::open(const string& folder, string* status, ostream* progress) {
+    close();
+    const string path = folder + "/" + FILE_NAME;
+
+    // Ordner seit dem letzten Einlesen unverändert: die Logs gar nicht erst
+    // ansehen. Sonst vergleicht update() sie und liest nur, was neu ist
+    bool current = false;
+    {
+        MappedFile old;
+        PositionDbHeader h;
+        current = old.open(path) && validHeader(old.data(), old.size(), h)
+                  && h.dirMtimeNs != 0 && h.dirMtimeNs == dirMtimeNs(folder);
+    }
+    size_t added = 0;
+    if (!current) {
+        ostringstream quiet;
+        if (!update(folder, 0, progress ? *progress : quiet, &added)) {
+            if (status) *status = "Stellungsdatenbank konnte nicht geschrieben werden";
+            return false;
+        }
+    }
+    if (!map(path)) {
+        if (status) *status = "Stellungsdatenbank nicht lesbar";
+        return false;
+    }
+    if (status) {
+        *status = to_string(count) + " Stellungen aus " + to_string(gameCount) + " Partien";
+        if (added) *status += " (" + to_string(added) + " Logs neu eingelesen)";
+    }
+    return true;
+}
+
+void PositionDb::close() {
+    file.close();
+    table = nullptr;
+    capacity = 0;
+    count = 0;
+    gameCount = 0;
+}
+
+bool PositionDb::lookup(const BitBoard& board, Info& out) const {
+    if (!table) return false;
+    bool mirrored = false;
+    const uint64_t key = board.canonicalKey(&mirrored);
+    for (uint64_t i = slotOf(key, capacity);; i = (i + 1) & (capacity - 1)) {
+        const PositionEntry& e = table[i];
+        if (e.key == EMPTY) return false;
+        if (e.key != key) continue;
+        out.visits = e.visits;
+        out.wins = e.wins;
+        out.draws = e.draws;
+        out.losses = e.losses;
+        for (int c = 0; c < COLS; ++c) out.next[c] = e.next[mirrored ? COLS - 1 - c : c];
+        return true;
+    }
+}
+
+bool PositionDb::update(const string& folder, int threads, ostream& log, size_t* added) {
+    const auto t0 = chrono::steady_clock::now();
+    const string path = folder + "/" + FILE_NAME;
+
+    // Stand erst unter der Sperre lesen: wer gewartet hat, sieht die Logs
+    // des anderen Schreibers schon als eingelesen
+    FolderLock lock(folder);
+    if (!lock.locked()) return false;
+    // ändert sich der Ordner, während wir lesen, bleibt der Stempel aus
+    const int64_t before = dirMtimeNs(folder);
+
+    // bisheriger Stand: Tabelle und eingelesene Logs. Hat sich ein
+    // eingelesenes Log geändert, wird alles neu gezählt
+    MappedFile old;
+    PositionDbHeader oldHeader{};
+    bool hasOld = old.open(path) && validHeader(old.data(), old.size(), oldHeader);
+    vector<PositionDbFile> records;
+    vector<string> files;
+    if (hasOld && !compareLogs(folder, filesOf(old, oldHeader), oldHeader.files, records, files)) {
+        hasOld = false;
+        records.clear();
+        files.clear();
+    }
+    if (!hasOld) compareLogs(folder, nullptr, 0, records, files);
+    if (hasOld && files.empty()) {
+        if (oldHeader.dirMtimeNs != before && dirMtimeNs(folder) == before) stamp(path, before);
+        if (added) *added = 0;
+        log << "Stellungsdatenbank aktuell: " << oldHeader.count << " Stellungen aus " << oldHeader.games << " Partien\n";
+        return true;
+    }
+
+    // neue Logs parallel, jeder Thread zählt in eine eigene Tabelle
+    if (threads <= 0) threads = static_cast<int>(thread::hardware_concurrency());
+    threads = max(1, min(threads, static_cast<int>(files.size())));
+    log << "Stellungsdatenbank: " << files.size() << " Logs werden eingelesen"
+        << (hasOld ? "" : " (Neuaufbau)") << "...\n" << flush;
+    vector<Positions> partial(threads);
+    vector<char> ingested(files.size(), 0);
+    atomic<size_t> next{0};
+    atomic<uint64_t> games{0};
+    auto work = [&](int t) {
+        GameLog g;
+        uint64_t mine = 0;
+        for (size_t i = next++; i < files.size(); i = next++) {
+            if (!GameLogger::read(files[i], g)) continue;
+            ingested[i] = 1;
+            // andere Brettgrößen: als gelesen merken, aber nicht zählen
+            if (g.rows != 0 && (g.rows != ROWS || g.cols != COLS)) continue;
+            addGame(g, partial[t]);
+            ++mine;
+        }
+        games += mine;
+    };
+    vector<thread> helpers;
+    for (int t = 1; t < threads; ++t) helpers.emplace_back(work, t);
+    work(0);
+    for (auto& t : helpers) t.join();
+
+    Positions& merged = partial[0];
+    for (size_t t = 1; t < partial.size(); ++t) {
+        for (const auto& kv : partial[t]) {
+            auto it = merged.try_emplace(kv.first, emptyEntry(kv.first)).first;
+            add(it->second, kv.second);
+        }
+        Positions().swap(partial[t]);
+    }
+
+    // neue Tabelle: alte übernehmen (gleiche Größe: Slots bleiben gültig)
+    uint64_t count = 0;
+    const uint64_t oldCount = hasOld ? oldHeader.count : 0;
+    const uint64_t capacity = max(hasOld ? oldHeader.capacity : 0, capacityFor(oldCount + merged.size()));
+    vector<PositionEntry> table;
+    if (hasOld && capacity == oldHeader.capacity) {
+        const PositionEntry* begin = reinterpret_cast<const PositionEntry*>(old.data() + sizeof(PositionDbHeader));
+        table.assign(begin, begin + capacity);
+        count = oldCount;
+    } else {
+        table.assign(capacity, emptyEntry(EMPTY));
+        if (hasOld) {
+            const PositionEntry* begin = reinterpret_cast<const PositionEntry*>(old.data() + sizeof(PositionDbHeader));
+            for (uint64_t i = 0; i < oldHeader.capacity; ++i)
+                if (begin[i].key != EMPTY) slot(table, begin[i].key, count) = begin[i];
+        }
+    }
+    for (const auto& kv : merged) add(slot(table, kv.first, count), kv.second);
+
+    // auch unlesbare Logs gelten als erledigt, sonst würde jedes open()
+    // die Datenbank wegen ihnen neu schreiben
+    if (hasOld) {
+        const PositionDbFile* known = filesOf(old, oldHeader);
+        records.insert(records.begin(), known, known + oldHeader.files);
+    }
+
+    PositionDbHeader h{};
+    memcpy(h.magic, DB_MAGIC, sizeof(DB_MAGIC));
+    h.rows = ROWS;
+    h.cols = COLS;
+    h.entrySize = sizeof(PositionEntry);
+    h.capacity = capacity;
+    h.count = count;
+    h.games = (hasOld ? oldHeader.games : 0) + games.load();
+    h.files = records.size();
+    old.close();
+
+    // Temp-Datei und rename ändern die Ordnerzeit: catalog.idx bleibt trotzdem aktuell
+    {
+        LogCatalog::KeepCurrent catalog(folder);
+        const bool complete = dirMtimeNs(folder) == before;
+        const string tmp = path + ".tmp";
+        {
+            ofstream out(tmp, ios::binary | ios::trunc);
+            if (!out) return false;
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            out.write(reinterpret_cast<const char*>(table.data()), static_cast<streamsize>(table.size() * sizeof(PositionEntry)));
+            out.write(reinterpret_cast<const char*>(records.data()),
+                      static_cast<streamsize>(records.size() * sizeof(PositionDbFile)));
+            if (!out) return false;
+        }
+        if (rename(tmp.c_str(), path.c_str()) != 0) return false;
+        // erst jetzt: Temp-Datei und rename haben den Ordner geändert
+        if (complete) stamp(path, dirMtimeNs(folder));
+    }
+
+    const size_t newLogs = static_cast<size_t>(count_if(ingested.begin(), ingested.end(), [](char c) { return c != 0; }));
+    if (added) *added = newLogs;
+    const double seconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count() / 1e6;
+    log << newLogs << " Logs eingelesen" << (hasOld ? "" : ", Datenbank neu aufgebaut") << " ("
+        << files.size() - newLogs << " nicht lesbar, " << threads
+        << " Threads, " << fixed << setprecision(2) << seconds << " s) | " << h.count << " Stellungen aus "
+        << h.games << " Partien, " << setprecision(1) << (sizeof(h) + table.size() * sizeof(PositionEntry)) / 1048576.0
+        << " MB\n";
+    log.unsetf(ios::floatfield);
+    return true;
+}
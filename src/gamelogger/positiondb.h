@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "board/bitboard.h"
+#include "constants.h"
+#include "util/mappedfile.h"
+
+// Stellungsdatenbank eines Log-Ordners (<ordner>/positions.db, native
+// Byte-Reihenfolge, wird per mmap gelesen):
+//   PositionDbHeader
+//   PositionEntry[capacity]   Hashtabelle, offene Adressierung (linear)
+//   PositionDbFile[files]     eingelesene Logs
+// key ist BitBoard::canonicalKey(): Spiegelbilder teilen einen Eintrag,
+// next[] zählt in Spalten der kanonischen Orientierung. Nur Partien auf
+// dem Standardbrett (ROWS x COLS).
+// Neue Logs werden dazugezählt; fehlt ein eingelesenes Log oder hat es
+// sich geändert (Größe/Zeit), wird die Datenbank komplett neu aufgebaut.
+// Passt dirMtimeNs zur Ordnerzeit, öffnet open() ohne die Logs anzusehen.
+// Geschrieben wird unter flock auf den Ordner (Temp-Datei + rename);
+// catalog.idx bleibt dabei aktuell (LogCatalog::KeepCurrent).
+struct PositionDbHeader {
+    char magic[8];          // "C4POSDB2"
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t entrySize;     // sizeof(PositionEntry)
+    uint32_t reserved;
+    uint64_t capacity;      // Slots, Zweierpotenz
+    uint64_t count;         // belegte Slots
+    uint64_t games;         // eingelesene Partien
+    uint64_t files;         // Anzahl PositionDbFile am Dateiende
+    int64_t dirMtimeNs;     // Ordnerzeit, zu der alle Logs eingelesen waren (0 = unbekannt)
+};
+
+struct PositionEntry {
+    uint64_t key;           // PositionDb::EMPTY = frei
+    uint32_t visits;        // Partien, die die Stellung erreicht haben
+    uint32_t wins;          // Ausgang aus Sicht des Spielers am Zug
+    uint32_t draws;         // (Partien ohne Ergebnis zählen nur bei visits)
+    uint32_t losses;
+    uint32_t next[COLS];    // wie oft welche Spalte folgte
+    uint32_t reserved;
+};
+
+struct PositionDbFile {
+    char name[48];          // Dateiname ohne Ordner, NUL-terminiert
+    int64_t mtime;          // Änderungszeit (Unix-Sekunden)
+    uint64_t size;
+};
+
+// "Explorer": wie oft wurde eine Stellung in den Partien des Ordners
+// erreicht, wie gingen sie aus, was wurde danach gespielt
+class PositionDb {
+public:
+    static constexpr const char* FILE_NAME = "positions.db";
+    static constexpr uint64_t EMPTY = ~uint64_t(0);
+
+    // Zähler einer Stellung, next[] in Spalten des abgefragten Bretts
+    struct Info {
+        uint32_t visits = 0, wins = 0, draws = 0, losses = 0;
+        uint32_t next[COLS] = {};
+    };
+
+    // Öffnet die Datenbank; liegen neue Logs im Ordner, werden sie vorher
+    // eingelesen (update, Meldungen nach progress). status: kurze Meldung
+    bool open(const std::string& folder, std::string* status = nullptr, std::ostream* progress = nullptr);
+    void close();
+
+    bool isOpen() const { return table != nullptr; }
+    size_t size() const { return count; }
+    uint64_t games() const { return gameCount; }
+
+    // false = Stellung kam in keiner Partie vor
+    bool lookup(const BitBoard& board, Info& out) const;
+
+    // Liest alle Logs, die noch nicht in der Datenbank stehen (threads
+    // Dateien gleichzeitig, <= 0: alle Kerne), und schreibt sie neu.
+    // Bereits eingelesene Logs werden nicht noch einmal geöffnet.
+    // added = gelesene Logs. false = Datenbank nicht schreibbar
+    static bool update(const std::string& folder, int threads, std::ostream& log, size_t* added = nullptr);
+
+    // Slot, an dem die Suche nach key beginnt
+    static uint64_t slotOf(uint64_t key, uint64_t capacity) {
+        return ((key * 0x9E3779B97F4A7C15ULL) >> 16) & (capacity - 1);
+    }
+
+private:
+    MappedFile file;
+    const PositionEntry* table = nullptr;
+    uint64_t capacity = 0;
+    size_t count = 0;
+    uint64_t gameCount = 0;
+
+    bool map(const std::string& path);
+};
@@ -1,8 +1,24 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "batch/batchsolver.h"
+#include "bench/bench.h"
+#include "board/board.h"
+#include "book/openingbook.h"
 #include "gameengine/gameengine.h"
+#include "gamelogger/gamelogger.h"
+#include "gamelogger/positiondb.h"
+#include "selfplay/selfplay.h"
+#include "selfplay/tournament.h"
+#include "server/gameserver.h"
 #include "testsuite/testsuite.h"
 #include "util/util.h"
 #include "stats/stats.h"
@@ -10,8 +26,253 @@
 
 using namespace std;
 
-int main() {
-    GameEngine engine;
+namespace {
+    GameServer* g_server = nullptr;
+
+    void stopServer(int) {
+        if (g_server) g_server->stop();
+    }
+
+    void printUsage() {
+        cerr << "Aufruf: connect_four [Optionen]\n"
+             << "  --tt-mb N                 Größe der Transpositionstabelle in MB\n"
+             << "  --book DATEI              Eröffnungsbuch (Standard: " << OPENING_BOOK_PATH << ")\n"
+             << "  --book-gen DATEI PLY      Eröffnungsbuch bis Halbzug PLY erzeugen\n"
+             << "  --book-verify DATEI N     N zufällige Bucheinträge neu lösen\n"
+             << "  --solve                   Zugfolgen von stdin lösen (eine pro Zeile)\n"
+             << "  --unordered               mit --solve: Ausgabe sofort statt in Eingabereihenfolge\n"
+             << "  --selfplay N P0 P1        N Partien ohne Anzeige (random, greedy, search[:TIEFE], time[:MS], mcts[:PLAYOUTS])\n"
+             << "  --tournament N P1 P2 ...  Rundenturnier, N Partien pro Paarung mit Farbwechsel, Rangliste mit Elo\n"
+             << "  --seed N                  mit --selfplay/--tournament: Startwert (Standard: 1)\n"
+             << "  --random-plies N          mit --selfplay/--tournament: erste N Halbzüge zufällig (Standard: 0 bzw. 2)\n"
+             << "  --csv DATEI               mit --selfplay/--tournament/--serve: Statistik (Standard: logs/selfplay.csv,\n"
+             << "                            logs/tournament.csv bzw. logs/stats.csv, \"\" = keine)\n"
+             << "  --log-dir ORDNER          mit --selfplay/--serve: eine Logdatei pro Partie (--serve: Standard logs, \"\" = keine)\n"
+             << "  --serve [SOCKET]          Spielserver auf Unix-Socket (Standard: connect4.sock), Ende mit Strg+C\n"
+             << "  --convert-logs [ORDNER]   Logs (V1/V2) ins Binärformat V3 umschreiben (Standard: logs)\n"
+             << "  --verify [ORDNER]         alle Logs ohne Anzeige nachspielen und prüfen (Standard: logs)\n"
+             << "  --positions [ORDNER]      Stellungsdatenbank der Logs anlegen/um neue Logs ergänzen (Standard: logs)\n"
+             << "  --explore ZÜGE [ORDNER]   Stellung nach Zugfolge (z.B. 4453) in der Stellungsdatenbank nachschlagen\n"
+             << "  --threads N               Suchthreads (Standard: alle Kerne)\n"
+             << "  --anim-ms N               fallender Stein: ms pro Zeile (Standard: " << ANIMATION_FRAME_MS << ", 0 = sofort)\n"
+             << "  --board SxR               Brettgröße im Spiel, Spalten x Reihen (" << BOARD_SIZES << "; Standard: "
+             << COLS << "x" << ROWS << ")\n"
+             << "  --bench NAME              Messung ausführen (smp, mcts, playout, logs, stats, writer, terminal, server, board, keys,\n"
+             << "                            positions)\n"
+             << "  --test                    Test-Suite ohne Menü ausführen\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t ttMegabytes = TT_DEFAULT_MB;
+    int threads = 0;
+    int animationMs = ANIMATION_FRAME_MS;
+    int boardCols = COLS, boardRows = ROWS;
+    string bookPath = OPENING_BOOK_PATH;
+    string mode, modeFile;
+    long modeArg = 0;
+    bool ordered = true;
+    SelfPlay::Options selfPlay;
+    selfPlay.csvPath = "logs/selfplay.csv";
+    string policyNames[2];
+    GameServer::Options server;
+    Tournament::Options tournament;
+    vector<string> engineNames;
+    string explorePosition;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--tt-mb") == 0 && i + 1 < argc) {
+            ttMegabytes = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--anim-ms") == 0 && i + 1 < argc) {
+            animationMs = max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &boardCols, &boardRows) != 2) boardCols = boardRows = 0;
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            mode = argv[i];
+            modeFile = argv[++i];
+        } else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else if ((strcmp(argv[i], "--book-gen") == 0 || strcmp(argv[i], "--book-verify") == 0)
+                   && i + 2 < argc) {
+            mode = argv[i];
+            modeFile = argv[++i];
+            modeArg = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--test") == 0 || strcmp(argv[i], "--solve") == 0) {
+            mode = argv[i];
+        } else if (strcmp(argv[i], "--selfplay") == 0 && i + 3 < argc) {
+            mode = argv[i];
+            selfPlay.games = strtoll(argv[++i], nullptr, 10);
+            policyNames[0] = argv[++i];
+            policyNames[1] = argv[++i];
+        } else if (strcmp(argv[i], "--tournament") == 0 && i + 1 < argc) {
+            mode = argv[i];
+            tournament.games = strtoll(argv[++i], nullptr, 10);
+            while (i + 1 < argc && argv[i + 1][0] != '-') engineNames.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            selfPlay.seed = tournament.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--random-plies") == 0 && i + 1 < argc) {
+            selfPlay.randomPlies = tournament.randomPlies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            selfPlay.csvPath = server.csvPath = tournament.csvPath = argv[++i];
+        } else if (strcmp(argv[i], "--log-dir") == 0 && i + 1 < argc) {
+            selfPlay.logDir = server.logDir = argv[++i];
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            mode = argv[i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') server.socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--convert-logs") == 0 || strcmp(argv[i], "--verify") == 0) {
+            mode = argv[i];
+            modeFile = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "logs";
+        } else if (strcmp(argv[i], "--positions") == 0) {
+            mode = argv[i];
+            modeFile = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "logs";
+        } else if (strcmp(argv[i], "--explore") == 0 && i + 1 < argc) {
+            mode = argv[i];
+            explorePosition = argv[++i];
+            modeFile = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "logs";
+        } else if (strcmp(argv[i], "--unordered") == 0) {
+            ordered = false;
+        } else {
+            cerr << "Unbekannte Option: " << argv[i] << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (mode == "--test") {
+        TestSuite tests;
+        return tests.run() ? 0 : 1;
+    }
+    if (mode == "--solve") {
+        ios::sync_with_stdio(false);
+        BatchSolver::Options opt;
+        opt.threads = threads;
+        opt.ttMegabytes = ttMegabytes;
+        opt.bookPath = bookPath;
+        opt.ordered = ordered;
+        BatchSolver::run(cin, cout, opt);
+        return 0;
+    }
+    if (mode == "--selfplay") {
+        for (int p = 0; p < 2; ++p) {
+            if (!Policy::parse(policyNames[p], selfPlay.policies[p])) {
+                cerr << "Unbekannte Policy: " << policyNames[p] << "\n";
+                printUsage();
+                return 1;
+            }
+        }
+        selfPlay.threads = threads;
+        return SelfPlay::run(selfPlay, cout).writeFailed ? 1 : 0;
+    }
+    if (mode == "--tournament") {
+        for (const string& name : engineNames) {
+            Policy policy;
+            if (!Policy::parse(name, policy)) {
+                cerr << "Unbekannte Policy: " << name << "\n";
+                printUsage();
+                return 1;
+            }
+            tournament.engines.push_back(policy);
+        }
+        if (tournament.engines.size() < 2 || tournament.games < 1) {
+            cerr << "--tournament braucht N >= 1 und mindestens zwei Policies.\n";
+            return 1;
+        }
+        tournament.threads = threads;
+        return Tournament::run(tournament, cout).writeFailed ? 1 : 0;
+    }
+    if (mode == "--serve") {
+        GameServer gameServer(server);
+        string error;
+        if (!gameServer.listen(&error)) {
+            cerr << "Server: " << error << "\n";
+            return 1;
+        }
+        g_server = &gameServer;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        cout << "Server lauscht auf " << server.socketPath << " (Ende mit Strg+C)" << endl;
+        gameServer.run();
+        g_server = nullptr;
+        const auto& c = gameServer.counters();
+        cout << "\nVerbindungen: " << c.connections << " | Partien: " << c.gamesStarted << " begonnen, "
+             << c.gamesFinished << " beendet (" << c.timeouts << " Zeitlimit) | Züge: " << c.moves << "\n";
+        return 0;
+    }
+    if (mode == "--convert-logs") {
+        return GameLogger::convertDirectory(modeFile, cout) == 0 ? 0 : 1;
+    }
+    if (mode == "--verify") {
+        return GameLogger::verifyDirectory(modeFile, threads, cout) == 0 ? 0 : 1;
+    }
+    if (mode == "--positions") {
+        return PositionDb::update(modeFile, threads, cout) ? 0 : 1;
+    }
+    if (mode == "--explore") {
+        BitBoard board;
+        for (char ch : explorePosition) {
+            if (ch < '1' || ch > '0' + COLS || board.dropDisc(ch - '1') < 0) {
+                cerr << "Ungültige Zugfolge: " << explorePosition << "\n";
+                return 1;
+            }
+        }
+        PositionDb db;
+        string status;
+        if (!db.open(modeFile, &status)) {
+            cerr << status << "\n";
+            return 1;
+        }
+        const auto t0 = chrono::steady_clock::now();
+        PositionDb::Info info;
+        const bool found = db.lookup(board, info);
+        const long long us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count();
+        cout << status << "\n";
+        if (!found) {
+            cout << "Stellung kommt in keiner Partie vor (" << us << " µs)\n";
+            return 0;
+        }
+        cout << info.visits << " Partien, Spieler am Zug: " << info.wins << " Siege, " << info.draws << " Remis, "
+             << info.losses << " Niederlagen (" << us << " µs)\ndanach:";
+        for (int c = 0; c < COLS; ++c) cout << " " << c + 1 << ":" << info.next[c];
+        cout << "\n";
+        return 0;
+    }
+    if (mode == "--book-gen") {
+        return OpeningBook::generate(modeFile, (int)modeArg, ttMegabytes, threads, cout) ? 0 : 1;
+    }
+    if (mode == "--bench") {
+        int maxThreads = threads > 0 ? threads : (int)thread::hardware_concurrency();
+        if (modeFile == "smp") Bench::smpScaling(maxThreads > 0 ? maxThreads : 1, ttMegabytes, cout);
+        else if (modeFile == "mcts") Bench::mcts(cout);
+        else if (modeFile == "playout") Bench::playouts(cout);
+        else if (modeFile == "logs") Bench::logFormats(cout);
+        else if (modeFile == "stats") Bench::statsCsv(maxThreads > 0 ? maxThreads : 1, cout);
+        else if (modeFile == "writer") Bench::statsWriter(threads > 0 ? threads : 4, cout);
+        else if (modeFile == "terminal") Bench::terminal(cout);
+        else if (modeFile == "server") Bench::server(cout);
+        else if (modeFile == "board") Bench::boards(cout);
+        else if (modeFile == "keys") Bench::positionKeys(cout);
+        else if (modeFile == "positions") Bench::positionDb(maxThreads > 0 ? maxThreads : 1, cout);
+        else {
+            cerr << "Unbekannte Messung: " << modeFile << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (mode == "--book-verify") {
+        return OpeningBook::verify(modeFile, (int)modeArg, 2026, ttMegabytes, cout) == 0 ? 0 : 1;
+    }
+
+    // ungepuffert: die EventLoop im Spiel wartet per select() auf stdin und
+    // darf nichts übersehen, was stdio schon vorausgelesen hätte
+    setvbuf(stdin, nullptr, _IONBF, 0);
+
+    GameEngine engine(ttMegabytes, bookPath, threads, animationMs);
+    if (!engine.setBoardSize(boardRows, boardCols)) {
+        cerr << "Brettgröße nicht unterstützt (möglich: " << BOARD_SIZES << ").\n";
+        return 1;
+    }
     TestSuite tests;
 
     while (true) {
@@ -28,56 +289,46 @@ int main() {
             engine.startNewGame();
             waitEnterPlain();
         } else if (choice == 2) {
+            engine.startNewGame(OpponentType::Computer);
+            waitEnterPlain();
+        } else if (choice == 3) {
+            engine.startNewGame(OpponentType::Mcts);
+            waitEnterPlain();
+        } else if (choice == 4) {
             clearScreen();
-            auto logs = listLogFiles("logs");
-
-            if (logs.empty()) {
-                cout << "Keine Logdateien im Ordner 'logs/' gefunden.\n\n";
-                waitEnterPlain();
-                continue;
-            }
-
-            cout << "\nVerfügbare Logdateien:\n";
-            for (size_t i = 0; i < logs.size(); ++i) {
-                // schöner anzeigen ohne "logs/"
-                std::string display = logs[i];
-                if (display.rfind("logs/", 0) == 0) display = display.substr(5);
-                cout << "  " << (i + 1) << ") " << display << "\n";
-            }
-
-            cout << "\nNummer wählen (1-" << logs.size() << ") oder 0 zum Abbrechen: ";
-            int idx;
-            if (!(cin >> idx)) {
-                cout << "Ungültige Eingabe.\n";
-                clearInputLine();
-                continue;
-            }
-
-            if (idx == 0) {
-                cout << "Abgebrochen.\n\n";
-                continue;
-            }
-            if (idx < 1 || static_cast<size_t>(idx) > logs.size()) {
-                cout << "Bitte eine gültige Nummer wählen.\n\n";
-                continue;
-            }
+            const string log = GameEngine::browseLogs("logs");
+            if (log.empty()) continue;
 
-            GameEngine::replayFromFile(logs[idx - 1]);
+            GameEngine::replayFromFile(log, animationMs);
             waitEnterPlain();
-        } else if (choice == 3) {
+        } else if (choice == 5) {
             clearScreen();
             tests.run();
             waitEnterPlain();
-        } else if (choice == 4) {
+        } else if (choice == 6) {
             clearScreen();
-            auto stats = Stats::loadAggregated("logs/stats.csv");
+            CsvParseInfo info;
+            auto stats = Stats::loadAggregated("logs/stats.csv", &info);
             Stats::printReport(stats);
-            waitEnterPlain();
-        } else if (choice == 5 || choice == 0) {
+            if (info.badRows > 0) {
+                cout << info.badRows << " fehlerhafte Zeilen in logs/stats.csv übersprungen (erste bei Byte "
+                     << info.firstBadOffset << ").\n";
+            }
+            // Elo braucht die Partien pro Spielerpaar: nur auf Wunsch zählen
+            cout << "\nElo-Rangliste mit E + Enter, zurück zum Hauptmenü mit Enter...";
+            cout.flush();
+            string answer;
+            getline(cin, answer);
+            if (answer == "e" || answer == "E") {
+                stats = Stats::loadAggregated("logs/stats.csv", nullptr, 0, true);
+                Stats::printReport(stats, ReportOrder::Elo);
+                waitEnterPlain();
+            }
+        } else if (choice == 7 || choice == 0) {
             cout << "Beenden.\n";
             break;
         } else {
-            cout << "Bitte 1-5 wählen.\n";
+            cout << "Bitte 1-7 wählen.\n";
         }
     }
 
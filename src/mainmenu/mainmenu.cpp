@@ -1,93 +1,16 @@
 #include "mainmenu.h"
-#include <iostream>
 #include <unistd.h>
-#include <termios.h>
 #include <sys/select.h>
 #include <cstring>
 
-#include <clocale>
-#include <cwchar>
+#include "util/rawmode.h"
+#include "util/screen.h"
 
-using std::cout;
 using std::string;
 using std::vector;
 
-static termios g_old{};
-static bool g_hasOld = false;
-
-namespace {
-
-size_t termColsUtf8(const std::string& s) {
-    std::mbstate_t st{};
-    const char* p = s.c_str();
-    size_t cols = 0;
-
-    while (*p) {
-        wchar_t wc = 0;
-        size_t n = std::mbrtowc(&wc, p, MB_CUR_MAX, &st);
-
-        // Fallback bei kaputter Sequenz: 1 Spalte pro Byte
-        if (n == (size_t)-1 || n == (size_t)-2 || n == 0) {
-            ++cols;
-            ++p;
-            std::memset(&st, 0, sizeof(st));
-            continue;
-        }
-
-        int w = ::wcwidth(wc);
-        cols += (w < 0 ? 1 : (size_t)w);
-        p += n;
-    }
-    return cols;
-}
-
-std::string padRightCols(const std::string& s, size_t targetCols) {
-    size_t cols = termColsUtf8(s);
-    if (cols >= targetCols) return s;
-    return s + std::string(targetCols - cols, ' ');
-}
-
-} // namespace
-
-MainMenu::RawMode::RawMode() {
-    termios raw{};
-    if (tcgetattr(STDIN_FILENO, &g_old) == 0) {
-        g_hasOld = true;
-        raw = g_old;
-
-        // Raw-ish mode (no echo, no canonical line buffering)
-        raw.c_lflag &= ~(ECHO | ICANON);
-        raw.c_cc[VMIN]  = 0; // non-blocking read with timeout via select
-        raw.c_cc[VTIME] = 0;
-
-        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) {
-            enabled = true;
-        }
-    }
-}
-
-MainMenu::RawMode::~RawMode() {
-    if (enabled && g_hasOld) {
-        tcsetattr(STDIN_FILENO, TCSANOW, &g_old);
-    }
-}
-
-void MainMenu::clearScreen() {
-    // Clear + home (no colors)
-    cout << "\033[2J\033[H";
-}
-
-void MainMenu::render(const vector<string>& items, int selected) {
-    // Locale einmal setzen, damit mbrtowc/wcwidth korrekt arbeiten
-    static bool localeSet = false;
-    if (!localeSet) {
-        std::setlocale(LC_CTYPE, "");
-        localeSet = true;
-    }
-
-    clearScreen();
-
-    const char* logo[] = {
+void MainMenu::draw(Screen& screen, const vector<string>& items, int selected) {
+    static const char* logo[] = {
         "  ██╗  ██╗     ██████╗ ███████╗██╗    ██╗██╗███╗   ██╗███╗   ██╗████████╗",
         "  ██║  ██║    ██╔════╝ ██╔════╝██║    ██║██║████╗  ██║████╗  ██║╚══██╔══╝",
         "  ███████║    ██║  ███╗█████╗  ██║ █╗ ██║██║██╔██╗ ██║██╔██╗ ██║   ██║   ",
@@ -96,32 +19,29 @@ void MainMenu::render(const vector<string>& items, int selected) {
         "       ╚═╝     ╚═════╝ ╚══════╝ ╚══╝╚══╝ ╚═╝╚═╝  ╚═══╝╚═╝  ╚═══╝   ╚═╝   ",
     };
 
-    cout << "\n";
-    for (auto* line : logo) cout << line << "\n";
-    cout << "\n";
-
-    // Box Layout mit fester Breite, damit es nicht bei langen Menüeinträgen zerfetzt wird
-    constexpr size_t CONTENT_WIDTH = 50;
-
-    cout << "  ┌────────────────────────────────────────────────────┐\n";
-    {
-        const string header = "Navigation:  ↑/↓  |  Enter = OK  |  ESC/q = Zurück";
-        cout << "  │ " << padRightCols(header, CONTENT_WIDTH) << " │\n";
-    }
-    cout << "  ├────────────────────────────────────────────────────┤\n";
+    screen.clear();
+    int row = 1;
+    for (auto* line : logo) screen.text(row++, 0, line);
+    ++row;
+
+    // Box mit fester Breite: der rechte Rand steht in einer festen Spalte,
+    // lange Einträge werden davor abgeschnitten
+    constexpr int CONTENT_WIDTH = 50;
+    constexpr int RIGHT = 4 + CONTENT_WIDTH + 1;
+    auto boxLine = [&](const string& content) {
+        screen.text(row, 0, "  │ ");
+        int end = screen.text(row, 4, content, RIGHT - 1);
+        for (int c = end; c < RIGHT; ++c) screen.text(row, c, " ");
+        screen.text(row++, RIGHT, "│");
+    };
 
+    screen.text(row++, 0, "  ┌────────────────────────────────────────────────────┐");
+    boxLine("Navigation:  ↑/↓  |  Enter = OK  |  ESC/q = Zurück");
+    screen.text(row++, 0, "  ├────────────────────────────────────────────────────┤");
     for (int i = 0; i < (int)items.size(); ++i) {
-        if (i == selected) {
-            string line = "> [" + items[i] + "]";
-            cout << "  │ " << padRightCols(line, CONTENT_WIDTH) << " │\n";
-        } else {
-            string line = "  " + items[i];
-            cout << "  │ " << padRightCols(line, CONTENT_WIDTH) << " │\n";
-        }
+        boxLine(i == selected ? "> [" + items[i] + "]" : "  " + items[i]);
     }
-
-    cout << "  └────────────────────────────────────────────────────┘\n";
-    cout.flush();
+    screen.text(row++, 0, "  └────────────────────────────────────────────────────┘");
 }
 
 MainMenu::Key MainMenu::readKey() {
@@ -160,30 +80,43 @@ MainMenu::Key MainMenu::readKey() {
     return Key::Other;
 }
 
-int MainMenu::show() {
-    RawMode rm; // aktiviert raw mode, wird am Ende automatisch zurückgesetzt
-
-    vector<string> items = {
+vector<string> MainMenu::entries() {
+    return {
         "Neues Spiel starten",
+        "Spieler vs. Computer",
+        "Spieler vs. Computer (MCTS)",
         "Spiel aus Logdatei wiederholen",
         "Tests ausführen",
         "Statistiken anzeigen",
         "Beenden"
     };
+}
 
+int MainMenu::show() {
+    RawMode rm; // aktiviert raw mode, wird am Ende automatisch zurückgesetzt
+
+    const vector<string> items = entries();
+
+    // Frame immer komplett zeichnen; ausgegeben werden nur die geänderten Zellen
+    // (bei Pfeiltasten also die zwei betroffenen Menüzeilen)
+    Screen& screen = Screen::terminal();
     int selected = 0;
-    render(items, selected);
+    auto render = [&]() {
+        draw(screen, items, selected);
+        screen.present();
+    };
+    render();
 
     while (true) {
         Key k = readKey();
         switch (k) {
             case Key::Up:
                 selected = (selected - 1 + (int)items.size()) % (int)items.size();
-                render(items, selected);
+                render();
                 break;
             case Key::Down:
                 selected = (selected + 1) % (int)items.size();
-                render(items, selected);
+                render();
                 break;
             case Key::Enter:
                 return selected + 1;   // 1..N
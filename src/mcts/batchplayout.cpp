@@ -0,0 +1,282 @@
+#include "batchplayout.h"
+
+#include "util/rng.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define HAS_X86_SIMD 1
+#else
+  #define HAS_X86_SIMD 0
+#endif
+
+using namespace std;
+
+namespace {
+    constexpr int LANES = BatchPlayout::LANES;
+    constexpr int CELLS = ROWS * COLS;
+    constexpr int H1 = BitBoard::H1;
+    constexpr uint64_t COL0 = (uint64_t(1) << ROWS) - 1;
+
+    // Zustand aller Lanes; wird zwischen Kernel und skalarer Verwaltung geteilt
+    struct Lanes {
+        alignas(32) uint64_t current[LANES]; // Steine des Spielers am Zug
+        alignas(32) uint64_t mask[LANES];
+        alignas(32) uint64_t moves[LANES];   // absolute Anzahl Steine
+        alignas(32) uint64_t rng[LANES];
+        alignas(32) uint64_t active[LANES];  // ~0 = Partie läuft
+    };
+
+    // Verwaltung außerhalb der Vektorschleife: Startstellung, Ergebnisse,
+    // Neubelegung fertiger Lanes
+    struct Driver {
+        uint64_t startCurrent, startMask, startMoves;
+        long long games;
+        long long started = 0;
+        int running = 0;
+        BatchPlayout::Totals totals;
+        BatchPlayout::Record* record;
+
+        Driver(const BitBoard& start, long long games, BatchPlayout::Record* record)
+            : startCurrent(start.currentMask()), startMask(start.occupiedMask()),
+              startMoves(static_cast<uint64_t>(start.moveCount())), games(games), record(record) {}
+
+        void init(Lanes& l, uint64_t seed) {
+            for (int i = 0; i < LANES; ++i) {
+                l.rng[i] = splitmix64(seed + static_cast<uint64_t>(i)) | 1;
+                l.active[i] = 0;
+                l.current[i] = startCurrent;
+                l.mask[i] = startMask;
+                l.moves[i] = startMoves;
+                startLane(l, i);
+            }
+        }
+
+        void startLane(Lanes& l, int i) {
+            if (started >= games || (record && started >= LANES)) {
+                l.active[i] = 0;
+                return;
+            }
+            ++started;
+            ++running;
+            l.active[i] = ~uint64_t(0);
+            l.current[i] = startCurrent;
+            l.mask[i] = startMask;
+            l.moves[i] = startMoves;
+        }
+
+        // winner: 0/1, -1 = Remis
+        void finish(Lanes& l, int i, int winner) {
+            ++totals.games;
+            totals.moves += static_cast<long long>(l.moves[i] - startMoves);
+            if (winner < 0) ++totals.draws;
+            else ++totals.wins[winner];
+            if (record) record->results[i] = winner + 1;
+            --running;
+            startLane(l, i);
+        }
+
+        void recordMove(int lane, uint64_t col) {
+            if (record) record->moves[lane].push_back(static_cast<int>(col));
+        }
+    };
+
+    // --- skalar -----------------------------------------------------------
+
+    void runScalar(Lanes& l, Driver& d) {
+        while (d.running > 0) {
+            for (int i = 0; i < LANES; ++i) {
+                uint64_t x = l.rng[i];
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                l.rng[i] = x;
+                const uint64_t col = ((x >> 32) * COLS) >> 32;
+
+                const uint64_t possible = (l.mask[i] + BitBoard::BOTTOM_ROW) & BitBoard::BOARD_MASK;
+                const uint64_t move = possible & (COL0 << (col * H1)) & l.active[i];
+                if (!move) continue;
+
+                d.recordMove(i, col);
+                const uint64_t pos = l.current[i] | move;
+                l.mask[i] |= move;
+                l.moves[i]++;
+                l.current[i] = pos ^ l.mask[i];
+                if (BitBoard::hasAlignment(pos)) d.finish(l, i, static_cast<int>((l.moves[i] - 1) & 1));
+                else if (l.moves[i] == CELLS) d.finish(l, i, -1);
+            }
+        }
+    }
+
+    // --- AVX2 -------------------------------------------------------------
+
+#if HAS_X86_SIMD
+    constexpr int GROUPS = LANES / 4;
+
+    // Lane-Zustand in Registern (Übergabe per Referenz: keine AVX-Werte an
+    // Funktionsgrenzen, die ohne AVX übersetzt werden)
+    struct Regs {
+        __m256i cur[GROUPS], msk[GROUPS], mv[GROUPS], rng[GROUPS], act[GROUPS];
+    };
+
+    __attribute__((target("avx2")))
+    inline void load(const Lanes& l, Regs& r) {
+        for (int g = 0; g < GROUPS; ++g) {
+            r.cur[g] = _mm256_load_si256(reinterpret_cast<const __m256i*>(l.current + 4 * g));
+            r.msk[g] = _mm256_load_si256(reinterpret_cast<const __m256i*>(l.mask + 4 * g));
+            r.mv[g]  = _mm256_load_si256(reinterpret_cast<const __m256i*>(l.moves + 4 * g));
+            r.rng[g] = _mm256_load_si256(reinterpret_cast<const __m256i*>(l.rng + 4 * g));
+            r.act[g] = _mm256_load_si256(reinterpret_cast<const __m256i*>(l.active + 4 * g));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    inline void store(const Regs& r, Lanes& l) {
+        for (int g = 0; g < GROUPS; ++g) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(l.current + 4 * g), r.cur[g]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(l.mask + 4 * g), r.msk[g]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(l.moves + 4 * g), r.mv[g]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(l.rng + 4 * g), r.rng[g]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(l.active + 4 * g), r.act[g]);
+        }
+    }
+
+    // wie BitBoard::hasAlignment, Ergebnis ~0 pro Lane mit Vierer-Reihe
+    __attribute__((target("avx2")))
+    inline void alignment(const __m256i& pos, __m256i& out) {
+        __m256i m, any;
+        m = _mm256_and_si256(pos, _mm256_srli_epi64(pos, H1));
+        any = _mm256_and_si256(m, _mm256_srli_epi64(m, 2 * H1));
+        m = _mm256_and_si256(pos, _mm256_srli_epi64(pos, H1 + 1));
+        any = _mm256_or_si256(any, _mm256_and_si256(m, _mm256_srli_epi64(m, 2 * (H1 + 1))));
+        m = _mm256_and_si256(pos, _mm256_srli_epi64(pos, H1 - 1));
+        any = _mm256_or_si256(any, _mm256_and_si256(m, _mm256_srli_epi64(m, 2 * (H1 - 1))));
+        m = _mm256_and_si256(pos, _mm256_srli_epi64(pos, 1));
+        any = _mm256_or_si256(any, _mm256_and_si256(m, _mm256_srli_epi64(m, 2)));
+        const __m256i zero = _mm256_setzero_si256();
+        out = _mm256_xor_si256(_mm256_cmpeq_epi64(any, zero), _mm256_cmpeq_epi64(zero, zero));
+    }
+
+    __attribute__((target("avx2")))
+    void runAvx2(Lanes& l, Driver& d) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ones = _mm256_cmpeq_epi64(zero, zero);
+        const __m256i bottom = _mm256_set1_epi64x(static_cast<long long>(BitBoard::BOTTOM_ROW));
+        const __m256i board = _mm256_set1_epi64x(static_cast<long long>(BitBoard::BOARD_MASK));
+        const __m256i col0 = _mm256_set1_epi64x(static_cast<long long>(COL0));
+        const __m256i cols = _mm256_set1_epi64x(COLS);
+        const __m256i h1 = _mm256_set1_epi64x(H1);
+        const __m256i cells = _mm256_set1_epi64x(CELLS);
+
+        Regs r;
+        load(l, r);
+        alignas(32) uint64_t winLanes[LANES], drawLanes[LANES], colLanes[LANES], validLanes[LANES];
+        while (d.running > 0) {
+            __m256i fin = zero;
+            __m256i win[GROUPS], draw[GROUPS], col[GROUPS], valid[GROUPS];
+            for (int g = 0; g < GROUPS; ++g) {
+                __m256i x = r.rng[g];
+                x = _mm256_xor_si256(x, _mm256_slli_epi64(x, 13));
+                x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 7));
+                x = _mm256_xor_si256(x, _mm256_slli_epi64(x, 17));
+                r.rng[g] = x;
+                // mul_epu32 nimmt die unteren 32 Bit: (x >> 32) * COLS >> 32
+                col[g] = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), cols), 32);
+
+                const __m256i possible = _mm256_and_si256(_mm256_add_epi64(r.msk[g], bottom), board);
+                const __m256i colMask = _mm256_sllv_epi64(col0, _mm256_mul_epu32(col[g], h1));
+                const __m256i move = _mm256_and_si256(_mm256_and_si256(possible, colMask), r.act[g]);
+                valid[g] = _mm256_xor_si256(_mm256_cmpeq_epi64(move, zero), ones);
+
+                const __m256i pos = _mm256_or_si256(r.cur[g], move);
+                r.msk[g] = _mm256_or_si256(r.msk[g], move);
+                r.mv[g] = _mm256_sub_epi64(r.mv[g], valid[g]); // valid = -1 => +1
+                r.cur[g] = _mm256_blendv_epi8(r.cur[g], _mm256_xor_si256(pos, r.msk[g]), valid[g]);
+
+                __m256i aligned;
+                alignment(pos, aligned);
+                win[g] = _mm256_and_si256(aligned, valid[g]);
+                draw[g] = _mm256_andnot_si256(win[g], _mm256_and_si256(valid[g], _mm256_cmpeq_epi64(r.mv[g], cells)));
+                fin = _mm256_or_si256(fin, _mm256_or_si256(win[g], draw[g]));
+            }
+
+            if (d.record) {
+                for (int g = 0; g < GROUPS; ++g) {
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(colLanes + 4 * g), col[g]);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(validLanes + 4 * g), valid[g]);
+                }
+                for (int i = 0; i < LANES; ++i)
+                    if (validLanes[i]) d.recordMove(i, colLanes[i]);
+            }
+
+            if (_mm256_testz_si256(fin, fin)) continue;
+
+            // selten: Ergebnisse skalar verbuchen, Lanes neu belegen
+            store(r, l);
+            for (int g = 0; g < GROUPS; ++g) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(winLanes + 4 * g), win[g]);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(drawLanes + 4 * g), draw[g]);
+            }
+            for (int i = 0; i < LANES; ++i) {
+                if (winLanes[i]) d.finish(l, i, static_cast<int>((l.moves[i] - 1) & 1));
+                else if (drawLanes[i]) d.finish(l, i, -1);
+            }
+            load(l, r);
+        }
+        store(r, l);
+    }
+#endif
+
+    BatchPlayout::Kernel resolve(BatchPlayout::Kernel kernel) {
+        if (kernel == BatchPlayout::Kernel::Auto)
+            return BatchPlayout::avx2Available() ? BatchPlayout::Kernel::Avx2 : BatchPlayout::Kernel::Scalar;
+        if (kernel == BatchPlayout::Kernel::Avx2 && !BatchPlayout::avx2Available())
+            return BatchPlayout::Kernel::Scalar;
+        return kernel;
+    }
+
+    BatchPlayout::Totals runKernel(const BitBoard& start, long long games, uint64_t seed,
+                                   BatchPlayout::Kernel kernel, BatchPlayout::Record* record) {
+        Lanes lanes;
+        Driver driver(start, games, record);
+        driver.init(lanes, seed);
+    #if HAS_X86_SIMD
+        if (resolve(kernel) == BatchPlayout::Kernel::Avx2) {
+            runAvx2(lanes, driver);
+            return driver.totals;
+        }
+    #else
+        (void)kernel;
+    #endif
+        runScalar(lanes, driver);
+        return driver.totals;
+    }
+}
+
+bool BatchPlayout::avx2Available() {
+#if HAS_X86_SIMD
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+const char* BatchPlayout::kernelName(Kernel kernel) {
+    switch (resolve(kernel)) {
+        case Kernel::Avx2: return "AVX2";
+        default: return "skalar";
+    }
+}
+
+BatchPlayout::Totals BatchPlayout::run(const BitBoard& start, long long games, uint64_t seed,
+                                       Kernel kernel) {
+    return runKernel(start, games, seed, kernel, nullptr);
+}
+
+BatchPlayout::Totals BatchPlayout::runRecorded(const BitBoard& start, uint64_t seed, Kernel kernel,
+                                               Record& record) {
+    for (int i = 0; i < LANES; ++i) {
+        record.moves[i].clear();
+        record.results[i] = -1;
+    }
+    return runKernel(start, LANES, seed, kernel, &record);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "board/bitboard.h"
+
+// Zufallspartien im Gleichschritt: LANES unabhängige Partien liegen in
+// Vektorregistern (je ein 64-Bit-Wert pro Partie und Feld), jede Runde
+// zieht jede Partie einmal. Zugwahl per Verwerfen: Zufallsspalte 0..COLS-1,
+// ist sie voll, setzt die Partie diese Runde aus (gleichverteilt über die
+// legalen Spalten, ohne Bitzählen pro Partie). Fertige Partien werden
+// sofort mit der Startstellung neu belegt, bis alle gespielt sind.
+//
+// Zwei Implementierungen mit identischer Arithmetik (gleicher Seed =>
+// gleiche Partien): AVX2 (zur Laufzeit gewählt) und skalar.
+class BatchPlayout {
+public:
+    static constexpr int LANES = 8;  // zwei AVX2-Register pro Feld
+
+    enum class Kernel { Auto, Scalar, Avx2 };
+
+    struct Totals {
+        long long games = 0;
+        long long wins[2] = {0, 0};  // nach Spielerindex (0 = Anziehender)
+        long long draws = 0;
+        long long moves = 0;         // gesetzte Steine ab der Startstellung
+    };
+
+    // Pro Lane mitgeschriebene Partie (nur für Tests/Analyse, langsamer)
+    struct Record {
+        std::vector<int> moves[LANES];  // Spalten 0..COLS-1
+        int results[LANES];             // 0 Remis, 1/2 Sieg Spieler 0/1 (wie in den Logs)
+    };
+
+    // CPU kann AVX2 und das Programm wurde für x86 gebaut
+    static bool avx2Available();
+    static const char* kernelName(Kernel kernel);
+
+    // Spielt games Zufallspartien ab start (offene Stellung)
+    static Totals run(const BitBoard& start, long long games, uint64_t seed,
+                      Kernel kernel = Kernel::Auto);
+
+    // Genau eine Partie pro Lane, Züge werden mitgeschrieben
+    static Totals runRecorded(const BitBoard& start, uint64_t seed, Kernel kernel, Record& record);
+};
@@ -0,0 +1,218 @@
+#include "mcts.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "util/rng.h"
+
+using namespace std;
+
+namespace {
+    constexpr int CELLS = ROWS * COLS;
+
+    // Explorationskonstante für UCT (Gewinne liegen in [0, 1])
+    constexpr float UCT_C = 1.41421356f;
+
+    // Wie oft (in Playouts) die Uhr geprüft wird
+    constexpr long long CLOCK_CHECK_MASK = 127;
+
+    constexpr size_t MIN_NODES = 64;
+}
+
+Mcts::Mcts(size_t megabytes, uint64_t seed) : rng(splitmix64(seed) | 1) {
+    nodeCapacity = megabytes * 1024 * 1024 / (2 * sizeof(Node));
+    if (nodeCapacity < MIN_NODES) nodeCapacity = MIN_NODES;
+    if (nodeCapacity > UINT32_MAX) nodeCapacity = UINT32_MAX;
+    // bewusst ohne Initialisierung: das System belegt Seiten erst beim ersten Schreiben
+    arenas[0].reset(new Node[nodeCapacity]);
+    arenas[1].reset(new Node[nodeCapacity]);
+}
+
+void Mcts::clear() {
+    hasTree = false;
+    used = 0;
+}
+
+// Sucht die Stellung key unterhalb von index (höchstens depth Züge tiefer).
+// 0 = nicht gefunden (die Wurzel ist nie ein Nachfahre)
+uint32_t Mcts::findDescendant(uint32_t index, const BitBoard& at, uint64_t key, int depth) {
+    const Node& n = nodes()[index];
+    if (depth == 0 || n.firstChild == 0) return 0;
+    for (uint32_t i = n.firstChild; i < n.firstChild + n.childCount; ++i) {
+        BitBoard b = at;
+        b.dropDisc(nodes()[i].move);
+        if (b.key() == key) return i;
+        if (depth > 1) {
+            uint32_t r = findDescendant(i, b, key, depth - 1);
+            if (r) return r;
+        }
+    }
+    return 0;
+}
+
+// Kopiert den Teilbaum in Breitensuche-Reihenfolge in die andere Hälfte.
+// Die Zielhälfte dient dabei selbst als Warteschlange.
+void Mcts::compactInto(uint32_t subtreeRoot) {
+    const Node* src = nodes();
+    Node* dst = arenas[1 - active].get();
+    dst[0] = src[subtreeRoot];
+    size_t n = 1;
+    for (size_t i = 0; i < n; ++i) {
+        Node& d = dst[i];
+        if (d.firstChild == 0) continue;
+        const uint32_t from = d.firstChild;
+        d.firstChild = static_cast<uint32_t>(n);
+        memcpy(dst + n, src + from, d.childCount * sizeof(Node));
+        n += d.childCount;
+    }
+    active = 1 - active;
+    used = n;
+}
+
+// Letzter Zug war unser eigener, danach hat der Gegner gezogen: die neue
+// Stellung liegt also meist zwei Ebenen unter der alten Wurzel
+bool Mcts::reuse(const BitBoard& board) {
+    if (!hasTree) return false;
+    if (rootBoard.key() == board.key()) return true;
+    uint32_t idx = findDescendant(0, rootBoard, board.key(), 2);
+    if (idx == 0) return false;
+    compactInto(idx);
+    rootBoard = board;
+    return true;
+}
+
+// Kinder anlegen: nur der Gewinnzug, falls es einen gibt, sonst alle Züge,
+// die nicht sofort verlieren (oder alle, wenn jeder verliert)
+void Mcts::expand(uint32_t index, const BitBoard& board) {
+    if (used + COLS > nodeCapacity) return; // Arena voll: Blatt bleibt Blatt
+
+    const uint64_t possible = board.possibleMask();
+    const uint64_t win = board.threatCells(board.currentPlayer()) & possible;
+    uint64_t moves;
+    if (win) {
+        moves = win & (0 - win); // ein Gewinnzug reicht
+    } else {
+        uint64_t safe = board.nonLosingMoves();
+        moves = safe ? safe : possible;
+    }
+    const uint8_t term = win ? TERM_WIN : (board.moveCount() + 1 == CELLS ? TERM_DRAW : TERM_NONE);
+
+    Node* arena = nodes();
+    const uint32_t first = static_cast<uint32_t>(used);
+    uint8_t count = 0;
+    for (int c = 0; c < COLS; ++c) {
+        if (!(moves & BitBoard::columnMask(c))) continue;
+        arena[used++] = Node{0, 0, 0.0f, static_cast<uint8_t>(c), 0, term, 0};
+        ++count;
+    }
+    arena[index].firstChild = first;
+    arena[index].childCount = count;
+}
+
+// Leicht gelenkter Playout. Rückgabe: Gewinner (0/1) oder -1 bei Remis
+int Mcts::playout(BitBoard board) {
+    while (true) {
+        if (board.isFull()) return -1;
+        const int p = board.currentPlayer();
+        if (board.canWinNext()) return p;
+        uint64_t safe = board.nonLosingMoves();
+        if (safe == 0) return 1 - p; // jeder Zug lässt den Gegner gewinnen
+        board.dropDisc(randomBitIndex(safe, rng) / BitBoard::H1);
+    }
+}
+
+MctsResult Mcts::search(const BitBoard& board, long long budgetMs, long long maxPlayouts) {
+    using Clock = chrono::steady_clock;
+    const auto t0 = Clock::now();
+    const auto deadline = t0 + chrono::milliseconds(budgetMs);
+
+    MctsResult res;
+    res.arenaBytes = 2 * nodeCapacity * sizeof(Node);
+    if (board.isFull()) return res;
+
+    if (!reuse(board)) {
+        used = 1;
+        nodes()[0] = Node{0, 0, 0.0f, 0, 0, TERM_NONE, 0};
+        rootBoard = board;
+        hasTree = true;
+    }
+    res.reusedVisits = nodes()[0].visits;
+    if (nodes()[0].firstChild == 0) expand(0, board);
+
+    const int rootPlayer = board.currentPlayer();
+    uint32_t path[CELLS + 1];
+
+    // Nur ein sinnvoller Zug (Gewinn oder erzwungener Block): nichts zu suchen
+    while (nodes()[0].childCount > 1) {
+        if ((res.playouts & CLOCK_CHECK_MASK) == 0 && budgetMs > 0 && Clock::now() >= deadline) break;
+        if (maxPlayouts > 0 && res.playouts >= maxPlayouts) break;
+        if (budgetMs <= 0 && maxPlayouts <= 0) break;
+
+        // Selektion (UCT) bis zu einem Blatt
+        Node* arena = nodes();
+        BitBoard b = board;
+        int depth = 0;
+        uint32_t idx = 0;
+        path[depth++] = 0;
+        while (arena[idx].firstChild != 0) {
+            const Node& parent = arena[idx];
+            const float logN = logf(static_cast<float>(parent.visits));
+            uint32_t best = parent.firstChild;
+            float bestValue = -1.0f;
+            for (uint32_t i = parent.firstChild; i < parent.firstChild + parent.childCount; ++i) {
+                const Node& c = arena[i];
+                if (c.visits == 0) { best = i; break; }
+                float value = c.wins / c.visits + UCT_C * sqrtf(logN / c.visits);
+                if (value > bestValue) { bestValue = value; best = i; }
+            }
+            idx = best;
+            b.dropDisc(arena[idx].move);
+            path[depth++] = idx;
+        }
+
+        // Expansion: erst beim zweiten Besuch, das spart Knoten für Blätter,
+        // die nie wieder gewählt werden
+        if (arena[idx].terminal == TERM_NONE && arena[idx].visits > 0) {
+            expand(idx, b);
+            if (arena[idx].firstChild != 0) {
+                idx = arena[idx].firstChild;
+                b.dropDisc(arena[idx].move);
+                path[depth++] = idx;
+            }
+        }
+
+        // Simulation
+        int winner;
+        if (arena[idx].terminal == TERM_WIN) winner = 1 - b.currentPlayer();
+        else if (arena[idx].terminal == TERM_DRAW) winner = -1;
+        else winner = playout(b);
+
+        // Rückpropagierung: Knoten k wurde von Spieler (rootPlayer + k + 1) & 1 erreicht
+        for (int k = 0; k < depth; ++k) {
+            Node& n = arena[path[k]];
+            ++n.visits;
+            if (winner < 0) n.wins += 0.5f;
+            else if (winner == ((rootPlayer + k + 1) & 1)) n.wins += 1.0f;
+        }
+        ++res.playouts;
+    }
+
+    // Zug mit den meisten Besuchen (robuster als die beste Quote)
+    const Node& root = nodes()[0];
+    uint32_t best = root.firstChild;
+    for (uint32_t i = root.firstChild; i < root.firstChild + root.childCount; ++i) {
+        if (nodes()[i].visits > nodes()[best].visits) best = i;
+    }
+    if (root.childCount > 0) {
+        const Node& b = nodes()[best];
+        res.bestMove = b.move;
+        res.winRate = b.terminal == TERM_WIN ? 1.0 : (b.visits ? b.wins / b.visits : 0.5);
+    }
+
+    if (used > peakUsed) peakUsed = used;
+    res.nodes = used;
+    res.peakBytes = peakUsed * sizeof(Node);
+    res.micros = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count();
+    return res;
+}
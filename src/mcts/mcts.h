@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "board/bitboard.h"
+#include "constants.h"
+
+struct MctsResult {
+    int bestMove = -1;
+    double winRate = 0.0;         // geschätzte Gewinnchance des Spielers am Zug
+    long long playouts = 0;
+    long long reusedVisits = 0;   // Besuche, die aus dem letzten Zug übernommen wurden
+    long long micros = 0;
+    size_t nodes = 0;             // belegte Knoten nach der Suche
+    size_t peakBytes = 0;         // größter bisher belegter Teil der Arena
+    size_t arenaBytes = 0;        // reservierte Arena (beide Hälften)
+
+    double playoutsPerSecond() const { return micros > 0 ? playouts * 1e6 / micros : 0.0; }
+};
+
+// Monte-Carlo-Baumsuche (UCT) mit leicht gelenkten Playouts: wer sofort
+// gewinnen kann, tut es; sonst zufällig, aber nicht unter eine gegnerische
+// Drohung. Die Knoten liegen in einer vorab reservierten Arena (Indizes
+// statt Zeigern), eine Suche macht also keine einzige Heap-Allokation.
+//
+// Zwischen zwei Zügen wird der Teilbaum der tatsächlich entstandenen
+// Stellung weiterverwendet: er wird in die zweite Arena-Hälfte kopiert
+// (kompakt, ohne die Geschwister), danach tauschen die Hälften.
+class Mcts {
+public:
+    explicit Mcts(size_t megabytes = MCTS_DEFAULT_MB, uint64_t seed = 1);
+
+    // Suche bis budgetMs (Wanduhr) oder maxPlayouts (> 0), je nachdem was
+    // zuerst erreicht ist. Reproduzierbar nur mit maxPlayouts und budgetMs <= 0.
+    MctsResult search(const BitBoard& board, long long budgetMs, long long maxPlayouts = 0);
+
+    // Baum verwerfen (z.B. bei neuer Partie)
+    void clear();
+
+    size_t capacity() const { return nodeCapacity; }
+
+private:
+    struct Node {
+        uint32_t firstChild;  // Kinder liegen zusammenhängend; 0 = nicht expandiert
+        uint32_t visits;
+        float wins;           // aus Sicht des Spielers, der den Zug gemacht hat
+        uint8_t move;         // Spalte, die zu diesem Knoten führt
+        uint8_t childCount;
+        uint8_t terminal;     // TERM_NONE / TERM_WIN (für den Ziehenden) / TERM_DRAW
+        uint8_t pad;
+    };
+    static_assert(sizeof(Node) == 16, "Node sollte 16 Byte groß sein");
+
+    static constexpr uint8_t TERM_NONE = 0;
+    static constexpr uint8_t TERM_WIN = 1;
+    static constexpr uint8_t TERM_DRAW = 2;
+
+    std::unique_ptr<Node[]> arenas[2];
+    int active = 0;               // Hälfte mit dem aktuellen Baum
+    size_t nodeCapacity = 0;      // pro Hälfte
+    size_t used = 0;
+    size_t peakUsed = 0;
+    bool hasTree = false;
+    BitBoard rootBoard;
+    uint64_t rng;
+
+    Node* nodes() { return arenas[active].get(); }
+    bool reuse(const BitBoard& board);
+    uint32_t findDescendant(uint32_t index, const BitBoard& at, uint64_t key, int depth);
+    void compactInto(uint32_t subtreeRoot);
+    void expand(uint32_t index, const BitBoard& board);
+    int playout(BitBoard board);
+};
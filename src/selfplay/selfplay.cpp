@@ -0,0 +1,284 @@
+#include "selfplay.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "gamelogger/gamelogger.h"
+#include "mcts/mcts.h"
+#include "solver/solver.h"
+#include "stats/stats.h"
+#include "stats/statswriter.h"
+#include "util/rng.h"
+
+#if __has_include(<filesystem>)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+  #define HAS_FILESYSTEM 1
+#else
+  #define HAS_FILESYSTEM 0
+#endif
+
+using namespace std;
+
+namespace {
+    // Partien pro Arbeitspaket; die Statistik wird paketweise geschrieben
+    constexpr long long CHUNK = 4096;
+
+    // Zufällige Spalte aus einer Feldmaske (höchstens ein Bit pro Spalte)
+    int randomColumn(uint64_t cells, uint64_t& rng) {
+        return randomBitIndex(cells, rng) / BitBoard::H1;
+    }
+
+    // Arena der Mcts-Policy pro Partie und Spieler; beschrieben wird nur, was der Baum belegt
+    constexpr size_t MCTS_GAME_MB = 8;
+
+    // Zahl hinter "name:" (ohne ":" bleibt value unverändert); false wenn ungültig
+    bool parseSuffix(const string& text, size_t nameLength, long long maxValue, long long& value) {
+        if (text.size() == nameLength) return true;
+        if (text[nameLength] != ':' || text.size() == nameLength + 1) return false;
+        long long v = 0;
+        for (size_t i = nameLength + 1; i < text.size(); ++i) {
+            if (text[i] < '0' || text[i] > '9' || v > maxValue) return false;
+            v = v * 10 + (text[i] - '0');
+        }
+        if (v < 1 || v > maxValue) return false;
+        value = v;
+        return true;
+    }
+
+    void createDirectories(const string& path) {
+    #if HAS_FILESYSTEM
+        if (path.empty()) return;
+        try { fs::create_directories(path); } catch (...) {}
+    #else
+        (void)path;
+    #endif
+    }
+
+    string parentDirectory(const string& path) {
+        size_t slash = path.find_last_of('/');
+        return slash == string::npos ? string() : path.substr(0, slash);
+    }
+}
+
+bool Policy::parse(const string& text, Policy& out) {
+    if (text == "random") { out.kind = Kind::Random; return true; }
+    if (text == "greedy") { out.kind = Kind::Greedy; return true; }
+    if (text.rfind("search", 0) == 0) {
+        long long depth = out.depth;
+        if (!parseSuffix(text, 6, ROWS * COLS, depth)) return false;
+        out.kind = Kind::Search;
+        out.depth = static_cast<int>(depth);
+        return true;
+    }
+    if (text.rfind("time", 0) == 0) {
+        if (!parseSuffix(text, 4, 3600 * 1000, out.budgetMs)) return false;
+        out.kind = Kind::Timed;
+        return true;
+    }
+    if (text.rfind("mcts", 0) == 0) {
+        if (!parseSuffix(text, 4, 100000000, out.playouts)) return false;
+        out.kind = Kind::Mcts;
+        return true;
+    }
+    return false;
+}
+
+string Policy::name() const {
+    switch (kind) {
+        case Kind::Random: return "Random";
+        case Kind::Greedy: return "Greedy";
+        case Kind::Search: return "Search" + to_string(depth);
+        case Kind::Timed: return "Time" + to_string(budgetMs) + "ms";
+        case Kind::Mcts: return "Mcts" + to_string(playouts);
+    }
+    return "?";
+}
+
+uint64_t SelfPlay::gameSeed(uint64_t seed, long long index) {
+    uint64_t s = splitmix64(seed ^ splitmix64(static_cast<uint64_t>(index)));
+    return s ? s : 0x9E3779B97F4A7C15ULL; // xorshift darf nicht bei 0 starten
+}
+
+int SelfPlay::chooseMove(const Policy& policy, const BitBoard& board, uint64_t& rng,
+                         Solver& solver, Mcts* mcts) {
+    const uint64_t possible = board.possibleMask();
+    switch (policy.kind) {
+        case Policy::Kind::Random:
+            return randomColumn(possible, rng);
+
+        case Policy::Kind::Mcts:
+            if (mcts) {
+                MctsResult res = mcts->search(board, 0, policy.playouts);
+                if (res.bestMove >= 0) return res.bestMove;
+            }
+            [[fallthrough]];
+        case Policy::Kind::Greedy: {
+            // nonLosingMoves enthält das Blocken schon (einzige Drohung => erzwungen)
+            uint64_t win = board.threatCells(board.currentPlayer()) & possible;
+            if (win) return randomColumn(win, rng);
+            uint64_t safe = board.nonLosingMoves();
+            return randomColumn(safe ? safe : possible, rng);
+        }
+
+        case Policy::Kind::Search: {
+            SearchResult res = solver.search(board, 0, policy.depth);
+            return res.bestMove >= 0 ? res.bestMove : randomColumn(possible, rng);
+        }
+
+        case Policy::Kind::Timed: {
+            SearchResult res = solver.search(board, policy.budgetMs);
+            return res.bestMove >= 0 ? res.bestMove : randomColumn(possible, rng);
+        }
+    }
+    return randomColumn(possible, rng);
+}
+
+int SelfPlay::playGame(const Policy policies[2], int randomPlies, uint64_t seed,
+                       vector<Move>& moves) {
+    uint64_t rng = seed ? seed : 1;
+    // ohne Transpositionstabelle: Suchergebnisse hängen nicht von früheren Partien ab
+    Solver solver;
+    // eigener Baum pro Spieler: sonst profitiert der eine von der Suche des anderen
+    unique_ptr<Mcts> mcts[2];
+    for (int p = 0; p < 2; ++p)
+        if (policies[p].kind == Policy::Kind::Mcts) mcts[p] = make_unique<Mcts>(MCTS_GAME_MB, splitmix64(rng + p));
+    BitBoard board;
+    moves.clear();
+
+    while (true) {
+        const int p = board.currentPlayer();
+        // Zeitmessung nur dort, wo sie etwas misst (Random-Züge liegen weit unter 1 ms)
+        const bool timed = policies[p].kind != Policy::Kind::Random && policies[p].kind != Policy::Kind::Greedy;
+        chrono::steady_clock::time_point t0;
+        if (timed) t0 = chrono::steady_clock::now();
+
+        int col = board.moveCount() < randomPlies
+                ? randomColumn(board.possibleMask(), rng)
+                : chooseMove(policies[p], board, rng, solver, mcts[p].get());
+
+        long long ms = 0;
+        if (timed) {
+            ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0).count();
+        }
+
+        board.dropDisc(col);
+        moves.push_back({p, col, ms});
+        if (board.checkWin(p)) return p + 1;
+        if (board.isFull()) return 0;
+    }
+}
+
+SelfPlay::Summary SelfPlay::run(const Options& options, ostream& log) {
+    auto t0 = chrono::steady_clock::now();
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(thread::hardware_concurrency());
+    if (threads <= 0) threads = 1;
+
+    string names[2] = {options.policies[0].name(), options.policies[1].name()};
+    if (names[0] == names[1]) {
+        names[0] += " 1";
+        names[1] += " 2";
+    }
+    const char symbols[2] = {'X', 'O'};
+
+    if (!options.csvPath.empty()) createDirectories(parentDirectory(options.csvPath));
+    createDirectories(options.logDir);
+
+    const long long chunks = (options.games + CHUNK - 1) / CHUNK;
+    vector<vector<GameSummary>> pending(static_cast<size_t>(chunks));
+    vector<char> ready(static_cast<size_t>(chunks), 0);
+    long long nextWrite = 0;
+    // Pakete dürfen dem Schreiben nur so weit vorauslaufen (begrenzt den Speicher)
+    const long long window = 2LL * threads;
+
+    // ein Schub pro Paket, der Rest spätestens beim Aufräumen
+    unique_ptr<StatsWriter> writer;
+    if (!options.csvPath.empty()) writer = make_unique<StatsWriter>(options.csvPath, CHUNK, 0);
+
+    Summary summary;
+    atomic<long long> nextChunk{0};
+    mutex m;
+    condition_variable cv;
+    auto lastReport = t0;
+
+    auto work = [&]() {
+        vector<Move> moves;
+        for (long long c = nextChunk++; c < chunks; c = nextChunk++) {
+            {
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&] { return c < nextWrite + window; });
+            }
+
+            Summary local;
+            vector<GameSummary> rows;
+            if (!options.csvPath.empty()) rows.reserve(CHUNK);
+            const long long end = min(options.games, (c + 1) * CHUNK);
+            for (long long i = c * CHUNK; i < end; ++i) {
+                int result = playGame(options.policies, options.randomPlies,
+                                      gameSeed(options.seed, i), moves);
+                ++local.games;
+                local.moves += static_cast<long long>(moves.size());
+                if (result == 0) ++local.draws;
+                else ++local.wins[result - 1];
+
+                if (!options.csvPath.empty()) rows.push_back(Stats::summarize(names, result, moves));
+                if (!options.logDir.empty()) {
+                    string fn = options.logDir + "/selfplay_" + to_string(i) + ".log";
+                    if (!GameLogger::save(fn, moves, names, symbols, result)) local.writeFailed = true;
+                }
+            }
+
+            lock_guard<mutex> lock(m);
+            summary.games += local.games;
+            summary.moves += local.moves;
+            summary.draws += local.draws;
+            summary.wins[0] += local.wins[0];
+            summary.wins[1] += local.wins[1];
+            summary.writeFailed = summary.writeFailed || local.writeFailed;
+            pending[c] = move(rows);
+            ready[c] = 1;
+
+            // fertige Pakete in Index-Reihenfolge übergeben
+            while (nextWrite < chunks && ready[nextWrite]) {
+                if (writer) writer->add(pending[nextWrite]);
+                vector<GameSummary>().swap(pending[nextWrite]);
+                ++nextWrite;
+            }
+            cv.notify_all();
+
+            auto now = chrono::steady_clock::now();
+            if (now - lastReport >= chrono::seconds(1)) {
+                lastReport = now;
+                log << "\r" << summary.games << "/" << options.games << " Partien" << flush;
+            }
+        }
+    };
+
+    vector<thread> helpers;
+    for (int t = 1; t < threads; ++t) helpers.emplace_back(work);
+    work();
+    for (auto& t : helpers) t.join();
+    if (writer && !writer->flush()) summary.writeFailed = true;
+
+    summary.micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count();
+    double seconds = summary.micros / 1e6;
+    if (lastReport != t0) log << "\n"; // Fortschrittszeile stehen lassen
+    log << summary.games << " Partien " << names[0] << " gegen " << names[1]
+        << " (" << threads << " Threads, Seed " << options.seed << ")\n"
+        << "Siege " << names[0] << ": " << summary.wins[0]
+        << " | Siege " << names[1] << ": " << summary.wins[1]
+        << " | Remis: " << summary.draws << "\n"
+        << fixed << setprecision(1)
+        << "Ø Züge: " << (summary.games ? (double)summary.moves / summary.games : 0.0)
+        << " | Zeit: " << seconds << " s | "
+        << setprecision(0) << (seconds > 0 ? summary.games / seconds : 0.0) << " Partien/s\n";
+    log.unsetf(ios::floatfield);
+    if (summary.writeFailed) log << "Fehler: Statistik oder Logs konnten nicht vollständig geschrieben werden.\n";
+    return summary;
+}
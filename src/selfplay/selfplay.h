@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "board/bitboard.h"
+#include "move.h"
+
+class Mcts;
+class Solver;
+
+// Zugwahl eines simulierten Spielers
+struct Policy {
+    enum class Kind {
+        Random,     // gleichverteilt über alle legalen Spalten
+        Greedy,     // gewinnen, sonst blocken, sonst zufällig (ohne Selbstmord)
+        Search,     // Alpha-Beta bis zur festen Tiefe, ohne Zeitlimit
+        Timed,      // Alpha-Beta, iterative Vertiefung bis zum Zeitbudget
+        Mcts        // Monte-Carlo-Baumsuche mit fester Playout-Zahl
+    };
+
+    Kind kind = Kind::Random;
+    int depth = 8;              // nur für Search
+    long long budgetMs = 100;   // nur für Timed
+    long long playouts = 1000;  // nur für Mcts
+
+    // "random", "greedy", "search[:N]" (N = Tiefe in Halbzügen),
+    // "time[:MS]" (Bedenkzeit pro Zug) oder "mcts[:N]" (Playouts pro Zug)
+    static bool parse(const std::string& text, Policy& out);
+    std::string name() const;
+};
+
+// Kopfloser Simulator: spielt Partien zwischen zwei Policies ohne Anzeige,
+// Animation oder Eingabe. Jede Partie ist allein durch (seed, Index)
+// bestimmt, das Ergebnis hängt also nicht von der Anzahl Threads ab.
+class SelfPlay {
+public:
+    struct Options {
+        long long games = 1000;
+        Policy policies[2];
+        uint64_t seed = 1;
+        int threads = 0;          // <= 0: alle Kerne
+        int randomPlies = 0;      // so viele Eröffnungszüge zufällig (für Vielfalt)
+        std::string csvPath;      // leer = keine Statistik
+        std::string logDir;       // leer = keine Logdateien (eine pro Partie)
+    };
+
+    struct Summary {
+        long long games = 0;
+        long long wins[2] = {0, 0};
+        long long draws = 0;
+        long long moves = 0;
+        long long micros = 0;
+        bool writeFailed = false;
+    };
+
+    // Spielt alle Partien; Statistikzeilen stehen in der Reihenfolge der
+    // Partie-Indizes. Fortschritt/Zusammenfassung gehen nach log.
+    static Summary run(const Options& options, std::ostream& log);
+
+    // Eine Partie. Rückgabe wie in den Logs: 0 Remis, 1/2 Sieg Spieler 0/1.
+    // Mit Timed-Policies hängt das Ergebnis von der Rechenzeit ab
+    static int playGame(const Policy policies[2], int randomPlies, uint64_t seed,
+                        std::vector<Move>& moves);
+
+    // Startwert der Partie index (nie 0)
+    static uint64_t gameSeed(uint64_t seed, long long index);
+
+    // Zugwahl für den Spieler am Zug (board darf nicht entschieden/voll sein).
+    // Mcts-Policies brauchen mcts, ohne spielen sie wie Greedy
+    static int chooseMove(const Policy& policy, const BitBoard& board, uint64_t& rng,
+                          Solver& solver, Mcts* mcts = nullptr);
+};
@@ -0,0 +1,147 @@
+#include "tournament.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "stats/statswriter.h"
+
+#if __has_include(<filesystem>)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+  #define HAS_FILESYSTEM 1
+#else
+  #define HAS_FILESYSTEM 0
+#endif
+
+using namespace std;
+
+namespace {
+    // Partien pro Arbeitspaket: klein, weil Suchpartien Sekunden dauern können
+    constexpr long long CHUNK = 16;
+}
+
+vector<string> Tournament::names(const vector<Policy>& engines) {
+    vector<string> out;
+    for (const Policy& p : engines) out.push_back(p.name());
+    for (size_t i = 0; i < out.size(); ++i) {
+        int copies = 1;
+        for (size_t j = i + 1; j < out.size(); ++j)
+            if (out[j] == out[i]) out[j] += " " + to_string(++copies);
+    }
+    return out;
+}
+
+Tournament::Summary Tournament::run(const Options& options, ostream& log) {
+    auto t0 = chrono::steady_clock::now();
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(thread::hardware_concurrency());
+    if (threads <= 0) threads = 1;
+
+    const vector<string> engineNames = names(options.engines);
+    vector<pair<int, int>> pairings;
+    for (int a = 0; a < static_cast<int>(options.engines.size()); ++a)
+        for (int b = a + 1; b < static_cast<int>(options.engines.size()); ++b) pairings.emplace_back(a, b);
+    const long long pairCount = static_cast<long long>(pairings.size());
+    const long long total = pairCount * max(0LL, options.games);
+
+    unique_ptr<StatsWriter> writer;
+    if (!options.csvPath.empty()) {
+    #if HAS_FILESYSTEM
+        size_t slash = options.csvPath.find_last_of('/');
+        if (slash != string::npos) {
+            try { fs::create_directories(options.csvPath.substr(0, slash)); } catch (...) {}
+        }
+    #endif
+        writer = make_unique<StatsWriter>(options.csvPath);
+    }
+
+    // Bilanz jeder Paarung aus Sicht des ersten Engines: Siege, Remis, Niederlagen
+    vector<array<int, 3>> results(pairings.size(), array<int, 3>{});
+    Summary summary;
+    atomic<long long> next{0};
+    mutex m;
+    auto lastReport = t0;
+
+    auto work = [&]() {
+        vector<Move> moves;
+        vector<GameSummary> rows;
+        for (long long c = next.fetch_add(CHUNK); c < total; c = next.fetch_add(CHUNK)) {
+            vector<pair<long long, int>> played;   // Paarung, Ergebnis aus Sicht des ersten
+            const long long end = min(total, c + CHUNK);
+            for (long long i = c; i < end; ++i) {
+                // Paarungen verschränkt: der Fortschritt verteilt sich gleichmäßig
+                const long long pairing = i % pairCount;
+                const long long k = i / pairCount;
+                const bool swapped = k % 2 == 1;
+                const int first = pairings[pairing].first, second = pairings[pairing].second;
+                const Policy policies[2] = {options.engines[swapped ? second : first],
+                                            options.engines[swapped ? first : second]};
+                // Farbpaar (k, k+1) mit derselben Eröffnung
+                const uint64_t seed = SelfPlay::gameSeed(options.seed, pairing * options.games + k / 2);
+                const int result = SelfPlay::playGame(policies, options.randomPlies, seed, moves);
+
+                int forFirst = 0;
+                if (result > 0) forFirst = (result - 1 == (swapped ? 1 : 0)) ? 1 : -1;
+                played.emplace_back(pairing, forFirst);
+                if (writer) {
+                    const string players[2] = {engineNames[swapped ? second : first],
+                                               engineNames[swapped ? first : second]};
+                    rows.push_back(Stats::summarize(players, result, moves));
+                }
+            }
+
+            lock_guard<mutex> lock(m);
+            for (const auto& g : played) results[g.first][g.second > 0 ? 0 : g.second == 0 ? 1 : 2]++;
+            summary.games += static_cast<long long>(played.size());
+            if (writer) writer->add(rows);
+            rows.clear();
+
+            auto now = chrono::steady_clock::now();
+            if (now - lastReport >= chrono::seconds(1)) {
+                lastReport = now;
+                log << "\r" << summary.games << "/" << total << " Partien" << flush;
+            }
+        }
+    };
+
+    vector<thread> helpers;
+    for (int t = 1; t < threads; ++t) helpers.emplace_back(work);
+    work();
+    for (auto& t : helpers) t.join();
+    if (writer && !writer->flush()) summary.writeFailed = true;
+
+    // Rangliste aus den Paarungen
+    summary.standings.resize(options.engines.size());
+    for (size_t i = 0; i < engineNames.size(); ++i) summary.standings[i].name = engineNames[i];
+    vector<PairGames> pairGames;
+    for (size_t p = 0; p < pairings.size(); ++p) {
+        const int wins = results[p][0], draws = results[p][1], losses = results[p][2];
+        PlayerStats& a = summary.standings[pairings[p].first];
+        PlayerStats& b = summary.standings[pairings[p].second];
+        const int games = wins + draws + losses;
+        a.games += games; a.wins += wins; a.draws += draws; a.losses += losses;
+        b.games += games; b.wins += losses; b.draws += draws; b.losses += wins;
+        pairGames.push_back({static_cast<uint32_t>(pairings[p].first), static_cast<uint32_t>(pairings[p].second), games});
+    }
+    Stats::computeElo(summary.standings, pairGames);
+    stable_sort(summary.standings.begin(), summary.standings.end(),
+                [](const PlayerStats& a, const PlayerStats& b) { return a.elo > b.elo; });
+
+    summary.micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count();
+    const double seconds = summary.micros / 1e6;
+    if (lastReport != t0) log << "\n";
+    log << options.engines.size() << " Engines, " << pairCount << " Paarungen x " << options.games
+        << " Partien (" << threads << " Threads, Seed " << options.seed << ")\n"
+        << fixed << setprecision(1) << summary.games << " Partien in " << seconds << " s | "
+        << setprecision(0) << (seconds > 0 ? summary.games / seconds : 0.0) << " Partien/s\n";
+    log.unsetf(ios::floatfield);
+    Stats::printReport(summary.standings, ReportOrder::Elo, log);
+    if (summary.writeFailed) log << "Fehler: Statistik konnte nicht vollständig geschrieben werden.\n";
+    return summary;
+}
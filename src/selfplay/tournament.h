@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "selfplay/selfplay.h"
+#include "stats/stats.h"
+
+// Rundenturnier zwischen Engine-Konfigurationen (Policies): jede Paarung
+// spielt games Partien mit wechselnden Farben, verteilt auf alle Kerne.
+// Die beiden Partien eines Farbpaars beginnen mit derselben
+// Zufallseröffnung (randomPlies), so zählt nur die Spielstärke.
+class Tournament {
+public:
+    struct Options {
+        std::vector<Policy> engines;
+        long long games = 100;                    // pro Paarung
+        uint64_t seed = 1;
+        int threads = 0;                          // <= 0: alle Kerne
+        int randomPlies = 2;
+        std::string csvPath = "logs/tournament.csv";   // leer = keine Statistik
+    };
+
+    struct Summary {
+        std::vector<PlayerStats> standings;   // mit Elo, nach Elo sortiert
+        long long games = 0;
+        long long micros = 0;
+        bool writeFailed = false;
+    };
+
+    // Eindeutige Namen (gleiche Policies bekommen " 2", " 3", ...)
+    static std::vector<std::string> names(const std::vector<Policy>& engines);
+
+    // Spielt alle Paarungen; Fortschritt und Rangliste gehen nach log.
+    // Ohne Timed-Policies hängt das Ergebnis nicht von threads ab
+    static Summary run(const Options& options, std::ostream& log);
+};
@@ -0,0 +1,482 @@
+#include "gameserver.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+
+#include "gamelogger/gamelogger.h"
+#include "stats/stats.h"
+#include "stats/statswriter.h"
+#include "util/rng.h"
+
+#if defined(__linux__)
+  #include <fcntl.h>
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+  #define HAS_EPOLL 1
+#else
+  #define HAS_EPOLL 0
+#endif
+
+#if __has_include(<filesystem>)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+  #define HAS_FILESYSTEM 1
+#else
+  #define HAS_FILESYSTEM 0
+#endif
+
+using namespace std;
+
+namespace {
+    // längere Zeilen sind kein Protokoll: Verbindung wird geschlossen
+    constexpr size_t MAX_LINE = 256;
+
+    // Leerzeichen-getrennte Wörter, höchstens max viele
+    int splitWords(const string& line, string_view* words, int max) {
+        int n = 0;
+        size_t i = 0;
+        while (n < max) {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+            if (i == line.size()) break;
+            size_t end = i;
+            while (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r') ++end;
+            words[n++] = string_view(line).substr(i, end - i);
+            i = end;
+        }
+        return n;
+    }
+
+    bool parseId(string_view word, uint64_t& id) {
+        if (word.empty() || word.size() > 19) return false;
+        id = 0;
+        for (char ch : word) {
+            if (ch < '0' || ch > '9') return false;
+            id = id * 10 + static_cast<uint64_t>(ch - '0');
+        }
+        return true;
+    }
+
+    void appendError(string& out, string_view id, const char* text) {
+        out += "ERR ";
+        out += id.empty() ? string_view("-") : id;
+        out += ' ';
+        out += text;
+        out += '\n';
+    }
+
+    long long millis(GameServer::Clock::duration d) {
+        return chrono::duration_cast<chrono::milliseconds>(d).count();
+    }
+
+    // Gegner, deren Zug der Server-Thread in wenigen ms rechnet
+    bool boundedEngine(const Policy& engine) {
+        switch (engine.kind) {
+            case Policy::Kind::Random:
+            case Policy::Kind::Greedy: return true;
+            case Policy::Kind::Search: return engine.depth <= GameServer::MAX_SEARCH_DEPTH;
+            default: return false;
+        }
+    }
+}
+
+struct GameServer::Connection {
+    int fd = -1;
+    string in;
+    string out;
+    size_t sent = 0;            // davon schon geschrieben
+    bool watchingOut = false;   // EPOLLOUT angemeldet
+    bool closing = false;       // nach dem Senden schließen
+};
+
+GameServer::GameServer(const Options& options) : options(options) {
+    if (!options.logDir.empty()) {
+    #if HAS_FILESYSTEM
+        try { fs::create_directories(options.logDir); } catch (...) {}
+    #endif
+        // Startzeit im Namen: Nummern beginnen in jedem Lauf bei 1
+        time_t now = time(nullptr);
+        char buf[32];
+        strftime(buf, sizeof(buf), "%Y%m%d_%H%M%S", localtime(&now));
+        logPrefix = options.logDir + "/server_" + buf + "_";
+    }
+    if (!options.csvPath.empty()) {
+    #if HAS_FILESYSTEM
+        size_t slash = options.csvPath.find_last_of('/');
+        if (slash != string::npos) {
+            try { fs::create_directories(options.csvPath.substr(0, slash)); } catch (...) {}
+        }
+    #endif
+        writer = make_unique<StatsWriter>(options.csvPath);
+    }
+}
+
+GameServer::~GameServer() {
+#if HAS_EPOLL
+    for (auto& entry : connections) ::close(entry.first);
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(options.socketPath.c_str());
+    }
+    if (pollFd >= 0) ::close(pollFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Partien
+
+void GameServer::playEngine(uint64_t id, Game& game) {
+    const auto t0 = Clock::now();
+    const int p = game.board.currentPlayer();
+    const int col = SelfPlay::chooseMove(game.engine, game.board, game.rng, solver);
+    const auto t1 = Clock::now();
+    engineTime += t1 - t0;
+
+    game.board.dropDisc(col);
+    game.moves.push_back({p, col, millis(t1 - t0)});
+    startTurn(game, t1);
+    if (game.board.checkWin(p)) finish(id, game, p + 1, nullptr, t1);
+    else if (game.board.isFull()) finish(id, game, 0, nullptr, t1);
+}
+
+void GameServer::startTurn(Game& game, Clock::time_point now) {
+    game.turnStart = now;
+    game.engineAtTurnStart = engineTime;
+}
+
+GameServer::Clock::duration GameServer::thinking(const Game& game, Clock::time_point now) const {
+    // now gilt für alle Zeilen eines read(), ein Computerzug kann danach liegen
+    const auto elapsed = (now - game.turnStart) - (engineTime - game.engineAtTurnStart);
+    return max(elapsed, Clock::duration::zero());
+}
+
+void GameServer::finish(uint64_t id, Game& game, int result, const char* reason, Clock::time_point now) {
+    game.result = result;
+    game.reason = reason;
+    game.turnStart = now;   // Endstand bleibt noch ein Zeitlimit lang abfragbar
+    stats.gamesFinished++;
+
+    if (!logPrefix.empty()) {
+        static const char symbols[2] = {'X', 'O'};
+        GameLogger::save(logPrefix + to_string(id) + ".log", game.moves, game.players, symbols, result);
+    }
+    if (writer) writer->add(Stats::summarize(game.players, result, game.moves));
+}
+
+void GameServer::expire(Clock::time_point now) {
+    const auto limit = chrono::milliseconds(options.turnLimitMs);
+    while (!deadlines.empty() && deadlines.top().due <= now) {
+        const uint64_t id = deadlines.top().game;
+        deadlines.pop();
+        auto it = games.find(id);
+        if (it == games.end()) continue;
+        Game& game = it->second;
+        // laufende Partie: Rechenzeit des Servers seit Zugbeginn hängt hinten dran
+        const auto due = game.turnStart + limit
+                       + (game.result < 0 ? engineTime - game.engineAtTurnStart : Clock::duration::zero());
+        if (due > now) {
+            deadlines.push({due, id});      // inzwischen gezogen: neue Frist
+        } else if (game.result >= 0) {
+            games.erase(it);
+        } else {
+            // wer am Zug ist, hat das Zeitlimit überschritten
+            stats.timeouts++;
+            finish(id, game, 2 - game.board.currentPlayer(), "TIMEOUT", due);
+            deadlines.push({due + limit, id});
+        }
+    }
+}
+
+void GameServer::appendState(string& out, uint64_t id, const Game& game) const {
+    out += "OK ";
+    out += to_string(id);
+    out += ' ';
+    if (game.moves.empty()) out += '-';
+    for (const Move& m : game.moves) out += static_cast<char>('1' + m.col);
+    if (game.result < 0) {
+        out += game.board.currentPlayer() == 0 ? " TURN0" : " TURN1";
+    } else {
+        out += game.result == 0 ? " DRAW" : game.result == 1 ? " WIN0" : " WIN1";
+        if (game.reason) {
+            out += ' ';
+            out += game.reason;
+        }
+    }
+    out += '\n';
+}
+
+bool GameServer::handle(const string& line, Clock::time_point now, string& out) {
+    string_view w[5];
+    const int n = splitWords(line, w, 5);
+    if (n == 0) return true;   // Leerzeile: keine Antwort
+    stats.requests++;
+    const string_view cmd = w[0];
+
+    if (cmd == "QUIT") return false;
+
+    if (cmd == "NEW") {
+        if (n > 4) { appendError(out, {}, "Zu viele Angaben"); return true; }
+        Game game;
+        const string opponent = n > 1 ? string(w[1]) : "greedy";
+        if (opponent != "none" && !Policy::parse(opponent, game.engine)) {
+            appendError(out, {}, "Unbekannter Gegner");
+            return true;
+        }
+        if (opponent != "none" && !boundedEngine(game.engine)) {
+            appendError(out, {}, "Gegner rechnet zu lange");
+            return true;
+        }
+        int seat = 0;
+        if (n > 2) {
+            if (w[2] != "1" && w[2] != "2") { appendError(out, {}, "Platz muss 1 oder 2 sein"); return true; }
+            seat = w[2][0] - '1';
+        }
+        if (games.size() >= options.maxGames) { appendError(out, {}, "Zu viele Partien"); return true; }
+
+        const string name = n > 3 ? string(w[3]) : "Client";
+        if (opponent == "none") {
+            game.players[0] = name + " 1";
+            game.players[1] = name + " 2";
+        } else {
+            game.engineSeat = 1 - seat;
+            game.players[seat] = name;
+            game.players[1 - seat] = game.engine.name();
+        }
+        const uint64_t id = nextId++;
+        game.rng = splitmix64(id) | 1;
+        Game& g = games.emplace(id, move(game)).first->second;
+        stats.gamesStarted++;
+        startTurn(g, now);
+        deadlines.push({now + chrono::milliseconds(options.turnLimitMs), id});
+        if (g.engineSeat == 0) playEngine(id, g);
+        appendState(out, id, g);
+        return true;
+    }
+
+    if (cmd != "MOVE" && cmd != "STATE" && cmd != "RESIGN") {
+        appendError(out, {}, "Unbekannter Befehl");
+        return true;
+    }
+    uint64_t id = 0;
+    if (n < 2 || !parseId(w[1], id)) { appendError(out, {}, "Partienummer fehlt"); return true; }
+    auto it = games.find(id);
+    if (it == games.end()) { appendError(out, w[1], "Unbekannte Partie"); return true; }
+    Game& game = it->second;
+
+    // Frist vor allem anderen: wer zu spät kommt, hat schon verloren
+    if (game.result < 0 && thinking(game, now) > chrono::milliseconds(options.turnLimitMs)) {
+        stats.timeouts++;
+        finish(id, game, 2 - game.board.currentPlayer(), "TIMEOUT", now);
+    }
+
+    // auf eine beendete Partie ist die Antwort der Endstand
+    if (cmd == "MOVE" && game.result < 0) {
+        const int p = game.board.currentPlayer();
+        const int col = n == 3 && w[2].size() == 1 ? w[2][0] - '1' : -1;
+        if (p == game.engineSeat) { appendError(out, w[1], "Nicht am Zug"); return true; }
+        if (n != 3 || !game.board.isValidColumn(col)) { appendError(out, w[1], "Ungültige Spalte"); return true; }
+
+        stats.moves++;
+        game.board.dropDisc(col);
+        game.moves.push_back({p, col, millis(thinking(game, now))});
+        if (game.board.checkWin(p)) finish(id, game, p + 1, nullptr, now);
+        else if (game.board.isFull()) finish(id, game, 0, nullptr, now);
+        else if (game.board.currentPlayer() == game.engineSeat) playEngine(id, game);
+        else startTurn(game, now);
+    } else if (cmd == "RESIGN" && game.result < 0) {
+        finish(id, game, 2 - game.board.currentPlayer(), "RESIGN", now);
+    }
+    appendState(out, id, game);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Sockets
+
+#if HAS_EPOLL
+
+bool GameServer::listen(string* error) {
+    auto fail = [&](const char* what) {
+        if (error) *error = string(what) + ": " + strerror(errno);
+        return false;
+    };
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (options.socketPath.empty() || options.socketPath.size() >= sizeof(addr.sun_path)) {
+        if (error) *error = "Socketpfad leer oder zu lang: " + options.socketPath;
+        return false;
+    }
+    memcpy(addr.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) return fail("socket");
+    ::unlink(options.socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail("bind");
+    if (::listen(listenFd, SOMAXCONN) != 0) return fail("listen");
+
+    pollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (pollFd < 0) return fail("epoll_create1");
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) return fail("eventfd");
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    ::epoll_ctl(pollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.fd = wakeFd;
+    ::epoll_ctl(pollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+    running = true;   // ein stop() vor run() geht so nicht verloren
+    return true;
+}
+
+void GameServer::stop() {
+    running = false;
+    if (wakeFd >= 0) {
+        const uint64_t one = 1;
+        if (::write(wakeFd, &one, sizeof(one)) < 0) {
+            // Zähler voll: der Server ist ohnehin schon geweckt
+        }
+    }
+}
+
+void GameServer::accept() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;   // EAGAIN, oder zu viele Dateien: beim nächsten Mal
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (::epoll_ctl(pollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        auto c = make_unique<Connection>();
+        c->fd = fd;
+        connections.emplace(fd, move(c));
+        stats.connections++;
+    }
+}
+
+void GameServer::closeConnection(int fd) {
+    ::epoll_ctl(pollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+void GameServer::readFrom(Connection& c) {
+    char buf[16384];
+    ssize_t n = ::read(c.fd, buf, sizeof(buf));
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+    if (n <= 0) {
+        closeConnection(c.fd);
+        return;
+    }
+    c.in.append(buf, static_cast<size_t>(n));
+
+    // alle vollständigen Zeilen, Antworten gesammelt in einem write
+    const auto now = Clock::now();
+    size_t start = 0;
+    string line;
+    while (!c.closing) {
+        size_t nl = c.in.find('\n', start);
+        if (nl == string::npos) break;
+        line.assign(c.in, start, nl - start);
+        start = nl + 1;
+        if (!handle(line, now, c.out)) c.closing = true;
+    }
+    c.in.erase(0, start);
+    if (c.in.size() > MAX_LINE && !c.closing) {
+        appendError(c.out, {}, "Zeile zu lang");
+        c.closing = true;
+    }
+    flushTo(c);
+}
+
+void GameServer::flushTo(Connection& c) {
+    while (c.sent < c.out.size()) {
+        // send statt write: ein weggelaufener Client darf kein SIGPIPE auslösen
+        ssize_t n = ::send(c.fd, c.out.data() + c.sent, c.out.size() - c.sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) break;
+        if (n <= 0) {
+            closeConnection(c.fd);
+            return;
+        }
+        c.sent += static_cast<size_t>(n);
+    }
+    const bool pending = c.sent < c.out.size();
+    if (!pending) {
+        c.out.clear();
+        c.sent = 0;
+        if (c.closing) {
+            closeConnection(c.fd);
+            return;
+        }
+    }
+    if (pending != c.watchingOut) {
+        // Client liest nicht schnell genug: warten, bis der Socket wieder Platz hat
+        epoll_event ev{};
+        ev.events = pending ? EPOLLOUT : EPOLLIN;
+        ev.data.fd = c.fd;
+        ::epoll_ctl(pollFd, EPOLL_CTL_MOD, c.fd, &ev);
+        c.watchingOut = pending;
+    }
+}
+
+void GameServer::run() {
+    epoll_event events[256];
+    while (running) {
+        int timeoutMs = -1;
+        if (!deadlines.empty()) {
+            auto wait = chrono::duration_cast<chrono::milliseconds>(deadlines.top().due - Clock::now()).count();
+            timeoutMs = static_cast<int>(max<long long>(0, wait + 1));
+        }
+        int n = ::epoll_wait(pollFd, events, 256, timeoutMs);
+        if (n < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < n && running; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                accept();
+                continue;
+            }
+            if (fd == wakeFd) continue;
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;   // in dieser Runde schon geschlossen
+            Connection& c = *it->second;
+            if (events[i].events & EPOLLOUT) flushTo(c);
+            else readFrom(c);
+        }
+        expire(Clock::now());
+    }
+    if (writer) writer->flush();
+}
+
+#else
+
+bool GameServer::listen(string* error) {
+    if (error) *error = "Server-Modus gibt es nur unter Linux (epoll)";
+    return false;
+}
+
+void GameServer::stop() { running = false; }
+
+void GameServer::run() {}
+
+void GameServer::accept() {}
+
+void GameServer::closeConnection(int) {}
+
+void GameServer::readFrom(Connection&) {}
+
+void GameServer::flushTo(Connection&) {}
+
+#endif
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "board/bitboard.h"
+#include "constants.h"
+#include "move.h"
+#include "selfplay/selfplay.h"
+#include "solver/solver.h"
+
+class StatsWriter;
+
+// Spielserver auf einem Unix-Domain-Socket: ein Thread, epoll, beliebig
+// viele Verbindungen und Partien gleichzeitig. Partien gehören nicht zu
+// einer Verbindung; wer die Nummer kennt, darf weiterspielen.
+//
+// Protokoll: eine Zeile pro Anfrage, genau eine Antwortzeile, in
+// Reihenfolge (Anfragen dürfen ohne Warten hintereinander geschickt werden).
+//   NEW [GEGNER] [1|2] [NAME]   neue Partie. GEGNER = none (beide Seiten
+//                               über das Protokoll), random, greedy (Standard)
+//                               oder search:N mit N <= MAX_SEARCH_DEPTH;
+//                               1/2 = eigener Platz (Standard 1, beginnt);
+//                               NAME ohne Leerzeichen
+//   MOVE ID SPALTE              Zug (1-7) für den Spieler am Zug; der
+//                               Gegenzug des Computers steht gleich in der Antwort
+//   STATE ID                    Stand abfragen
+//   RESIGN ID                   Spieler am Zug gibt auf
+//   QUIT                        Verbindung schließen
+// Antworten:
+//   OK ID ZÜGE STATUS [GRUND]   ZÜGE = Spalten 1-7 aller Züge ("-" = keine),
+//                               STATUS = TURN0/TURN1 (wer am Zug ist),
+//                               WIN0/WIN1 oder DRAW; GRUND = TIMEOUT/RESIGN
+//   ERR ID|- TEXT
+//
+// Zeitlimit wie im Spiel (TURN_LIMIT_MS pro Zug): läuft es ab, gewinnt der
+// Gegner, auch ohne weitere Anfrage. Computerzüge rechnet der eine
+// Server-Thread, alle anderen Partien warten so lange: daher nur Gegner mit
+// kurzer, fester Rechenzeit, und diese Zeit zählt für niemanden als Bedenkzeit. Beendete Partien gehen nach
+// GameLogger (eine Datei pro Partie) und gebündelt nach stats.csv und
+// bleiben danach noch ein Zeitlimit lang abfragbar.
+class GameServer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // search:10 braucht ohne Transpositionstabelle höchstens ~10 ms pro Zug
+    static constexpr int MAX_SEARCH_DEPTH = 10;
+
+    struct Options {
+        std::string socketPath = "connect4.sock";
+        std::string logDir = "logs";              // leer = keine Logdateien
+        std::string csvPath = "logs/stats.csv";   // leer = keine Statistik
+        long long turnLimitMs = TURN_LIMIT_MS;
+        size_t maxGames = 1000000;
+    };
+
+    // Zähler für Messungen; aus jedem Thread lesbar
+    struct Counters {
+        std::atomic<uint64_t> connections{0};
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> moves{0};
+        std::atomic<uint64_t> gamesStarted{0};
+        std::atomic<uint64_t> gamesFinished{0};
+        std::atomic<uint64_t> timeouts{0};
+    };
+
+    explicit GameServer(const Options& options);
+    ~GameServer();
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Socket anlegen (eine alte Socketdatei wird ersetzt); false mit Meldung
+    bool listen(std::string* error = nullptr);
+
+    // Bedient Verbindungen bis stop(); schreibt danach die Statistik weg
+    void run();
+
+    // Aus beliebigem Thread (auch Signal-Handler)
+    void stop();
+
+    const Counters& counters() const { return stats; }
+    size_t activeGames() const { return games.size(); }
+
+    // Eine Anfragezeile verarbeiten, Antwort (mit '\n') an out hängen.
+    // Rückgabe false = Verbindung schließen. Ohne Sockets nutzbar (Tests)
+    bool handle(const std::string& line, Clock::time_point now, std::string& out);
+
+    // Abgelaufene Zeitlimits bis now auswerten
+    void expire(Clock::time_point now);
+
+private:
+    struct Game {
+        BitBoard board;
+        std::vector<Move> moves;
+        std::string players[2];
+        Policy engine;
+        int engineSeat = -1;       // -1 = beide Seiten über das Protokoll
+        int result = -1;           // wie in den Logs: 0 Remis, 1/2 Sieg Spieler 0/1
+        const char* reason = nullptr;
+        Clock::time_point turnStart;   // nach dem Ende: Zeitpunkt des Endes
+        Clock::duration engineAtTurnStart{};   // engineTime bei turnStart
+        uint64_t rng = 1;
+    };
+
+    // Ein Eintrag pro Partie, egal wie viele Züge: beim Fälligwerden wird
+    // nachgesehen, ob die Frist inzwischen weiter hinten liegt
+    struct Deadline {
+        Clock::time_point due;
+        uint64_t game;
+        bool operator>(const Deadline& o) const { return due > o.due; }
+    };
+
+    struct Connection;
+
+    void playEngine(uint64_t id, Game& game);
+    void startTurn(Game& game, Clock::time_point now);
+    // Bedenkzeit des Spielers am Zug bis now, ohne die Zeit, in der der
+    // Server Computerzüge gerechnet hat (auch die anderer Partien)
+    Clock::duration thinking(const Game& game, Clock::time_point now) const;
+    void finish(uint64_t id, Game& game, int result, const char* reason, Clock::time_point now);
+    void appendState(std::string& out, uint64_t id, const Game& game) const;
+
+    void accept();
+    void closeConnection(int fd);
+    void readFrom(Connection& c);
+    void flushTo(Connection& c);
+
+    Options options;
+    std::unordered_map<uint64_t, Game> games;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+    uint64_t nextId = 1;
+    std::string logPrefix;                 // logDir/server_<Startzeit>_
+    Clock::duration engineTime{};          // Rechenzeit aller Computerzüge bisher
+    Solver solver;                         // ohne Transpositionstabelle, wie im Selbstspiel
+    std::unique_ptr<StatsWriter> writer;
+
+    int listenFd = -1;
+    int pollFd = -1;
+    int wakeFd = -1;
+    std::atomic<bool> running{false};
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    Counters stats;
+};
@@ -0,0 +1,60 @@
+#include "parallelsearch.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+ParallelSearch::ParallelSearch(TranspositionTable& tt, int threads) : tt(tt), threads(threads) {
+    if (this->threads <= 0) this->threads = static_cast<int>(thread::hardware_concurrency());
+    if (this->threads <= 0) this->threads = 1;
+}
+
+// Startet einen Solver pro Thread (Thread 0 = Hauptthread mit normaler
+// Zugreihenfolge) und wählt das beste fertige Ergebnis: exakt vor
+// unvollständig, tiefer vor flacher, bei Gleichstand der Hauptthread.
+template <typename Run>
+SearchResult ParallelSearch::runWorkers(Run run) {
+    auto t0 = chrono::steady_clock::now();
+
+    vector<SearchResult> results(threads);
+    auto work = [&](int id) {
+        Solver solver(&tt);
+        solver.setStopFlag(&stopFlag);
+        solver.setOrderShift(id);
+        results[id] = run(solver);
+        if (results[id].exact) stopFlag.store(true, memory_order_relaxed);
+    };
+
+    vector<thread> helpers;
+    for (int id = 1; id < threads; ++id) helpers.emplace_back(work, id);
+    work(0);
+    for (auto& t : helpers) t.join();
+    // erst nach dem Join zurücksetzen: ein stop() kurz vor dem Start geht so nicht verloren
+    stopFlag.store(false, memory_order_relaxed);
+
+    SearchResult best = results[0];
+    unsigned long long nodes = 0;
+    TTStats ttStats;
+    for (const auto& r : results) {
+        nodes += r.nodes;
+        ttStats += r.tt;
+        if (r.bestMove < 0) continue;
+        bool better = (r.exact && !best.exact) || (r.exact == best.exact && r.depth > best.depth)
+                   || best.bestMove < 0;
+        if (better) best = r;
+    }
+    best.nodes = nodes;
+    best.tt = ttStats;
+    best.micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count();
+    return best;
+}
+
+SearchResult ParallelSearch::solve(const BitBoard& board) {
+    return runWorkers([&](Solver& s) { return s.solve(board); });
+}
+
+SearchResult ParallelSearch::search(const BitBoard& board, long long budgetMs) {
+    return runWorkers([&](Solver& s) { return s.search(board, budgetMs); });
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+
+#include "board/bitboard.h"
+#include "solver/solver.h"
+#include "solver/transpositiontable.h"
+
+// Lazy SMP: mehrere Solver durchsuchen dieselbe Stellung und teilen sich
+// die Transpositionstabelle. Die Helfer variieren die Zugreihenfolge, so
+// füllen sie die Tabelle mit Ergebnissen, die der Hauptthread später trifft.
+// Wer zuerst fertig ist, setzt das Stop-Flag für alle anderen.
+class ParallelSearch {
+public:
+    // threads <= 0: std::thread::hardware_concurrency()
+    explicit ParallelSearch(TranspositionTable& tt, int threads = 0);
+
+    SearchResult solve(const BitBoard& board);
+    SearchResult search(const BitBoard& board, long long budgetMs);
+
+    // Laufende Suche sauber abbrechen (aus einem anderen Thread). Ein stop()
+    // ohne laufende Suche beendet die nächste Suche sofort.
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); }
+
+    int threadCount() const { return threads; }
+
+private:
+    TranspositionTable& tt;
+    int threads;
+    std::atomic<bool> stopFlag{false};
+
+    template <typename Run>
+    SearchResult runWorkers(Run run);
+};
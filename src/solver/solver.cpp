@@ -0,0 +1,306 @@
+#include "solver.h"
+
+using namespace std;
+
+namespace {
+    // Mitte zuerst: Mittelspalten sind an mehr Vierer-Linien beteiligt
+    struct ColumnOrder {
+        int cols[COLS];
+        constexpr ColumnOrder() : cols() {
+            for (int i = 0; i < COLS; ++i)
+                cols[i] = COLS / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2;
+        }
+    };
+    constexpr ColumnOrder ORDER{};
+
+    // Wie oft (in Knoten) die Uhr geprüft wird
+    constexpr unsigned long long CLOCK_CHECK_MASK = 1023;
+
+    // Bis zu diesem Halbzug legt die Transpositionstabelle Spiegelbilder
+    // unter einem Schlüssel ab (BitBoard::canonicalKey). Spiegel-Transpositionen
+    // gibt es fast nur nahe einer (beinahe) symmetrischen Eröffnung; tiefer
+    // kostet das Spiegeln mehr, als es spart
+    constexpr int SYMMETRY_PLIES = 16;
+
+    // Schlüssel für die Transpositionstabelle. Gespiegelte Einträge speichern
+    // Züge in Spalten der kanonischen Seite
+    uint64_t ttKey(const BitBoard& board, bool& mirrored) {
+        mirrored = false;
+        return board.moveCount() < SYMMETRY_PLIES ? board.canonicalKey(&mirrored) : board.key();
+    }
+
+    // Spiegeln ist eine Involution: dieselbe Funktion in beide Richtungen
+    int mirrorMove(int col, bool mirrored) {
+        return mirrored && col >= 0 ? COLS - 1 - col : col;
+    }
+}
+
+void Solver::reset() {
+    nodes = 0;
+    ttStats = TTStats{};
+    horizonHit = false;
+    stopped = false;
+}
+
+int Solver::movesToEnd(int score, const BitBoard& board) {
+    if (score == 0) return 0;
+    // Bei Sieg mit score s setzt der Gewinner seinen (CELLS/2 + 1 - s)-ten Stein
+    int stonesAtWin = CELLS / 2 + 1 - (score > 0 ? score : -score);
+    int stonesNow = (score > 0) ? board.moveCount() / 2 : (board.moveCount() + 1) / 2;
+    return stonesAtWin - stonesNow;
+}
+
+// Kandidaten in Suchreihenfolge: Zug aus der Transpositionstabelle,
+// dann viele eigene Drohungen, bei Gleichstand Mitte zuerst
+// (stabile Einfügesortierung)
+int Solver::sortedMoves(const BitBoard& board, uint64_t candidates, int hashMove,
+                        BitBoard children[COLS], int cols[COLS]) const {
+    int scores[COLS];
+    int n = 0;
+    const int me = board.currentPlayer();
+
+    for (int i = 0; i < COLS; ++i) {
+        int col = ORDER.cols[(i + orderShift) % COLS];
+        if (!(candidates & BitBoard::columnMask(col))) continue;
+
+        BitBoard child = board;
+        child.dropDisc(col);
+        int sc = (col == hashMove) ? COLS * ROWS : child.threatCount(me);
+
+        int j = n++;
+        for (; j > 0 && scores[j - 1] < sc; --j) {
+            scores[j] = scores[j - 1];
+            cols[j] = cols[j - 1];
+            children[j] = children[j - 1];
+        }
+        scores[j] = sc;
+        cols[j] = col;
+        children[j] = child;
+    }
+    return n;
+}
+
+// Vorbedingung: der Spieler am Zug kann nicht sofort gewinnen
+int Solver::negamax(const BitBoard& board, int alpha, int beta, int depth) {
+    ++nodes;
+    if ((nodes & CLOCK_CHECK_MASK) == 0) {
+        if ((hasDeadline && Clock::now() >= deadline)
+            || (externalStop && externalStop->load(memory_order_relaxed)))
+            stopped = true;
+    }
+    if (stopped) return 0;
+
+    const uint64_t next = board.nonLosingMoves();
+    if (next == 0) return -(CELLS - board.moveCount()) / 2;
+
+    if (board.moveCount() >= CELLS - 2) return 0; // Remis
+
+    // Schranken aus der Zuganzahl: früher als im nächsten Zug verliert man
+    // nicht, früher als im übernächsten gewinnt man nicht
+    int min = -(CELLS - 2 - board.moveCount()) / 2;
+    if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta) return alpha;
+    }
+    int max = (CELLS - 1 - board.moveCount()) / 2;
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta) return beta;
+    }
+
+    // Tiefere Suchen als bis zum Spielende gibt es nicht
+    const int need = depth < CELLS - board.moveCount() ? depth : CELLS - board.moveCount();
+    bool mirrored;
+    const uint64_t key = ttKey(board, mirrored);
+    int hashMove = -1;
+    if (tt) {
+        TTEntry e;
+        if (tt->probe(key, e, ttStats)) {
+            hashMove = mirrorMove(e.bestMove, mirrored);
+            if (e.depth >= need) {
+                // Eintrag aus einer tiefenbegrenzten Suche: Wert ist nicht bewiesen
+                if (e.depth < CELLS - board.moveCount()) horizonHit = true;
+                if (e.bound == Bound::Exact) return e.score;
+                if (e.bound == Bound::Lower) {
+                    if (e.score >= beta) return e.score;
+                    if (e.score > alpha) alpha = e.score;
+                } else if (e.bound == Bound::Upper) {
+                    if (e.score <= alpha) return e.score;
+                    if (e.score < beta) beta = e.score;
+                }
+            }
+        }
+    }
+
+    if (depth <= 0) {
+        horizonHit = true;
+        return 0; // offen; liegt immer innerhalb [min, max]
+    }
+
+    BitBoard children[COLS];
+    int cols[COLS];
+    int n = sortedMoves(board, next, hashMove, children, cols);
+
+    const int alphaOrig = alpha;
+    int bestCol = cols[0];
+    for (int i = 0; i < n; ++i) {
+        int score = -negamax(children[i], -beta, -alpha, depth - 1);
+        if (stopped) return 0;
+        if (score >= beta) {
+            if (tt) tt->store(key, score, Bound::Lower, mirrorMove(cols[i], mirrored), need, ttStats);
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+            bestCol = cols[i];
+        }
+    }
+    if (tt) tt->store(key, alpha, alpha > alphaOrig ? Bound::Exact : Bound::Upper,
+                      mirrorMove(bestCol, mirrored), need, ttStats);
+    return alpha;
+}
+
+int Solver::probeMove(const BitBoard& board) {
+    bool mirrored;
+    TTEntry e;
+    if (!tt || !tt->probe(ttKey(board, mirrored), e, ttStats)) return -1;
+    return mirrorMove(e.bestMove, mirrored);
+}
+
+// Volles Fenster an der Wurzel, damit jeder Zug bewertet wird
+int Solver::rootSearch(const BitBoard& board, int depth, int& bestMove) {
+    ++nodes;
+    uint64_t candidates = board.nonLosingMoves();
+    if (candidates == 0) {
+        // Alles verliert: wenigstens einen legalen Zug liefern
+        for (int i = 0; i < COLS; ++i) {
+            if (board.isValidColumn(ORDER.cols[i])) { bestMove = ORDER.cols[i]; break; }
+        }
+        return -(CELLS - board.moveCount()) / 2;
+    }
+
+    int hashMove = probeMove(board);
+
+    BitBoard children[COLS];
+    int cols[COLS];
+    int n = sortedMoves(board, candidates, hashMove, children, cols);
+
+    int alpha = -CELLS;
+    bestMove = cols[0];
+    for (int i = 0; i < n; ++i) {
+        int score = -negamax(children[i], -CELLS, -alpha, depth - 1);
+        if (stopped) break;
+        if (score > alpha) {
+            alpha = score;
+            bestMove = cols[i];
+        }
+    }
+    return alpha;
+}
+
+SearchResult Solver::solve(const BitBoard& board) {
+    auto t0 = Clock::now();
+    reset();
+    hasDeadline = false;
+
+    SearchResult res;
+    res.exact = true;
+    res.depth = CELLS - board.moveCount();
+
+    if (board.isFull()) return res;
+
+    if (board.canWinNext()) {
+        uint64_t win = board.threatCells(board.currentPlayer()) & board.possibleMask();
+        for (int c = 0; c < COLS; ++c)
+            if (win & BitBoard::columnMask(c)) { res.bestMove = c; break; }
+        res.score = (CELLS + 1 - board.moveCount()) / 2;
+        res.nodes = 1;
+        return res;
+    }
+
+    // Bewertung über Null-Fenster-Suchen (binäre Suche über den Score)
+    int min = -(CELLS - board.moveCount()) / 2;
+    int max = (CELLS + 1 - board.moveCount()) / 2;
+    while (min < max) {
+        int med = min + (max - min) / 2;
+        if (med <= 0 && min / 2 < med) med = min / 2;
+        else if (med >= 0 && max / 2 > med) med = max / 2;
+        int r = negamax(board, med, med + 1, res.depth);
+        if (stopped) break;
+        if (r <= med) max = r;
+        else min = r;
+    }
+    res.score = min;
+
+    // Besten Zug bestimmen: erster Zug (in Suchreihenfolge), der den Score hält
+    BitBoard children[COLS];
+    int cols[COLS];
+    uint64_t candidates = board.nonLosingMoves();
+    int hashMove = probeMove(board);
+    int n = sortedMoves(board, candidates ? candidates : board.possibleMask(), hashMove, children, cols);
+    res.bestMove = n > 0 ? cols[0] : -1;
+    for (int i = 0; i < n && candidates && !stopped; ++i) {
+        if (-negamax(children[i], -res.score, -res.score + 1, res.depth) >= res.score && !stopped) {
+            res.bestMove = cols[i];
+            break;
+        }
+    }
+    if (stopped) {
+        res.exact = false;
+        res.bestMove = -1;
+    }
+
+    res.nodes = nodes;
+    res.tt = ttStats;
+    res.micros = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count();
+    return res;
+}
+
+SearchResult Solver::search(const BitBoard& board, long long budgetMs, int maxDepth) {
+    auto t0 = Clock::now();
+    reset();
+    hasDeadline = budgetMs > 0;
+    deadline = t0 + chrono::milliseconds(budgetMs);
+
+    SearchResult res;
+    if (board.isFull()) {
+        res.exact = true;
+        return res;
+    }
+
+    if (board.canWinNext()) {
+        res = solve(board);
+        res.micros = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count();
+        return res;
+    }
+
+    unsigned long long total = 0;
+    const int remaining = CELLS - board.moveCount();
+    const int lastDepth = maxDepth < remaining ? maxDepth : remaining;
+    for (int depth = 1; depth <= lastDepth; ++depth) {
+        horizonHit = false;
+        int move = -1;
+        int score = rootSearch(board, depth, move);
+        total += nodes;
+        nodes = 0;
+
+        // Abgebrochene Iteration verwerfen (außer es gibt noch gar nichts)
+        if (stopped) {
+            if (res.bestMove < 0) res.bestMove = move;
+            break;
+        }
+
+        res.score = score;
+        res.bestMove = move;
+        res.depth = depth;
+        // Sieg/Niederlage ist innerhalb der Tiefe bewiesen, ebenso alles,
+        // wenn der Horizont nie erreicht wurde
+        res.exact = !horizonHit || score != 0;
+        if (res.exact) break;
+    }
+
+    res.nodes = total;
+    res.tt = ttStats;
+    res.micros = chrono::duration_cast<chrono::microseconds>(Clock::now() - t0).count();
+    return res;
+}
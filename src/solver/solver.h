@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "board/bitboard.h"
+#include "constants.h"
+#include "solver/transpositiontable.h"
+
+// Ergebnis einer Suche, immer aus Sicht des Spielers am Zug:
+//  score > 0  => Sieg, je größer desto früher
+//  score < 0  => Niederlage, je kleiner desto früher
+//  score == 0 => Remis (bei exact) bzw. innerhalb der Suchtiefe offen
+struct SearchResult {
+    int score = 0;
+    int bestMove = -1;            // Spalte 0..COLS-1
+    int depth = 0;                // vollständig durchsuchte Tiefe (Halbzüge)
+    bool exact = false;           // Bewertung bis zum Spielende bewiesen
+    unsigned long long nodes = 0;
+    long long micros = 0;
+    TTStats tt;                   // nur mit Transpositionstabelle
+};
+
+// Negamax mit Alpha-Beta, Zugsortierung "Mitte zuerst" + Drohungen.
+// Ein Solver-Objekt ist nicht threadsicher (eigene Zähler pro Instanz).
+class Solver {
+public:
+    static constexpr int CELLS = ROWS * COLS;
+
+    // tt darf von mehreren Solvern (auch in anderen Threads) geteilt werden
+    explicit Solver(TranspositionTable* tt = nullptr) : tt(tt) {}
+
+    // Abbruch von außen (z.B. durch andere Suchthreads); nullptr = keiner.
+    // Abgebrochene Suchen liefern exact = false.
+    void setStopFlag(const std::atomic<bool>* flag) { externalStop = flag; }
+
+    // Variiert die Mitte-zuerst-Reihenfolge bei Gleichstand, damit parallele
+    // Helfer andere Teilbäume zuerst besuchen
+    void setOrderShift(int shift) { orderShift = shift; }
+
+    // Exakte Lösung ohne Zeitlimit (kann in der Eröffnung sehr lange dauern)
+    SearchResult solve(const BitBoard& board);
+
+    // Iterative Vertiefung bis zum Zeitbudget, liefert den besten Zug der
+    // letzten vollständig durchsuchten Tiefe. budgetMs <= 0: ohne Zeitlimit,
+    // nur bis maxDepth (dann reproduzierbar, unabhängig von der Rechenzeit)
+    SearchResult search(const BitBoard& board, long long budgetMs, int maxDepth = CELLS);
+
+    // Eigene Züge bis zum Sieg (score > 0) bzw. gegnerische bis zur
+    // Niederlage (score < 0); 0 bei Remis
+    static int movesToEnd(int score, const BitBoard& board);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    TranspositionTable* tt;
+    const std::atomic<bool>* externalStop = nullptr;
+    int orderShift = 0;
+    TTStats ttStats;
+    unsigned long long nodes = 0;
+    bool horizonHit = false;
+    bool stopped = false;
+    bool hasDeadline = false;
+    Clock::time_point deadline;
+
+    int negamax(const BitBoard& board, int alpha, int beta, int depth);
+    int rootSearch(const BitBoard& board, int depth, int& bestMove);
+    // bester Zug der Stellung laut Transpositionstabelle, -1 = keiner
+    int probeMove(const BitBoard& board);
+    int sortedMoves(const BitBoard& board, uint64_t candidates, int hashMove,
+                    BitBoard children[COLS], int cols[COLS]) const;
+    void reset();
+};
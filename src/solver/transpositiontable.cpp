@@ -0,0 +1,91 @@
+#include "transpositiontable.h"
+
+#include <algorithm>
+
+using namespace std;
+
+TranspositionTable::TranspositionTable(size_t megabytes) { resize(megabytes); }
+
+void TranspositionTable::resize(size_t megabytes) {
+    // größte Zweierpotenz an Buckets, die in das Budget passt (mind. 1)
+    size_t bytes = max<size_t>(megabytes, 1) * 1024 * 1024;
+    size_t count = 1;
+    indexBits = 0;
+    while (count * 2 * sizeof(Bucket) <= bytes) {
+        count *= 2;
+        ++indexBits;
+    }
+    if (indexBits == 0) indexBits = 1, count = 2;
+
+    vector<Bucket> fresh(count);
+    buckets.swap(fresh);
+}
+
+void TranspositionTable::clear() {
+    for (auto& b : buckets)
+        for (auto& s : b.slots) {
+            s.data.store(0, memory_order_relaxed);
+            s.check.store(0, memory_order_relaxed);
+        }
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& out, TTStats& stats) const {
+    ++stats.probes;
+    const Bucket& b = bucketFor(key);
+    for (const auto& s : b.slots) {
+        uint64_t d = s.data.load(memory_order_relaxed);
+        uint64_t c = s.check.load(memory_order_relaxed);
+        if ((c ^ d) != key || boundOf(d) == Bound::None) continue;
+
+        out.score = (int)(d & 0xFF) - 128;
+        out.bound = boundOf(d);
+        out.bestMove = (int)((d >> 10) & 0xF) - 1;
+        out.depth = depthOf(d);
+        ++stats.hits;
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int score, Bound bound, int bestMove, int depth,
+                               TTStats& stats) {
+    // Reihenfolge: gleiche Stellung > freier Slot > flachster Eintrag
+    Bucket& b = bucketFor(key);
+    Slot* same = nullptr;
+    Slot* empty = nullptr;
+    Slot* shallowest = nullptr;
+    int minDepth = 1 << 30;
+
+    for (auto& s : b.slots) {
+        uint64_t d = s.data.load(memory_order_relaxed);
+        uint64_t c = s.check.load(memory_order_relaxed);
+        if (boundOf(d) == Bound::None) {
+            if (!empty) empty = &s;
+        } else if ((c ^ d) == key) {
+            // tiefere Ergebnisse nicht durch flachere überschreiben
+            if (depth < depthOf(d)) return;
+            same = &s;
+            break;
+        } else if (depthOf(d) < minDepth) {
+            minDepth = depthOf(d);
+            shallowest = &s;
+        }
+    }
+
+    Slot* victim = same ? same : (empty ? empty : shallowest);
+    if (victim == shallowest) ++stats.collisions;
+
+    uint64_t d = pack(score, bound, bestMove, depth);
+    victim->data.store(d, memory_order_relaxed);
+    victim->check.store(key ^ d, memory_order_relaxed);
+    ++stats.stores;
+}
+
+double TranspositionTable::fillRatio() const {
+    size_t n = min<size_t>(buckets.size(), 4096);
+    size_t used = 0;
+    for (size_t i = 0; i < n; ++i)
+        for (const auto& s : buckets[i].slots)
+            if (boundOf(s.data.load(memory_order_relaxed)) != Bound::None) ++used;
+    return n ? (double)used / (double)(n * BUCKET_SIZE) : 0.0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Art des gespeicherten Scores
+enum class Bound : uint8_t {
+    None = 0,
+    Exact = 1,
+    Lower = 2,   // echter Wert >= score (Beta-Schnitt)
+    Upper = 3    // echter Wert <= score (kein Zug erreichte Alpha)
+};
+
+struct TTEntry {
+    int score = 0;
+    Bound bound = Bound::None;
+    int bestMove = -1;  // Spalte oder -1
+    int depth = 0;      // Resttiefe der Suche, die den Eintrag erzeugt hat
+};
+
+// Zähler pro Suchthread; werden vom Aufrufer geführt, damit sich mehrere
+// Threads keine Cache-Line für Statistik teilen müssen
+struct TTStats {
+    unsigned long long probes = 0;
+    unsigned long long hits = 0;
+    unsigned long long stores = 0;
+    unsigned long long collisions = 0; // fremde Stellung verdrängt
+
+    double hitRate() const { return probes ? (double)hits / (double)probes : 0.0; }
+    TTStats& operator+=(const TTStats& o) {
+        probes += o.probes; hits += o.hits; stores += o.stores; collisions += o.collisions;
+        return *this;
+    }
+};
+
+// Transpositionstabelle fester Größe, lock-frei:
+// Pro Eintrag zwei 64-Bit-Wörter (key ^ data, data). Ein Leser akzeptiert
+// den Eintrag nur, wenn das XOR wieder den Schlüssel ergibt; halb
+// geschriebene Einträge anderer Threads fallen so als Fehltreffer heraus.
+// 4 Einträge bilden einen 64-Byte-Bucket (eine Cache-Line).
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes);
+
+    void resize(size_t megabytes);
+    void clear();
+
+    bool probe(uint64_t key, TTEntry& out, TTStats& stats) const;
+    void store(uint64_t key, int score, Bound bound, int bestMove, int depth, TTStats& stats);
+
+    // Anteil belegter Einträge (Stichprobe über die ersten Buckets)
+    double fillRatio() const;
+
+    size_t entryCount() const { return buckets.size() * BUCKET_SIZE; }
+    size_t sizeBytes() const { return buckets.size() * sizeof(Bucket); }
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+
+    struct Slot {
+        std::atomic<uint64_t> check{0}; // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    std::vector<Bucket> buckets;
+    int indexBits = 0;
+
+    const Bucket& bucketFor(uint64_t key) const {
+        return buckets[(key * 0x9E3779B97F4A7C15ULL) >> (64 - indexBits)];
+    }
+    Bucket& bucketFor(uint64_t key) {
+        return buckets[(key * 0x9E3779B97F4A7C15ULL) >> (64 - indexBits)];
+    }
+
+    // data-Layout: [0..7] score+128 | [8..9] bound | [10..13] move+1 | [14..21] depth
+    static uint64_t pack(int score, Bound bound, int bestMove, int depth) {
+        return (uint64_t)(uint8_t)(score + 128)
+             | (uint64_t)bound << 8
+             | (uint64_t)(bestMove + 1) << 10
+             | (uint64_t)(uint8_t)depth << 14;
+    }
+    static Bound boundOf(uint64_t d) { return (Bound)((d >> 8) & 3); }
+    static int depthOf(uint64_t d) { return (int)((d >> 14) & 0xFF); }
+};
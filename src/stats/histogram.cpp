@@ -0,0 +1,116 @@
+#include "histogram.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+    // Dezimalzahl ohne Vorzeichen; false wenn keine Ziffer oder zu lang
+    bool parseUnsigned(string_view& s, uint64_t& v) {
+        size_t i = 0;
+        v = 0;
+        while (i < s.size() && i < 19 && static_cast<unsigned>(s[i] - '0') < 10) v = v * 10 + (s[i++] - '0');
+        if (i == 0 || (i < s.size() && static_cast<unsigned>(s[i] - '0') < 10)) return false;
+        s.remove_prefix(i);
+        return true;
+    }
+}
+
+int LatencyHistogram::bucketOf(long long ms) {
+    if (ms < 2 * SUB_BUCKETS) return ms < 0 ? 0 : static_cast<int>(ms);
+    const int e = 63 - __builtin_clzll(static_cast<unsigned long long>(ms));
+    if (e > MAX_EXPONENT) return BUCKETS - 1;
+    return (e - 4) * SUB_BUCKETS + static_cast<int>(ms >> (e - 4));
+}
+
+long long LatencyHistogram::bucketLow(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) return bucket;
+    const int shift = bucket / SUB_BUCKETS - 1;
+    return static_cast<long long>(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+}
+
+long long LatencyHistogram::bucketHigh(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) return bucket;
+    return bucketLow(bucket) + (1LL << (bucket / SUB_BUCKETS - 1)) - 1;
+}
+
+void LatencyHistogram::record(long long ms, uint64_t n) {
+    add(bucketOf(ms), n);
+}
+
+void LatencyHistogram::add(int bucket, uint64_t n) {
+    counts[bucket] += n;
+    total += n;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.total == 0) return;
+    for (int i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+    total += other.total;
+}
+
+long long LatencyHistogram::percentile(double p) const {
+    if (total == 0) return -1;
+    // Rang des gesuchten Zugs (1-basiert), mindestens der erste
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+    rank = max<uint64_t>(1, min(rank, total));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return (bucketLow(i) + bucketHigh(i)) / 2;
+    }
+    return bucketHigh(BUCKETS - 1);
+}
+
+void LatencyHistogram::appendText(string& out) const {
+    bool first = true;
+    for (int i = 0; i < BUCKETS; ++i) {
+        if (!counts[i]) continue;
+        if (!first) out += ';';
+        out += to_string(i);
+        out += ':';
+        out += to_string(counts[i]);
+        first = false;
+    }
+}
+
+void LatencyHistogram::appendText(vector<long long> times, string& out) {
+    for (long long& t : times) t = bucketOf(t);
+    sort(times.begin(), times.end());
+    for (size_t i = 0; i < times.size();) {
+        size_t j = i;
+        while (j < times.size() && times[j] == times[i]) ++j;
+        if (i > 0) out += ';';
+        out += to_string(times[i]);
+        out += ':';
+        out += to_string(j - i);
+        i = j;
+    }
+}
+
+bool LatencyHistogram::parseText(string_view s, vector<Entry>& out) {
+    while (!s.empty()) {
+        uint64_t bucket, n;
+        if (!parseUnsigned(s, bucket) || s.empty() || s[0] != ':') return false;
+        s.remove_prefix(1);
+        if (!parseUnsigned(s, n) || bucket >= static_cast<uint64_t>(BUCKETS)) return false;
+        if (!s.empty()) {
+            if (s[0] != ';' || s.size() == 1) return false;
+            s.remove_prefix(1);
+        }
+        out.push_back({static_cast<int>(bucket), n});
+    }
+    return true;
+}
+
+void LatencyHistogram::add(const vector<Entry>& entries) {
+    for (const Entry& e : entries) add(e.bucket, e.n);
+}
+
+bool LatencyHistogram::addText(string_view text) {
+    // erst ganz lesen, dann zählen: kaputter Text soll nichts hinterlassen
+    vector<Entry> entries;
+    if (!parseText(text, entries)) return false;
+    add(entries);
+    return true;
+}
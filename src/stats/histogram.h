@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Zugzeiten-Histogramm mit logarithmischen Fächern (HDR-Art): 0..31 ms
+// exakt, darüber 16 Fächer pro Zweierpotenz (höchstens 6,25 % Fehler).
+// Feste Größe, egal wie viele Züge eingetragen werden; Werte ab 2^31 ms
+// landen im letzten Fach.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKETS = 16;
+    static constexpr int MAX_EXPONENT = 31;
+    static constexpr int BUCKETS = (MAX_EXPONENT - 4) * SUB_BUCKETS + 2 * SUB_BUCKETS;
+
+    static int bucketOf(long long ms);
+    static long long bucketLow(int bucket);
+    static long long bucketHigh(int bucket);   // einschließlich
+
+    void record(long long ms, uint64_t n = 1);
+    void add(int bucket, uint64_t n);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return total; }
+    uint64_t at(int bucket) const { return counts[bucket]; }
+
+    // Wert, unter dem p Prozent der Züge liegen (Fachmitte); -1 = leer
+    long long percentile(double p) const;
+
+    // Ein Fach samt Anzahl, wie es im Text steht
+    struct Entry {
+        int bucket;
+        uint64_t n;
+    };
+
+    // Dünn besetzt als Text für stats.csv: "fach:anzahl;fach:anzahl", leer = keine Werte
+    void appendText(std::string& out) const;
+    // Zählt die Werte aus dem Text dazu; false bei kaputtem Text (dann unverändert)
+    bool addText(std::string_view text);
+    // Liest den Text in einem Durchgang nach out (wird angehängt), gezählt
+    // wird erst mit add(out). false bei kaputtem Text
+    static bool parseText(std::string_view text, std::vector<Entry>& out);
+    void add(const std::vector<Entry>& entries);
+
+    // Dasselbe Textformat direkt aus einzelnen Zugzeiten (ohne volles Histogramm)
+    static void appendText(std::vector<long long> times, std::string& out);
+
+private:
+    uint64_t counts[BUCKETS] = {};
+    uint64_t total = 0;
+};
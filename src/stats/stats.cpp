@@ -1,11 +1,25 @@
 #include "stats.h"
 
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <unordered_map>
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/mappedfile.h"
 
 using namespace std;
 
@@ -15,6 +29,622 @@ static void updateMinMax(long long v, long long& mn, long long& mx) {
     if (mx < 0 || v > mx) mx = v;
 }
 
+namespace {
+    // Kommt in eine leere Datei. Ältere stats.csv (12 Spalten, ohne
+    // hist0/hist1) bekommen sie beim ersten Anhängen (upgradeHeader); die
+    // Zeilen darunter bleiben, wie sie sind. Der Parser überspringt die
+    // Kopfzeile ungelesen und nimmt beide Zeilenformate
+    const char* CSV_HEADER = "player0,player1,result,totalGameMs,"
+                             "moves0,moves1,totalMs0,totalMs1,fastest0,fastest1,slowest0,slowest1,"
+                             "hist0,hist1\n";
+
+    void appendRow(string& buf, const GameSummary& g) {
+        buf += g.players[0]; buf += ',';
+        buf += g.players[1]; buf += ',';
+        const long long values[] = {
+            g.result, g.totalGameMs, g.moves[0], g.moves[1], g.totalMs[0], g.totalMs[1],
+            g.fastest[0], g.fastest[1], g.slowest[0], g.slowest[1]
+        };
+        for (long long v : values) {
+            buf += to_string(v);
+            buf += ',';
+        }
+        // Zugzeiten als Histogramm-Fächer ("fach:anzahl;..."), siehe LatencyHistogram
+        LatencyHistogram::appendText(g.moveTimes[0], buf);
+        buf += ',';
+        LatencyHistogram::appendText(g.moveTimes[1], buf);
+        buf += '\n';
+    }
+
+    // write() kann kürzer schreiben oder unterbrochen werden
+    bool writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Kopfzeile einer älteren Version (ohne hist0/hist1)? fd: lesbar
+    bool hasOldHeader(int fd) {
+        char buf[256];
+        const ssize_t n = pread(fd, buf, sizeof(buf), 0);
+        if (n <= 0) return false;
+        const string_view head(buf, static_cast<size_t>(n));
+        const string_view first = head.substr(0, head.find('\n'));
+        return first.rfind("player0,player1,", 0) == 0 && first.find("hist0,hist1") == string_view::npos;
+    }
+
+    // Schreibt die Datei mit aktueller Kopfzeile neu (Temp-Datei + rename),
+    // rows gleich mit ans Ende. Nur unter der Sperre des Aufrufers
+    bool upgradeHeader(const string& filenameCsv, const string& rows) {
+        MappedFile old;
+        if (!old.open(filenameCsv)) return false;
+        const char* data = reinterpret_cast<const char*>(old.data());
+        const char* nl = static_cast<const char*>(memchr(data, '\n', old.size()));
+        if (!nl) return false;
+        const string tmp = filenameCsv + ".tmp";
+        {
+            ofstream out(tmp, ios::binary | ios::trunc);
+            out << CSV_HEADER;
+            out.write(nl + 1, static_cast<streamsize>(data + old.size() - (nl + 1)));
+            out << rows;
+            if (!out.flush()) return false;
+        }
+        return rename(tmp.c_str(), filenameCsv.c_str()) == 0;
+    }
+
+    // Format <csv>.snap (native Byte-Reihenfolge):
+    //   "C4STATS2", uint64 Offset, uint32 Hash der 64 Byte vor Offset,
+    //   uint32 Anzahl, pro Spieler: uint16 Namenslänge, Name,
+    //   int32 games/wins/draws/losses, int64 moves/totalMoveMs/fastest/slowest,
+    //   uint16 belegte Histogramm-Fächer, je uint16 Fach + uint64 Anzahl,
+    //   danach uint8 Paarungen gezählt (0/1), wenn 1: uint32 Anzahl Paarungen,
+    //   je uint32 a/b (Position in der Spielerliste) + uint32 Partien mit
+    //   Ergebnis, am Ende uint32 FNV-1a über alles davor
+    const char SNAPSHOT_MAGIC[8] = {'C', '4', 'S', 'T', 'A', 'T', 'S', '4'};
+    constexpr uint64_t TAIL_BYTES = 64;
+
+    uint32_t fnv1a(const char* data, size_t size, uint32_t h = 2166136261u) {
+        for (size_t i = 0; i < size; ++i) {
+            h ^= static_cast<uint8_t>(data[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // Erkennt, ob die CSV bis offset noch dieselbe ist (ohne sie ganz zu lesen)
+    uint32_t tailHash(const char* csv, uint64_t offset) {
+        const uint64_t from = offset > TAIL_BYTES ? offset - TAIL_BYTES : 0;
+        return fnv1a(csv + from, static_cast<size_t>(offset - from));
+    }
+
+    template <typename T>
+    void put(string& buf, T v) {
+        buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    template <typename T>
+    bool get(const string& buf, size_t& pos, T& v) {
+        if (buf.size() - pos < sizeof(v)) return false;
+        memcpy(&v, buf.data() + pos, sizeof(v));
+        pos += sizeof(v);
+        return true;
+    }
+
+    uint64_t mix(uint64_t h) {
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    // Partien pro Spielerpaar (kleinerer Index zuerst). Reicht für Elo:
+    // die Punkte jedes Spielers stehen schon in PlayerStats. Paare unter
+    // den ersten DENSE Spielern als Dreiecksmatrix (ein Zugriff pro Zeile,
+    // passt in den L2-Cache), alle anderen per offener Adressierung
+    class PairCounts {
+    public:
+        void add(uint32_t a, uint32_t b, uint32_t games = 1) {
+            if (a > b) swap(a, b);
+            if (b < DENSE) {
+                const size_t at = static_cast<size_t>(b) * (b - 1) / 2 + a;
+                if (at >= dense.size()) dense.resize(static_cast<size_t>(b + 1) * b / 2, 0);
+                uint32_t& cell = dense[at];
+                used += cell == 0;
+                cell += games;
+                return;
+            }
+            if ((sparseUsed + 1) * 2 > slots.size()) grow();
+            const size_t mask = slots.size() - 1;
+            for (size_t i = mix((static_cast<uint64_t>(a) << 32) | b) & mask;; i = (i + 1) & mask) {
+                Slot& s = slots[i];
+                if (s.games == 0) {
+                    s = {a, b, games};
+                    ++sparseUsed;
+                    ++used;
+                    return;
+                }
+                if (s.a == a && s.b == b) {
+                    s.games += games;
+                    return;
+                }
+            }
+        }
+
+        template <typename F>
+        void forEach(F&& f) const {
+            size_t at = 0;
+            for (uint32_t b = 1; at < dense.size(); ++b)
+                for (uint32_t a = 0; a < b; ++a, ++at)
+                    if (dense[at]) f(a, b, dense[at]);
+            for (const Slot& s : slots)
+                if (s.games) f(s.a, s.b, s.games);
+        }
+
+        size_t size() const { return used; }
+
+        void clear() {
+            dense.clear();
+            slots.clear();
+            used = sparseUsed = 0;
+        }
+
+    private:
+        static constexpr uint32_t DENSE = 1024;   // Matrix höchstens 2 MB
+
+        struct Slot { uint32_t a, b, games; };   // games 0 = frei
+        vector<uint32_t> dense;                   // Paar (a < b) an b * (b - 1) / 2 + a
+        vector<Slot> slots;
+        size_t used = 0;
+        size_t sparseUsed = 0;
+
+        void grow() {
+            vector<Slot> old(max<size_t>(64, slots.size() * 2), Slot{0, 0, 0});
+            old.swap(slots);
+            for (const Slot& s : old) {
+                if (!s.games) continue;
+                const size_t mask = slots.size() - 1;
+                size_t i = mix((static_cast<uint64_t>(s.a) << 32) | s.b) & mask;
+                while (slots[i].games) i = (i + 1) & mask;
+                slots[i] = s;
+            }
+        }
+    };
+
+    // Alle Spieler in fester Reihenfolge, Paarungen über die Position
+    struct Aggregate {
+        vector<PlayerStats> players;
+        unordered_map<string, uint32_t> ids;
+        PairCounts pairs;
+        bool withPairs = false;   // pairs deckt alle gelesenen Zeilen ab
+
+        uint32_t id(const string& name) {
+            auto it = ids.find(name);
+            if (it != ids.end()) return it->second;
+            const uint32_t i = static_cast<uint32_t>(players.size());
+            ids.emplace(name, i);
+            players.emplace_back();
+            players.back().name = name;
+            return i;
+        }
+
+        void clear() {
+            players.clear();
+            ids.clear();
+            pairs.clear();
+            withPairs = false;
+        }
+    };
+
+    bool readSnapshot(const string& path, Aggregate& stats, uint64_t& offset, uint32_t& tail) {
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+        string buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        if (buf.size() < sizeof(SNAPSHOT_MAGIC) + 20
+            || memcmp(buf.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) return false;
+
+        size_t pos = buf.size() - 4;
+        uint32_t sum;
+        if (!get(buf, pos, sum) || sum != fnv1a(buf.data(), buf.size() - 4)) return false;
+        buf.resize(buf.size() - 4);
+
+        pos = sizeof(SNAPSHOT_MAGIC);
+        uint32_t count;
+        if (!get(buf, pos, offset) || !get(buf, pos, tail) || !get(buf, pos, count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            PlayerStats s;
+            uint16_t len;
+            int32_t counts[4];
+            if (!get(buf, pos, len) || buf.size() - pos < len) return false;
+            s.name.assign(buf, pos, len);
+            pos += len;
+            for (int32_t& c : counts)
+                if (!get(buf, pos, c)) return false;
+            s.games = counts[0]; s.wins = counts[1]; s.draws = counts[2]; s.losses = counts[3];
+            uint16_t used;
+            if (!get(buf, pos, s.moves) || !get(buf, pos, s.totalMoveMs)
+                || !get(buf, pos, s.fastestMoveMs) || !get(buf, pos, s.slowestMoveMs)
+                || !get(buf, pos, used)) return false;
+            for (uint16_t k = 0; k < used; ++k) {
+                uint16_t bucket;
+                uint64_t n;
+                if (!get(buf, pos, bucket) || !get(buf, pos, n) || bucket >= LatencyHistogram::BUCKETS)
+                    return false;
+                s.moveTimes.add(bucket, n);
+            }
+            if (stats.ids.count(s.name)) return false;
+            stats.players[stats.id(s.name)] = move(s);
+        }
+        uint8_t withPairs;
+        if (!get(buf, pos, withPairs) || withPairs > 1) return false;
+        stats.withPairs = withPairs;
+        uint32_t pairCount = 0;
+        if (withPairs && !get(buf, pos, pairCount)) return false;
+        for (uint32_t k = 0; k < pairCount; ++k) {
+            uint32_t pair[3];
+            for (uint32_t& v : pair)
+                if (!get(buf, pos, v)) return false;
+            if (pair[0] >= count || pair[1] >= count || pair[0] == pair[1] || pair[2] == 0) return false;
+            stats.pairs.add(pair[0], pair[1], pair[2]);
+        }
+        return pos == buf.size();
+    }
+
+    // atomar per rename: ein abgebrochener Lauf hinterlässt den alten Snapshot
+    bool writeSnapshot(const string& path, const Aggregate& stats, uint64_t offset, uint32_t tail) {
+        string buf(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        put(buf, offset);
+        put(buf, tail);
+        put(buf, static_cast<uint32_t>(stats.players.size()));
+        for (const PlayerStats& s : stats.players) {
+            const size_t len = min<size_t>(s.name.size(), UINT16_MAX);
+            put(buf, static_cast<uint16_t>(len));
+            buf.append(s.name, 0, len);
+            put(buf, static_cast<int32_t>(s.games));
+            put(buf, static_cast<int32_t>(s.wins));
+            put(buf, static_cast<int32_t>(s.draws));
+            put(buf, static_cast<int32_t>(s.losses));
+            put(buf, static_cast<int64_t>(s.moves));
+            put(buf, static_cast<int64_t>(s.totalMoveMs));
+            put(buf, static_cast<int64_t>(s.fastestMoveMs));
+            put(buf, static_cast<int64_t>(s.slowestMoveMs));
+            uint16_t used = 0;
+            for (int b = 0; b < LatencyHistogram::BUCKETS; ++b) used += s.moveTimes.at(b) != 0;
+            put(buf, used);
+            for (int b = 0; b < LatencyHistogram::BUCKETS; ++b) {
+                if (!s.moveTimes.at(b)) continue;
+                put(buf, static_cast<uint16_t>(b));
+                put(buf, s.moveTimes.at(b));
+            }
+        }
+        put(buf, static_cast<uint8_t>(stats.withPairs));
+        if (stats.withPairs) {
+            put(buf, static_cast<uint32_t>(stats.pairs.size()));
+            stats.pairs.forEach([&](uint32_t a, uint32_t b, uint32_t games) {
+                put(buf, a);
+                put(buf, b);
+                put(buf, games);
+            });
+        }
+        put(buf, fnv1a(buf.data(), buf.size()));
+
+        const string tmp = path + ".tmp";
+        {
+            ofstream out(tmp, ios::binary | ios::trunc);
+            if (!out) return false;
+            out.write(buf.data(), static_cast<streamsize>(buf.size()));
+            if (!out) return false;
+        }
+        return rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    void merge(PlayerStats& into, const PlayerStats& s) {
+        into.games += s.games;
+        into.wins += s.wins;
+        into.draws += s.draws;
+        into.losses += s.losses;
+        into.moves += s.moves;
+        into.totalMoveMs += s.totalMoveMs;
+        updateMinMax(s.fastestMoveMs, into.fastestMoveMs, into.slowestMoveMs);
+        updateMinMax(s.slowestMoveMs, into.fastestMoveMs, into.slowestMoveMs);
+        into.moveTimes.merge(s.moveTimes);
+    }
+
+    // Spieler eines Chunks: offene Adressierung, Schlüssel zeigen in die
+    // eingeblendete CSV. Pro Zeile keine Allokation, solange kein neuer
+    // Spieler auftaucht.
+    class ChunkStats {
+    public:
+        // name muss in einer gültigen Zeile liegen (dahinter folgen noch
+        // mindestens 8 Byte), hash() liest immer ein ganzes Wort
+        uint32_t index(string_view name) {
+            if ((names.size() + 1) * 2 > slots.size()) grow();
+            const size_t mask = slots.size() - 1;
+            for (size_t i = hash(name) & mask;; i = (i + 1) & mask) {
+                const uint32_t slot = slots[i];
+                if (slot == 0) {
+                    names.push_back(name);
+                    players.emplace_back();
+                    slots[i] = static_cast<uint32_t>(names.size());
+                    return slots[i] - 1;
+                }
+                if (names[slot - 1] == name) return slot - 1;
+            }
+        }
+
+        PlayerStats& operator[](uint32_t i) { return players[i]; }
+
+        // getrennt: die Namen für den Vergleich liegen dicht beieinander,
+        // die (großen) Werte samt Histogramm nur einmal pro Zeile angefasst
+        vector<string_view> names;
+        vector<PlayerStats> players;
+        PairCounts pairs;   // Partien mit Ergebnis, über die Indizes oben
+        bool countPairs = false;   // nur für Elo: ein Zugriff auf die Matrix pro Zeile
+        // Histogramme der aktuellen Zeile, gezählt erst wenn die ganze Zeile
+        // stimmt; behalten ihre Kapazität, also keine Allokation pro Zeile
+        vector<LatencyHistogram::Entry> rowTimes[2];
+
+    private:
+        vector<uint32_t> slots;  // Index + 1, 0 = frei
+
+        // erste und letzte 8 Byte + Länge: bei Namen bis 16 Zeichen exakt,
+        // längere unterscheidet notfalls der Vergleich
+        static uint64_t hash(string_view s) {
+            uint64_t a, b = 0;
+            memcpy(&a, s.data(), 8);
+            if (s.size() >= 8) memcpy(&b, s.data() + s.size() - 8, 8);
+            else a &= (uint64_t(1) << (8 * s.size())) - 1;
+            return mix(mix(a ^ (s.size() * 0x9E3779B97F4A7C15ull)) ^ b);
+        }
+
+        void grow() {
+            slots.assign(max<size_t>(64, slots.size() * 2), 0);
+            const size_t mask = slots.size() - 1;
+            for (size_t k = 0; k < names.size(); ++k) {
+                size_t i = hash(names[k]) & mask;
+                while (slots[i]) i = (i + 1) & mask;
+                slots[i] = static_cast<uint32_t>(k + 1);
+            }
+        }
+    };
+
+    struct Chunk {
+        ChunkStats stats;
+        CsvParseInfo info;
+    };
+
+    // Ganzzahl bis zum Trennzeichen; nullptr = keine gültige Zahl
+    const char* parseNumber(const char* p, const char* end, long long& v) {
+        const bool negative = p < end && *p == '-';
+        if (negative) ++p;
+        // schneller Weg: bis zu 7 Ziffern aus einem 8-Byte-Wort, ohne Sprung pro Ziffer
+        if (end - p >= 8) {
+            uint64_t w;
+            memcpy(&w, p, 8);
+            const uint64_t t = w ^ 0x3030303030303030ull;  // Ziffern werden zu 0..9
+            const uint64_t nonDigit = (((t & 0x7F7F7F7F7F7F7F7Full) + 0x7676767676767676ull) | t)
+                                      & 0x8080808080808080ull;
+            const int n = nonDigit ? __builtin_ctzll(nonDigit) / 8 : 8;
+            if (n == 0) return nullptr;
+            if (n < 8) {
+                uint64_t x = t << (8 * (8 - n));   // führende Nullen davor
+                x = ((x & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+                x = ((x & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+                x = ((x & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+                v = negative ? -static_cast<long long>(x) : static_cast<long long>(x);
+                return p + n;
+            }
+        }
+        const char* first = p;
+        long long x = 0;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10 && p - first < 18) x = x * 10 + (*p++ - '0');
+        if (p == first || (p < end && static_cast<unsigned>(*p - '0') < 10)) return nullptr;
+        v = negative ? -x : x;
+        return p;
+    }
+
+    // Erstes ',' oder '\n' ab p (oder end), 8 Byte pro Schritt
+    const char* findSeparator(const char* p, const char* end) {
+        constexpr uint64_t ONES = 0x0101010101010101ull, HIGH = 0x8080808080808080ull;
+        for (; end - p >= 8; p += 8) {
+            uint64_t w;
+            memcpy(&w, p, 8);
+            const uint64_t comma = w ^ (ONES * ','), newline = w ^ (ONES * '\n');
+            const uint64_t zero = ((comma - ONES) & ~comma & HIGH) | ((newline - ONES) & ~newline & HIGH);
+            if (zero) return p + __builtin_ctzll(zero) / 8;
+        }
+        while (p < end && *p != ',' && *p != '\n') ++p;
+        return p;
+    }
+
+    // Eine Zeile ab p in einem Durchgang: 2 Namen + 10 Zahlen, dahinter
+    // optional die Histogramme beider Spieler (ältere CSVs haben sie nicht).
+    // Rückgabe: Zeilenende (auf '\n' oder end), nullptr = Zeile kaputt
+    const char* addRow(ChunkStats& stats, const char* p, const char* end) {
+        const char* name[2];
+        size_t len[2];
+        for (int i = 0; i < 2; ++i) {
+            name[i] = p;
+            p = findSeparator(p, end);
+            if (p == end || *p != ',') return nullptr;
+            len[i] = static_cast<size_t>(p++ - name[i]);
+        }
+
+        // result, totalGameMs, moves0, moves1, totalMs0, totalMs1, fastest0, fastest1, slowest0, slowest1
+        long long v[10];
+        for (int i = 0; i < 10; ++i) {
+            if (!(p = parseNumber(p, end, v[i]))) return nullptr;
+            if (i < 9) {
+                if (p == end || *p != ',') return nullptr;
+                ++p;
+            }
+        }
+        string_view hist[2];
+        stats.rowTimes[0].clear();
+        stats.rowTimes[1].clear();
+        if (p < end && *p == ',') {
+            for (int i = 0; i < 2; ++i) {
+                const char* field = ++p;
+                p = findSeparator(p, end);
+                hist[i] = string_view(field, static_cast<size_t>(p - field));
+                if (i == 0 && (p == end || *p != ',')) return nullptr;
+            }
+            if (!hist[1].empty() && hist[1].back() == '\r') hist[1].remove_suffix(1);
+            if (!LatencyHistogram::parseText(hist[0], stats.rowTimes[0])
+                || !LatencyHistogram::parseText(hist[1], stats.rowTimes[1])) return nullptr;
+        }
+        if (p < end && *p == '\r') ++p;
+        if (p < end && *p != '\n') return nullptr;
+        const long long result = v[0];
+        if (result < -1 || result > 2) return nullptr;
+
+        const uint32_t id0 = stats.index(string_view(name[0], len[0]));
+        const uint32_t id1 = stats.index(string_view(name[1], len[1]));
+        PlayerStats* ps[2] = {&stats[id0], &stats[id1]};
+        for (int i = 0; i < 2; ++i) {
+            PlayerStats& s = *ps[i];
+            s.games++;
+            s.moves += v[2 + i];
+            s.totalMoveMs += v[4 + i];
+            updateMinMax(v[6 + i], s.fastestMoveMs, s.slowestMoveMs);
+            updateMinMax(v[8 + i], s.fastestMoveMs, s.slowestMoveMs);
+            s.moveTimes.add(stats.rowTimes[i]);
+        }
+        PlayerStats& s0 = *ps[0];
+        PlayerStats& s1 = *ps[1];
+        if (result == 0) { s0.draws++; s1.draws++; }
+        else if (result == 1) { s0.wins++; s1.losses++; }
+        else if (result == 2) { s1.wins++; s0.losses++; }
+        if (stats.countPairs && result >= 0 && id0 != id1) stats.pairs.add(id0, id1);
+        return p;
+    }
+
+    // [begin, end) enthält nur vollständige Zeilen; base = Byte-Position von begin
+    void parseChunk(const char* begin, const char* end, uint64_t base, Chunk& out) {
+        for (const char* p = begin; p < end;) {
+            if (*p == '\n') { ++p; continue; }
+            const char* next = addRow(out.stats, p, end);
+            if (next) {
+                out.info.rows++;
+            } else {
+                if (out.info.badRows == 0) out.info.firstBadOffset = static_cast<long long>(base + (p - begin));
+                out.info.badRows++;
+                next = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+                if (!next) next = end;
+            }
+            p = next + 1;
+        }
+    }
+
+    // Auf Zeilengrenzen aufteilen und parallel parsen; kleine Bereiche in einem Thread
+    CsvParseInfo parseRows(const char* begin, const char* end, uint64_t base, int threads,
+                           Aggregate& into) {
+        constexpr size_t MIN_CHUNK = 1 << 20;
+        const size_t size = static_cast<size_t>(end - begin);
+        if (threads <= 0) threads = static_cast<int>(thread::hardware_concurrency());
+        threads = static_cast<int>(max<size_t>(1, min<size_t>(max(threads, 1), size / MIN_CHUNK)));
+
+        vector<Chunk> chunks(static_cast<size_t>(threads));
+        for (Chunk& c : chunks) c.stats.countPairs = into.withPairs;
+        vector<const char*> cuts{begin};
+        for (int t = 1; t < threads; ++t) {
+            const char* cut = begin + size * t / threads;
+            if (cut < cuts.back()) cut = cuts.back();
+            const char* nl = static_cast<const char*>(memchr(cut, '\n', static_cast<size_t>(end - cut)));
+            cuts.push_back(nl ? nl + 1 : end);
+        }
+        cuts.push_back(end);
+
+        vector<thread> workers;
+        for (int t = 1; t < threads; ++t)
+            workers.emplace_back(parseChunk, cuts[t], cuts[t + 1], base + (cuts[t] - begin), ref(chunks[t]));
+        parseChunk(cuts[0], cuts[1], base, chunks[0]);
+        for (auto& w : workers) w.join();
+
+        CsvParseInfo info;
+        for (const Chunk& c : chunks) {
+            vector<uint32_t> global(c.stats.names.size());
+            for (size_t k = 0; k < c.stats.names.size(); ++k) {
+                global[k] = into.id(string(c.stats.names[k]));
+                merge(into.players[global[k]], c.stats.players[k]);
+            }
+            c.stats.pairs.forEach([&](uint32_t a, uint32_t b, uint32_t games) {
+                into.pairs.add(global[a], global[b], games);
+            });
+            info.rows += c.info.rows;
+            if (c.info.badRows && info.badRows == 0) info.firstBadOffset = c.info.firstBadOffset;
+            info.badRows += c.info.badRows;
+        }
+        return info;
+    }
+}
+
+GameSummary Stats::summarize(const string players[2], int result, const vector<Move>& moves) {
+    GameSummary g;
+    g.players[0] = players[0];
+    g.players[1] = players[1];
+    g.result = result;
+    for (const auto& m : moves) {
+        int p = m.playerIndex;
+        g.totalGameMs += m.moveTimeMs;
+        g.moves[p]++;
+        g.moveTimes[p].push_back(m.moveTimeMs);
+        g.totalMs[p] += m.moveTimeMs;
+        if (g.fastest[p] < 0 || m.moveTimeMs < g.fastest[p]) g.fastest[p] = m.moveTimeMs;
+        if (g.slowest[p] < 0 || m.moveTimeMs > g.slowest[p]) g.slowest[p] = m.moveTimeMs;
+    }
+    return g;
+}
+
+void Stats::formatRow(string& buf, const GameSummary& g) {
+    appendRow(buf, g);
+}
+
+bool Stats::appendRows(const string& filenameCsv, const string& rows) {
+    while (true) {
+        int fd = ::open(filenameCsv.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        // Sperre über Prozesse hinweg: Kopfzeile nur einmal, Zeilen nie verschränkt
+        if (flock(fd, LOCK_EX) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        // Hat ein anderer während des Wartens die Kopfzeile erneuert, hängt fd
+        // an der alten, schon ersetzten Datei: neu öffnen
+        struct stat st{}, current{};
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && (stat(filenameCsv.c_str(), &current) != 0 || current.st_ino != st.st_ino
+                   || current.st_dev != st.st_dev)) {
+            flock(fd, LOCK_UN);
+            ::close(fd);
+            continue;
+        }
+
+        if (ok && st.st_size > 0 && hasOldHeader(fd)) {
+            ok = upgradeHeader(filenameCsv, rows);
+        } else {
+            string withHeader;
+            if (ok && st.st_size == 0) withHeader = CSV_HEADER + rows;
+            const string& data = withHeader.empty() ? rows : withHeader;
+            ok = ok && writeAll(fd, data.data(), data.size());
+        }
+
+        flock(fd, LOCK_UN);
+        return ::close(fd) == 0 && ok;
+    }
+}
+
+bool Stats::appendGames(const string& filenameCsv, const vector<GameSummary>& games) {
+    string buf;
+    buf.reserve(games.size() * 64);
+    for (const auto& g : games) appendRow(buf, g);
+    return appendRows(filenameCsv, buf);
+}
+
 bool Stats::appendGame(const string& filenameCsv,
                        const string players[2],
                        int result,
@@ -27,86 +657,68 @@ bool Stats::appendGame(const string& filenameCsv,
                        long long fastestP1,
                        long long slowestP0,
                        long long slowestP1) {
-    bool writeHeader = false;
-    { ifstream test(filenameCsv); if (!test.good()) writeHeader = true; }
-
-    ofstream out(filenameCsv, ios::app);
-    if (!out) return false;
-
-    if (writeHeader) {
-        out << "player0,player1,result,totalGameMs,"
-               "moves0,moves1,totalMs0,totalMs1,fastest0,fastest1,slowest0,slowest1\n";
-    }
-
-    out << players[0] << ","
-        << players[1] << ","
-        << result << ","
-        << totalGameMs << ","
-        << movesP0 << ","
-        << movesP1 << ","
-        << totalMsP0 << ","
-        << totalMsP1 << ","
-        << fastestP0 << ","
-        << fastestP1 << ","
-        << slowestP0 << ","
-        << slowestP1 << "\n";
-
-    return true;
+    GameSummary g;
+    g.players[0] = players[0];
+    g.players[1] = players[1];
+    g.result = result;
+    g.totalGameMs = totalGameMs;
+    g.moves[0] = movesP0;     g.moves[1] = movesP1;
+    g.totalMs[0] = totalMsP0; g.totalMs[1] = totalMsP1;
+    g.fastest[0] = fastestP0; g.fastest[1] = fastestP1;
+    g.slowest[0] = slowestP0; g.slowest[1] = slowestP1;
+    return appendGames(filenameCsv, {g});
 }
 
-vector<PlayerStats> Stats::loadAggregated(const string& filenameCsv) {
-    ifstream in(filenameCsv);
-    if (!in) return {};
-
-    string header;
-    getline(in, header);
-
-    unordered_map<string, PlayerStats> mapStats;
-
-    string line;
-    while (getline(in, line)) {
-        if (line.empty()) continue;
-
-        stringstream ss(line);
-        string p0, p1, tok;
-        int result = -1;
-        long long totalGameMs=0, moves0=0, moves1=0, totalMs0=0, totalMs1=0;
-        long long fastest0=-1, fastest1=-1, slowest0=-1, slowest1=-1;
-
-        getline(ss, p0, ',');
-        getline(ss, p1, ',');
-        getline(ss, tok, ','); result = stoi(tok);
-        getline(ss, tok, ','); totalGameMs = stoll(tok);
-        (void)totalGameMs; // unused currently
-        getline(ss, tok, ','); moves0 = stoll(tok);
-        getline(ss, tok, ','); moves1 = stoll(tok);
-        getline(ss, tok, ','); totalMs0 = stoll(tok);
-        getline(ss, tok, ','); totalMs1 = stoll(tok);
-        getline(ss, tok, ','); fastest0 = stoll(tok);
-        getline(ss, tok, ','); fastest1 = stoll(tok);
-        getline(ss, tok, ','); slowest0 = stoll(tok);
-        getline(ss, tok, ','); slowest1 = stoll(tok);
-
-        auto& s0 = mapStats[p0];
-        s0.name = p0; s0.games++;
-        s0.moves += moves0; s0.totalMoveMs += totalMs0;
-        updateMinMax(fastest0, s0.fastestMoveMs, s0.slowestMoveMs);
-        updateMinMax(slowest0, s0.fastestMoveMs, s0.slowestMoveMs);
-
-        auto& s1 = mapStats[p1];
-        s1.name = p1; s1.games++;
-        s1.moves += moves1; s1.totalMoveMs += totalMs1;
-        updateMinMax(fastest1, s1.fastestMoveMs, s1.slowestMoveMs);
-        updateMinMax(slowest1, s1.fastestMoveMs, s1.slowestMoveMs);
+string Stats::snapshotPath(const string& filenameCsv) {
+    return filenameCsv + ".snap";
+}
 
-        if (result == 0) { s0.draws++; s1.draws++; }
-        else if (result == 1) { s0.wins++; s1.losses++; }
-        else if (result == 2) { s1.wins++; s0.losses++; }
+vector<PlayerStats> Stats::loadAggregated(const string& filenameCsv, CsvParseInfo* info, int threads, bool elo) {
+    if (info) *info = CsvParseInfo{};
+    MappedFile file;
+    if (!file.open(filenameCsv) || file.size() == 0) return {};
+    const char* csv = reinterpret_cast<const char*>(file.data());
+    const uint64_t csvSize = file.size();
+
+    Aggregate all;
+    uint64_t offset = 0;
+    uint32_t tail = 0;
+    const string snapPath = snapshotPath(filenameCsv);
+    if (!readSnapshot(snapPath, all, offset, tail)
+        // CSV neu angelegt oder gekürzt? Dann passt der Snapshot nicht mehr
+        || offset > csvSize || tailHash(csv, offset) != tail
+        // Elo verlangt, aber der Snapshot kennt die Paarungen nicht
+        || (elo && !all.withPairs)) {
+        all.clear();
+        offset = 0;
+    }
+    // einmal gezählt, werden die Paarungen weitergeführt (nur die neuen
+    // Zeilen), damit der Snapshot für die nächste Elo-Ansicht reicht
+    if (offset == 0) all.withPairs = elo;
+
+    // nur vollständige Zeilen: eine halb geschriebene wird beim nächsten Mal gelesen
+    const char* begin = csv + offset;
+    const char* end = csv + csvSize;
+    if (offset == 0) {
+        const char* nl = static_cast<const char*>(memchr(begin, '\n', csvSize));  // Kopfzeile
+        if (!nl) return {};
+        begin = nl + 1;
     }
+    while (end > begin && end[-1] != '\n') --end;
 
-    vector<PlayerStats> out;
-    out.reserve(mapStats.size());
-    for (auto& kv : mapStats) out.push_back(kv.second);
+    const CsvParseInfo parsed = parseRows(begin, end, static_cast<uint64_t>(begin - csv), threads, all);
+    if (info) *info = parsed;
+
+    const uint64_t covered = static_cast<uint64_t>(end - csv);
+    if (covered != offset) writeSnapshot(snapPath, all, covered, tailHash(csv, covered));
+
+    vector<PlayerStats> out = move(all.players);
+    if (elo) {
+        vector<PairGames> pairs;
+        pairs.reserve(all.pairs.size());
+        all.pairs.forEach([&](uint32_t a, uint32_t b, uint32_t games) { pairs.push_back({a, b, games}); });
+        computeElo(out, pairs);
+    }
 
     sort(out.begin(), out.end(), [](const PlayerStats& a, const PlayerStats& b){
         return a.wins > b.wins;
@@ -115,8 +727,81 @@ vector<PlayerStats> Stats::loadAggregated(const string& filenameCsv) {
     return out;
 }
 
-void Stats::printReport(const vector<PlayerStats>& stats) {
-    using std::cout;
+void Stats::computeElo(vector<PlayerStats>& stats, const vector<PairGames>& pairs) {
+    const size_t n = stats.size();
+
+    // Bradley-Terry: es reichen die Punkte jedes Spielers und die Partien
+    // pro Paarung. Jede Paarung bekommt ein gedachtes Remis dazu, sonst
+    // läuft die Wertung bei 100 % gegen unendlich
+    struct Opponent { uint32_t index; double games; };
+    vector<vector<Opponent>> opponents(n);
+    vector<double> paired(n, 0.0);
+    for (const PairGames& p : pairs) {
+        if (p.a >= n || p.b >= n || p.a == p.b || p.games <= 0) continue;
+        const double games = static_cast<double>(p.games);
+        opponents[p.a].push_back({p.b, games + 1.0});
+        opponents[p.b].push_back({p.a, games + 1.0});
+        paired[p.a] += games;
+        paired[p.b] += games;
+    }
+    vector<double> score(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        const PlayerStats& s = stats[i];
+        // Partien gegen sich selbst zählen doppelt und bringen genau einen Punkt: herausrechnen
+        const double self = (s.wins + s.draws + s.losses - paired[i]) / 2.0;
+        score[i] = max(0.0, min(paired[i], s.wins + 0.5 * s.draws - self)) + 0.5 * opponents[i].size();
+    }
+
+    // Newton-Schritte pro Spieler, bis sich nichts mehr bewegt.
+    // Rechnet mit q = 10^(r/400): erwartet gegen j ist q_i / (q_i + q_j)
+    constexpr double SCALE = 400.0 / 2.302585092994046;   // 400 / ln(10)
+    vector<double> rating(n, 0.0), q(n, 1.0);
+    auto information = [&](size_t i, double& expect) {
+        double info = 0.0;
+        expect = 0.0;
+        for (const Opponent& o : opponents[i]) {
+            const double e = q[i] / (q[i] + q[o.index]);
+            expect += o.games * e;
+            info += o.games * e * (1.0 - e);
+        }
+        return info;
+    };
+    for (int iteration = 0; iteration < 500; ++iteration) {
+        double maxStep = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double expect;
+            const double info = information(i, expect);
+            if (info <= 0.0) continue;
+            const double step = max(-400.0, min(400.0, SCALE * (score[i] - expect) / info));
+            rating[i] += step;
+            q[i] = pow(10.0, rating[i] / 400.0);
+            maxStep = max(maxStep, fabs(step));
+        }
+        if (maxStep < 1e-3) break;
+    }
+
+    // Mittel der bewerteten Spieler = 0; Fehler aus der Fisher-Information
+    double sum = 0.0;
+    size_t rated = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (opponents[i].empty()) continue;
+        sum += rating[i];
+        ++rated;
+    }
+    const double mean = rated ? sum / rated : 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double expect;
+        const double info = information(i, expect);
+        stats[i].elo = opponents[i].empty() ? 0.0 : rating[i] - mean;
+        stats[i].eloError = info > 0.0 ? 1.96 * SCALE / sqrt(info) : -1.0;
+    }
+}
+
+void Stats::printReport(const vector<PlayerStats>& stats, ReportOrder order) {
+    printReport(stats, order, std::cout);
+}
+
+void Stats::printReport(const vector<PlayerStats>& stats, ReportOrder order, std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
@@ -124,7 +809,7 @@ void Stats::printReport(const vector<PlayerStats>& stats) {
     using std::setprecision;
 
     if (stats.empty()) {
-        cout << "Keine Statistikdaten vorhanden (logs/stats.csv).\n\n";
+        out << "Keine Statistikdaten vorhanden (logs/stats.csv).\n\n";
         return;
     }
 
@@ -135,42 +820,79 @@ void Stats::printReport(const vector<PlayerStats>& stats) {
         if (nameW > 24) nameW = 24; // cap, damit es nicht sprengt
     }
 
-    cout << "\n================================= Spieler-Statistiken ================================\n";
-    cout << left  << setw(nameW) << "Name"
-         << right << setw(7)  << "Spiele"
-         << setw(5)  << "W"
-         << setw(5)  << "U"
-         << setw(5)  << "L"
-         << setw(8)  << "Züge"
-         << setw(11) << "Øms/Zug"
-         << setw(11) << "Øs/Zug"
-         << setw(12) << "Fast(ms)"
-         << setw(12) << "Slow(ms)"
-         << "\n";
+    if (order == ReportOrder::Elo) {
+        vector<const PlayerStats*> ranked;
+        for (const auto& s : stats) ranked.push_back(&s);
+        stable_sort(ranked.begin(), ranked.end(), [](const PlayerStats* a, const PlayerStats* b) {
+            return a->elo > b->elo;
+        });
+
+        out << "\n================================ Elo-Rangliste ================================\n";
+        // "±" ist ein Zeichen, aber zwei Byte: setw zählt Bytes, daher von Hand aufgefüllt
+        out << right << setw(5) << "Rang" << "  " << left << setw(nameW) << "Name"
+            << right << setw(7) << "Elo" << "   ±95%"
+            << setw(8) << "Spiele" << setw(7) << "W" << setw(7) << "U" << setw(7) << "L"
+            << setw(10) << "Punkte" << "\n";
+        out << std::string(5 + 2 + nameW + 7 + 7 + 8 + 3 * 7 + 10, '-') << "\n";
+        int rank = 0;
+        for (const PlayerStats* s : ranked) {
+            const double points = s->games > 0 ? (s->wins + 0.5 * s->draws) * 100.0 / s->games : 0.0;
+            out << right << setw(5) << ++rank << "  "
+                 << left << setw(nameW) << (s->name.size() > (size_t)(nameW-2) ? s->name.substr(0, nameW-2) : s->name)
+                 << right << fixed << setprecision(0) << setw(7) << s->elo;
+            const std::string error = s->eloError < 0 ? "-" : "±" + std::to_string(std::lround(s->eloError));
+            const size_t columns = s->eloError < 0 ? 1 : error.size() - 1;
+            out << std::string(columns < 7 ? 7 - columns : 1, ' ') << error;
+            out << setw(8) << s->games << setw(7) << s->wins << setw(7) << s->draws << setw(7) << s->losses
+                 << setw(9) << setprecision(1) << points << "%\n";
+            out.unsetf(std::ios::floatfield);
+        }
+        out << setprecision(6) << "\n";
+        return;
+    }
+
+    out << "\n============================================= Spieler-Statistiken =============================================\n";
+    out << left  << setw(nameW) << "Name"
+        << right << setw(7)  << "Spiele"
+        << setw(5)  << "W"
+        << setw(5)  << "U"
+        << setw(5)  << "L"
+        << setw(8)  << "Züge"
+        << setw(11) << "Øms/Zug"
+        << setw(11) << "Øs/Zug"
+        << setw(12) << "Fast(ms)"
+        << setw(12) << "Slow(ms)"
+        << setw(9)  << "p50(ms)"
+        << setw(9)  << "p90(ms)"
+        << setw(9)  << "p99(ms)"
+        << "\n";
 
-    cout << std::string(nameW + 7 + 5 + 5 + 5 + 8 + 11 + 11 + 12 + 12, '-') << "\n";
+    out << std::string(nameW + 7 + 5 + 5 + 5 + 8 + 11 + 11 + 12 + 12 + 3 * 9, '-') << "\n";
 
     for (const auto& s : stats) {
         long long avgMs = (s.moves > 0) ? (s.totalMoveMs / s.moves) : 0;
         double avgS = (s.moves > 0) ? ((double)s.totalMoveMs / 1000.0 / (double)s.moves) : 0.0;
 
-        cout << left  << setw(nameW) << (s.name.size() > (size_t)(nameW-2) ? s.name.substr(0, nameW-2) : s.name)
-             << right << setw(7)  << s.games
-             << setw(5)  << s.wins
-             << setw(5)  << s.draws
-             << setw(5)  << s.losses
-             << setw(8)  << s.moves
-             << setw(11) << avgMs
-             << setw(11) << fixed << setprecision(2) << avgS
-             << setw(12) << (s.fastestMoveMs < 0 ? -1 : s.fastestMoveMs)
-             << setw(12) << (s.slowestMoveMs < 0 ? -1 : s.slowestMoveMs)
-             << "\n";
+        out << left  << setw(nameW) << (s.name.size() > (size_t)(nameW-2) ? s.name.substr(0, nameW-2) : s.name)
+            << right << setw(7)  << s.games
+            << setw(5)  << s.wins
+            << setw(5)  << s.draws
+            << setw(5)  << s.losses
+            << setw(8)  << s.moves
+            << setw(11) << avgMs
+            << setw(11) << fixed << setprecision(2) << avgS
+            << setw(12) << (s.fastestMoveMs < 0 ? -1 : s.fastestMoveMs)
+            << setw(12) << (s.slowestMoveMs < 0 ? -1 : s.slowestMoveMs)
+            << setw(9)  << s.moveTimes.percentile(50)
+            << setw(9)  << s.moveTimes.percentile(90)
+            << setw(9)  << s.moveTimes.percentile(99)
+            << "\n";
 
         // setprecision bleibt sonst “kleben”, daher wieder zurück (optional)
-        cout.unsetf(std::ios::floatfield);
-        cout << setprecision(6);
+        out.unsetf(std::ios::floatfield);
+        out << setprecision(6);
     }
 
-    cout << "\n";
+    out << "\n";
 }
 
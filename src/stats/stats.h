@@ -1,7 +1,12 @@
 #pragma once
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
+#include "move.h"
+#include "stats/histogram.h"
+
 struct PlayerStats {
     std::string name;
     int games = 0;
@@ -13,10 +18,58 @@ struct PlayerStats {
     long long totalMoveMs = 0;
     long long fastestMoveMs = -1;
     long long slowestMoveMs = -1;
+    LatencyHistogram moveTimes;   // leer bei Zeilen aus älteren CSVs
+    double elo = 0.0;             // nach Stats::computeElo (loadAggregated mit elo), Mittel = 0
+    double eloError = -1.0;       // halbe Breite des 95-%-Intervalls; -1 = ohne Gegner
+};
+
+// Partien mit Ergebnis zwischen zwei Spielern (Indizes in die Spielerliste).
+// Mehr braucht die Elo-Schätzung nicht: die Punkte stehen in PlayerStats
+struct PairGames {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    long long games = 0;
+};
+
+enum class ReportOrder { Wins, Elo };
+
+// Eine Zeile in stats.csv (Index 0/1 = Spieler 0/1)
+struct GameSummary {
+    std::string players[2];
+    int result = -1;
+    long long totalGameMs = 0;
+    long long moves[2] = {0, 0};
+    long long totalMs[2] = {0, 0};
+    long long fastest[2] = {-1, -1};
+    long long slowest[2] = {-1, -1};
+    std::vector<long long> moveTimes[2];   // einzelne Zugzeiten fürs Histogramm
+};
+
+// Ergebnis eines Durchlaufs über stats.csv
+struct CsvParseInfo {
+    size_t rows = 0;                // gültige Datenzeilen (nur die neu gelesenen)
+    size_t badRows = 0;             // übersprungen: falsche Feldzahl oder keine Zahl
+    long long firstBadOffset = -1;  // Byte-Position der ersten übersprungenen Zeile
 };
 
 class Stats {
 public:
+    // Züge/Zeiten pro Spieler aus der Zugliste einer Partie
+    static GameSummary summarize(const std::string players[2], int result,
+                                 const std::vector<Move>& moves);
+
+    // Viele Partien mit einem Öffnen/Schreiben (z.B. Selbstspiel)
+    static bool appendGames(const std::string& filenameCsv,
+                            const std::vector<GameSummary>& games);
+
+    // Eine CSV-Zeile an buf anhängen (Format wie in stats.csv)
+    static void formatRow(std::string& buf, const GameSummary& g);
+
+    // Fertige Zeilen mit einem write() anhängen, unter flock(LOCK_EX):
+    // mehrere Prozesse/Threads dürfen dieselbe Datei beschreiben, die
+    // Kopfzeile kommt nur in eine leere Datei
+    static bool appendRows(const std::string& filenameCsv, const std::string& rows);
+
     static bool appendGame(const std::string& filenameCsv,
                            const std::string players[2],
                            int result,
@@ -30,6 +83,28 @@ public:
                            long long slowestP0,
                            long long slowestP1);
 
-    static std::vector<PlayerStats> loadAggregated(const std::string& filenameCsv);
-    static void printReport(const std::vector<PlayerStats>& stats);
+    // Liest <csv>.snap (aggregierte Werte bis zu einem Byte-Offset der CSV)
+    // und wertet nur die seitdem angehängten Zeilen aus; danach wird der
+    // Snapshot fortgeschrieben. Fehlt er, ist er kaputt oder passt er nicht
+    // mehr zur CSV, wird alles neu eingelesen. Die CSV wird per mmap ohne
+    // Kopie zerlegt, große Bereiche auf threads Threads (<= 0: alle Kerne).
+    // elo: zusätzlich Partien pro Spielerpaar zählen und computeElo
+    // aufrufen. Ohne elo bleiben elo/eloError auf den Vorgaben; hat der
+    // Snapshot noch keine Paarungen, wird dafür einmal alles neu gelesen
+    static std::vector<PlayerStats> loadAggregated(const std::string& filenameCsv,
+                                                   CsvParseInfo* info = nullptr,
+                                                   int threads = 0,
+                                                   bool elo = false);
+    static std::string snapshotPath(const std::string& filenameCsv);
+
+    // Elo per Maximum Likelihood (Bradley-Terry, Remis = halber Punkt) aus
+    // den Punkten jedes Spielers und den Partien pro Paar; ein gedachtes
+    // Remis pro Paar hält Serien ohne Niederlage endlich. Fehlerbalken aus
+    // der Fisher-Information. Partien ohne Paar (gegen sich selbst, -1)
+    // zählen nicht
+    static void computeElo(std::vector<PlayerStats>& stats, const std::vector<PairGames>& pairs);
+
+    // Wins: volle Tabelle nach Siegen; Elo: Rangliste mit Fehlerbalken
+    static void printReport(const std::vector<PlayerStats>& stats, ReportOrder order = ReportOrder::Wins);
+    static void printReport(const std::vector<PlayerStats>& stats, ReportOrder order, std::ostream& out);
 };
@@ -0,0 +1,95 @@
+#include "statswriter.h"
+
+using namespace std;
+
+StatsWriter::StatsWriter(const string& filenameCsv, size_t maxRows, int flushIntervalMs)
+    : filename(filenameCsv), maxRows(maxRows > 0 ? maxRows : 1), interval(flushIntervalMs) {
+    if (flushIntervalMs > 0) timer = thread(&StatsWriter::timerLoop, this);
+}
+
+StatsWriter::~StatsWriter() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (timer.joinable()) timer.join();
+    flush();
+}
+
+void StatsWriter::addLocked(const GameSummary& game) {
+    if (rows == 0) {
+        oldest = Clock::now();
+        wake.notify_one();  // Zeitgeber läuft ab jetzt
+    }
+    Stats::formatRow(buffer, game);
+    ++rows;
+}
+
+void StatsWriter::add(const GameSummary& game) {
+    unique_lock<std::mutex> lock(mutex);
+    addLocked(game);
+    if (rows < maxRows) return;
+    lock.unlock();
+    flush();
+}
+
+void StatsWriter::add(const vector<GameSummary>& games) {
+    unique_lock<std::mutex> lock(mutex);
+    for (const GameSummary& g : games) addLocked(g);
+    if (rows < maxRows) return;
+    lock.unlock();
+    flush();
+}
+
+bool StatsWriter::flush() {
+    // ioMutex zuerst: ein zweiter flush() kann nicht mit jüngeren Zeilen überholen
+    lock_guard<std::mutex> io(ioMutex);
+    string batch;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        if (rows == 0) return !writeFailed;
+        batch.swap(buffer);
+        buffer.reserve(batch.capacity());
+        rows = 0;
+    }
+    // Schreiben ohne mutex: add() blockiert nicht auf die Platte
+    bool ok = Stats::appendRows(filename, batch);
+    lock_guard<std::mutex> lock(mutex);
+    ++writeCount;
+    writeFailed = writeFailed || !ok;
+    return !writeFailed;
+}
+
+void StatsWriter::timerLoop() {
+    unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (rows == 0) {
+            wake.wait(lock);
+            continue;
+        }
+        const auto due = oldest + interval;
+        if (Clock::now() < due) {
+            wake.wait_until(lock, due);
+            continue;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+size_t StatsWriter::pendingRows() const {
+    lock_guard<std::mutex> lock(mutex);
+    return rows;
+}
+
+uint64_t StatsWriter::writes() const {
+    lock_guard<std::mutex> lock(mutex);
+    return writeCount;
+}
+
+bool StatsWriter::failed() const {
+    lock_guard<std::mutex> lock(mutex);
+    return writeFailed;
+}
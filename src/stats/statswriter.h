@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stats/stats.h"
+
+// Sammelt Zeilen für stats.csv von beliebig vielen Threads und hängt sie
+// gebündelt an (Stats::appendRows: ein write() unter flock pro Schub).
+// Geschrieben wird, sobald maxRows Zeilen warten oder die älteste
+// flushIntervalMs alt ist (eigener Thread), spätestens im Destruktor.
+class StatsWriter {
+public:
+    // flushIntervalMs <= 0: kein Zeitgeber, nur maxRows und flush()
+    explicit StatsWriter(const std::string& filenameCsv, size_t maxRows = 256, int flushIntervalMs = 1000);
+    ~StatsWriter();
+    StatsWriter(const StatsWriter&) = delete;
+    StatsWriter& operator=(const StatsWriter&) = delete;
+
+    void add(const GameSummary& game);
+    void add(const std::vector<GameSummary>& games);
+
+    // Wartende Zeilen jetzt schreiben; false wenn ein Schreiben fehlschlug
+    bool flush();
+
+    size_t pendingRows() const;
+    uint64_t writes() const;    // bisherige Schübe (für Messungen)
+    bool failed() const;        // irgendein Schub ging verloren
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string filename;
+    size_t maxRows;
+    std::chrono::milliseconds interval;
+
+    mutable std::mutex mutex;       // schützt buffer/rows/oldest und Zähler
+    std::mutex ioMutex;             // hält die Reihenfolge der Schübe
+    std::condition_variable wake;
+    std::string buffer;
+    size_t rows = 0;
+    Clock::time_point oldest;
+    uint64_t writeCount = 0;
+    bool writeFailed = false;
+    bool stopping = false;
+    std::thread timer;
+
+    void addLocked(const GameSummary& game);   // mutex gehalten
+    void timerLoop();
+};
@@ -1,18 +1,125 @@
 #include "testsuite.h"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 
+#include "batch/batchsolver.h"
 #include "board/board.h"
+#include "book/openingbook.h"
+#include "board/bitboard.h"
+#include "board/zobrist.h"
 #include "constants.h"
+#include "gamelogger/gamelogger.h"
+#include "gamelogger/logcatalog.h"
+#include "gamelogger/positiondb.h"
+#include "mcts/batchplayout.h"
+#include "mcts/mcts.h"
+#include "selfplay/selfplay.h"
+#include "selfplay/tournament.h"
+#include "server/gameserver.h"
+#include "solver/parallelsearch.h"
+#include "solver/solver.h"
+#include "solver/transpositiontable.h"
+#include "stats/stats.h"
+#include "stats/statswriter.h"
+#include "util/eventloop.h"
+#include "util/screen.h"
+#include "util/util.h"
+
+#if defined(__linux__)
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+#if __has_include(<filesystem>)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+  #define HAS_FILESYSTEM 1
+#else
+  #define HAS_FILESYSTEM 0
+#endif
 
 using namespace std;
 
+namespace {
+    // Referenz: reines Negamax ohne Pruning (nur für kleine Restbretter)
+    int bruteForceScore(const BitBoard& b) {
+        if (b.isFull()) return 0;
+        int best = -ROWS * COLS;
+        for (int c = 0; c < COLS; ++c) {
+            if (!b.isValidColumn(c)) continue;
+            BitBoard child = b;
+            int p = child.currentPlayer();
+            child.dropDisc(c);
+            int score = child.checkWin(p) ? (ROWS * COLS + 1 - b.moveCount()) / 2
+                                          : -bruteForceScore(child);
+            if (score > best) best = score;
+        }
+        return best;
+    }
+
+    // Pfad für temporäre Testdateien
+    string tempPath(const string& name) {
+    #if HAS_FILESYSTEM
+        return (fs::temp_directory_path() / name).string();
+    #else
+        return "/tmp/" + name;
+    #endif
+    }
+
+    // Zugfolge (Spalten 1..COLS) einer zufälligen, noch offenen Stellung
+    string randomOpenMoves(mt19937& rng, int plies) {
+        while (true) {
+            BitBoard b;
+            string moves;
+            bool ok = true;
+            while (ok && b.moveCount() < plies) {
+                int col = static_cast<int>(rng() % COLS);
+                if (!b.isValidColumn(col)) continue;
+                int p = b.currentPlayer();
+                b.dropDisc(col);
+                moves += static_cast<char>('1' + col);
+                ok = !b.checkWin(p);
+            }
+            if (ok) return moves;
+        }
+    }
+
+    // Zufällige, noch offene Stellung mit genau `plies` Steinen (oder leeres Brett)
+    BitBoard randomOpenPosition(mt19937& rng, int plies) {
+        while (true) {
+            BitBoard b;
+            bool ok = true;
+            while (ok && b.moveCount() < plies) {
+                int col = static_cast<int>(rng() % COLS);
+                if (!b.isValidColumn(col)) continue;
+                int p = b.currentPlayer();
+                b.dropDisc(col);
+                ok = !b.checkWin(p);
+            }
+            if (ok) return b;
+        }
+    }
+}
+
 void TestSuite::assertTrue(bool cond, const string &msg) {
     if (cond) ++passed;
     else { ++failed; cout << "[FEHLER] " << msg << "\n"; }
 }
 
-void TestSuite::run() {
+bool TestSuite::run() {
     cout << "\n=========== TestSuite ===========\n";
     passed = failed = 0;
 
@@ -71,6 +178,1513 @@ void TestSuite::run() {
         assertTrue(b.isFull(), "isFull: Brett sollte voll sein.");
     }
 
+    // Test 7: BitBoard gegen Board (Zufallspartien)
+    {
+        cout << "teste BitBoard: Abgleich mit Board über Zufallspartien... \n";
+        mt19937 rng(12345);
+        char s[2] = {'X','O'};
+        bool same = true;
+        for (int game = 0; game < 500 && same; ++game) {
+            Board b;
+            BitBoard bb;
+            while (same) {
+                int col = static_cast<int>(rng() % COLS);
+                same = same && (b.isValidColumn(col) == bb.isValidColumn(col))
+                            && (b.getDropRow(col) == bb.getDropRow(col));
+                if (!bb.isValidColumn(col)) continue;
+
+                int p = bb.currentPlayer();
+                same = same && (b.dropDisc(col, s[p]) == bb.dropDisc(col));
+                for (int r = 0; r < ROWS; ++r)
+                    for (int c = 0; c < COLS; ++c) {
+                        int cell = bb.cell(r, c);
+                        if (b.cellAt(r, c) != (cell < 0 ? ' ' : s[cell])) same = false;
+                    }
+                same = same && (b.checkWin('X') == bb.checkWin(0))
+                            && (b.checkWin('O') == bb.checkWin(1))
+                            && (b.isFull() == bb.isFull());
+                if (bb.checkWin(p) || bb.isFull()) break;
+            }
+        }
+        assertTrue(same, "BitBoard: Ergebnis weicht von Board ab.");
+    }
+
+    // Test 8: BitBoard ungültige Spalten
+    {
+        cout << "teste BitBoard: ungültige und volle Spalten... \n";
+        BitBoard bb;
+        assertTrue(bb.dropDisc(-1) == -1 && bb.dropDisc(COLS) == -1, "BitBoard: Spalte außerhalb muss -1 liefern.");
+        for (int i = 0; i < ROWS; ++i) bb.dropDisc(3);
+        assertTrue(!bb.isValidColumn(3) && bb.dropDisc(3) == -1, "BitBoard: volle Spalte muss -1 liefern.");
+        assertTrue(bb.moveCount() == ROWS, "BitBoard: Zugzähler falsch.");
+    }
+
+    // Test 9: checkWinAt gegen checkWin, Drohungen gegen Brute Force
+    {
+        cout << "teste checkWinAt/threatCount: Abgleich über Zufallspartien... \n";
+        mt19937 rng(777);
+        char s[2] = {'X','O'};
+        bool winSame = true, threatsSame = true;
+        for (int game = 0; game < 500; ++game) {
+            Board b;
+            BitBoard bb;
+            while (true) {
+                int col = static_cast<int>(rng() % COLS);
+                if (!bb.isValidColumn(col)) continue;
+
+                int p = bb.currentPlayer();
+                int row = bb.dropDisc(col);
+                b.dropDisc(col, s[p]);
+
+                bool win = bb.checkWin(p);
+                if (bb.checkWinAt(row, col) != win || b.checkWinAt(row, col) != win) winSame = false;
+
+                for (int q = 0; q < 2 && !win; ++q) {
+                    int expected = 0;
+                    for (int c = 0; c < COLS; ++c)
+                        for (int r = 0; r < ROWS; ++r) {
+                            uint64_t bit = BitBoard::cellBit(r, c);
+                            if (!(bb.occupiedMask() & bit) && BitBoard::hasAlignment(bb.playerMask(q) | bit))
+                                ++expected;
+                        }
+                    if (bb.threatCount(q) != expected) threatsSame = false;
+                }
+                if (win || bb.isFull()) break;
+            }
+        }
+        assertTrue(winSame, "checkWinAt: Ergebnis weicht von checkWin ab.");
+        assertTrue(threatsSame, "threatCount: Ergebnis weicht von Brute Force ab.");
+    }
+
+    // Test 10: Solver gegen Brute Force auf kleinen Restbrettern
+    {
+        cout << "teste Solver: exakte Bewertung gegen Brute Force... \n";
+        mt19937 rng(4242);
+        Solver solver;
+        bool same = true, moveOk = true;
+        for (int i = 0; i < 20; ++i) {
+            BitBoard b = randomOpenPosition(rng, ROWS * COLS - 9);
+            SearchResult res = solver.solve(b);
+            if (res.score != bruteForceScore(b)) same = false;
+
+            // bester Zug muss den Score auch tatsächlich halten
+            BitBoard child = b;
+            int p = child.currentPlayer();
+            if (child.dropDisc(res.bestMove) < 0) { moveOk = false; continue; }
+            int moveScore = child.checkWin(p) ? (ROWS * COLS + 1 - b.moveCount()) / 2
+                                              : -bruteForceScore(child);
+            if (moveScore != res.score) moveOk = false;
+        }
+        assertTrue(same, "Solver: Score weicht von Brute Force ab.");
+        assertTrue(moveOk, "Solver: bester Zug hält den Score nicht.");
+    }
+
+    // Test 11: Zeitbegrenzte Suche findet Sofortgewinn und blockt
+    {
+        cout << "teste Solver: Sofortgewinn / Blocken mit Zeitlimit... \n";
+        Solver solver;
+        BitBoard b;
+        for (int c : {0, 6, 1, 6, 2}) b.dropDisc(c); // X droht in Spalte 4
+        SearchResult block = solver.search(b, 200);
+        assertTrue(block.bestMove == 3, "Solver: Drohung muss geblockt werden.");
+        b.dropDisc(5);
+        SearchResult win = solver.search(b, 200);
+        assertTrue(win.bestMove == 3 && win.exact && win.score > 0, "Solver: Sofortgewinn nicht gefunden.");
+    }
+
+    // Test 12: Transpositionstabelle speichern / lesen / ersetzen
+    {
+        cout << "teste TranspositionTable: Speichern, Lesen, Ersetzung... \n";
+        TranspositionTable tt(1);
+        TTStats st;
+        TTEntry e;
+        tt.store(12345, -7, Bound::Lower, 3, 10, st);
+        bool ok = tt.probe(12345, e, st) && e.score == -7 && e.bound == Bound::Lower
+               && e.bestMove == 3 && e.depth == 10;
+        assertTrue(ok, "TT: gespeicherter Eintrag nicht wiedergefunden.");
+        assertTrue(!tt.probe(54321, e, st), "TT: fremder Schlüssel darf nicht treffen.");
+
+        tt.store(12345, 2, Bound::Exact, 1, 5, st); // flacher: darf nicht ersetzen
+        assertTrue(tt.probe(12345, e, st) && e.depth == 10, "TT: flacher Eintrag hat tieferen ersetzt.");
+        assertTrue(st.hits == 2 && st.probes == 3, "TT: Trefferzähler falsch.");
+    }
+
+    // Test 13: Solver mit und ohne Transpositionstabelle gleich
+    {
+        cout << "teste Solver: gleiche Scores mit Transpositionstabelle... \n";
+        mt19937 rng(99);
+        TranspositionTable tt(4);
+        Solver plain, cached(&tt);
+        bool same = true;
+        for (int i = 0; i < 10; ++i) {
+            BitBoard b = randomOpenPosition(rng, ROWS * COLS - 14);
+            if (plain.solve(b).score != cached.solve(b).score) same = false;
+        }
+        assertTrue(same, "Solver: Score mit TT weicht ab.");
+    }
+
+    // Test 14: Schlüssel, Spiegelung, fromKey
+    {
+        cout << "teste BitBoard: key/fromKey und Spiegelung... \n";
+        mt19937 rng(5);
+        bool roundtrip = true, mirror = true;
+        for (int i = 0; i < 200; ++i) {
+            BitBoard b = randomOpenPosition(rng, static_cast<int>(rng() % 30));
+            BitBoard r = BitBoard::fromKey(b.key());
+            if (r.key() != b.key() || r.moveCount() != b.moveCount()
+                || r.threatCount(0) != b.threatCount(0) || r.threatCount(1) != b.threatCount(1))
+                roundtrip = false;
+
+            BitBoard m = BitBoard::fromKey(BitBoard::mirrorColumns(b.key()));
+            for (int row = 0; row < ROWS; ++row)
+                for (int c = 0; c < COLS; ++c)
+                    if (m.cell(row, c) != b.cell(row, COLS - 1 - c)) mirror = false;
+        }
+        assertTrue(roundtrip, "fromKey: Stellung nicht identisch rekonstruiert.");
+        assertTrue(mirror, "mirrorColumns: Spiegelbild falsch.");
+    }
+
+    // Test 15: Eröffnungsbuch schreiben, mmap-Lookup, Spiegelung, Header
+    {
+        cout << "teste OpeningBook: Stellungen sammeln, Lookup, veraltetes Buch... \n";
+        assertTrue(OpeningBook::collectPositions(2).size() == 1 + 4 + 25,
+                   "collectPositions: falsche Anzahl bis Halbzug 2.");
+
+        // Buch aus echten Solver-Ergebnissen später Stellungen
+        mt19937 rng(8);
+        Solver solver;
+        vector<BookEntry> list;
+        vector<BitBoard> boards;
+        for (int i = 0; i < 20; ++i) {
+            BitBoard b = randomOpenPosition(rng, ROWS * COLS - 10);
+            bool mirrored = false;
+            BookEntry e{};
+            e.key = b.canonicalKey(&mirrored);
+            SearchResult res = solver.solve(mirrored ? BitBoard::fromKey(e.key) : b);
+            e.score = static_cast<int8_t>(res.score);
+            e.bestMove = static_cast<uint8_t>(res.bestMove);
+            list.push_back(e);
+            boards.push_back(b);
+        }
+        string fn = tempPath("c4_test.book");
+        bool written = OpeningBook::write(fn, list, ROWS * COLS);
+        assertTrue(written, "OpeningBook: Datei nicht schreibbar.");
+
+        OpeningBook book;
+        bool found = book.open(fn);
+        for (const auto& b : boards) {
+            int score = 0, move = -1;
+            BitBoard m = BitBoard::fromKey(BitBoard::mirrorColumns(b.key()));
+            int mScore = 0, mMove = -1;
+            found = found && book.lookup(b, score, move) && book.lookup(m, mScore, mMove)
+                          && score == mScore && move == COLS - 1 - mMove
+                          && solver.solve(b).score == score;
+        }
+        assertTrue(found, "OpeningBook: Lookup (auch gespiegelt) fehlerhaft.");
+        book.close();
+        assertTrue(OpeningBook::verify(fn, 10, 1, 1, cout) == 0, "OpeningBook: verify meldet Abweichungen.");
+
+        auto patchHeader = [&](auto change) {
+            fstream f(fn, ios::in | ios::out | ios::binary);
+            BookHeader h;
+            f.read(reinterpret_cast<char*>(&h), sizeof(h));
+            change(h);
+            f.seekp(0);
+            f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        };
+
+        // count, bei dem count * sizeof(BookEntry) überläuft und wieder passt
+        patchHeader([](BookHeader& h) { h.count += uint64_t(1) << 60; });
+        assertTrue(!book.open(fn), "OpeningBook: überlaufendes count wurde akzeptiert.");
+        patchHeader([](BookHeader& h) { h.count -= uint64_t(1) << 60; });
+
+        // Header mit anderer Brettgröße muss abgelehnt werden
+        patchHeader([](BookHeader& h) { h.cols = COLS + 1; });
+        string error;
+        assertTrue(!book.open(fn, &error), "OpeningBook: veraltetes Buch wurde akzeptiert.");
+        remove(fn.c_str());
+    }
+
+    // Test 16: Lazy SMP liefert dieselben Scores, Stop-Flag bricht ab
+    {
+        cout << "teste ParallelSearch: Scores mit 4 Threads, Abbruch per stop()... \n";
+        mt19937 rng(31);
+        TranspositionTable tt(8);
+        ParallelSearch smp(tt, 4);
+        Solver single;
+        bool same = true;
+        for (int i = 0; i < 5; ++i) {
+            BitBoard b = randomOpenPosition(rng, ROWS * COLS - 14);
+            SearchResult res = smp.solve(b);
+            same = same && res.exact && res.score == single.solve(b).score;
+        }
+        assertTrue(same, "ParallelSearch: Score weicht vom Einzelthread ab.");
+
+        // leeres Brett ist ohne Buch nicht in 50 ms lösbar
+        TranspositionTable tt2(8);
+        ParallelSearch hard(tt2, 2);
+        thread stopper([&] {
+            this_thread::sleep_for(chrono::milliseconds(50));
+            hard.stop();
+        });
+        SearchResult res = hard.solve(BitBoard());
+        stopper.join();
+        assertTrue(!res.exact && res.micros < 2000000, "ParallelSearch: stop() bricht die Suche nicht ab.");
+    }
+
+    // Test 17: Batch-Lösen über stdin, Reihenfolge bleibt erhalten
+    {
+        cout << "teste BatchSolver: Reihenfolge und Scores... \n";
+        mt19937 rng(2024);
+        vector<string> positions;
+        stringstream in;
+        for (int i = 0; i < 24; ++i) {
+            positions.push_back(randomOpenMoves(rng, ROWS * COLS - 12 - (i % 5)));
+            in << positions.back() << "\n";
+            if (i == 10) in << "\n4444444\n"; // Leerzeile + volle Spalte
+        }
+        stringstream out;
+        BatchSolver::Options opt;
+        opt.threads = 3;
+        opt.ttMegabytes = 4;
+        opt.bookPath = "";
+        opt.window = 4;
+        size_t n = BatchSolver::run(in, out, opt);
+
+        Solver solver;
+        bool ok = (n == positions.size() + 1);
+        size_t idx = 0;
+        string pos, score, move;
+        long long nodes, micros;
+        while (ok && out >> pos >> score >> move >> nodes >> micros) {
+            if (pos == "4444444") { ok = (score == "invalid"); continue; }
+            if (idx >= positions.size() || pos != positions[idx]) { ok = false; break; }
+            BitBoard b;
+            BitBoard::fromMoves(pos, b);
+            ok = (stoi(score) == solver.solve(b).score);
+            ++idx;
+        }
+        assertTrue(ok && idx == positions.size(), "BatchSolver: Ausgabe falsch oder nicht in Eingabereihenfolge.");
+    }
+
+    // Test 18: Selbstspiel reproduzierbar, Züge regelkonform, Greedy gewinnt/blockt
+    {
+        cout << "teste SelfPlay: Seed, Threads, Regeln, Greedy... \n";
+        auto readFile = [](const string& fn) {
+            ifstream in(fn, ios::binary);
+            return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        };
+        SelfPlay::Options opt;
+        opt.games = 10000; // mehrere Pakete
+        opt.seed = 77;
+        opt.csvPath = tempPath("c4_selfplay_a.csv");
+        remove(opt.csvPath.c_str());
+        stringstream log;
+        opt.threads = 1;
+        SelfPlay::Summary a = SelfPlay::run(opt, log);
+        string csvA = readFile(opt.csvPath);
+        remove(opt.csvPath.c_str());
+        opt.threads = 3;
+        SelfPlay::Summary b = SelfPlay::run(opt, log);
+        string csvB = readFile(opt.csvPath);
+        remove(opt.csvPath.c_str());
+        assertTrue(a.games == 10000 && a.wins[0] + a.wins[1] + a.draws == 10000
+                   && a.wins[0] == b.wins[0] && a.moves == b.moves && !csvA.empty() && csvA == csvB,
+                   "SelfPlay: gleicher Seed liefert unterschiedliche Partien.");
+
+        Policy policies[2];
+        Policy::parse("greedy", policies[0]);
+        Policy::parse("search:4", policies[1]);
+        bool ok = policies[1].depth == 4 && !Policy::parse("search:x", policies[1]);
+        vector<Move> moves;
+        for (uint64_t seed = 1; seed <= 200 && ok; ++seed) {
+            int result = SelfPlay::playGame(policies, 2, seed, moves);
+            Board ref;
+            char sym[2] = {'X', 'O'};
+            int refResult = -1;
+            for (size_t i = 0; i < moves.size() && ok; ++i) {
+                ok = refResult == -1 && moves[i].playerIndex == (int)(i % 2);
+                int row = ref.dropDisc(moves[i].col, sym[i % 2]);
+                ok = ok && row != -1;
+                if (ok && ref.checkWinAt(row, moves[i].col)) refResult = (int)(i % 2) + 1;
+                else if (ok && ref.isFull()) refResult = 0;
+            }
+            ok = ok && refResult == result;
+        }
+        assertTrue(ok, "SelfPlay: Partie verletzt die Regeln oder falsches Ergebnis.");
+
+        Solver solver;
+        uint64_t rng = 5;
+        ok = true;
+        for (int i = 0; i < 20 && ok; ++i) {
+            BitBoard w;
+            BitBoard::fromMoves("121314", w);  // Spieler 0 gewinnt mit Spalte 1
+            ok = SelfPlay::chooseMove(policies[0], w, rng, solver) == 0;
+            BitBoard bl;
+            BitBoard::fromMoves("12131", bl);  // Spieler 1 muss Spalte 1 blocken
+            ok = ok && SelfPlay::chooseMove(policies[0], bl, rng, solver) == 0;
+        }
+        assertTrue(ok, "SelfPlay: Greedy gewinnt oder blockt nicht.");
+    }
+
+    // Test 19: MCTS spielt Gewinn/Block, kleine Arena läuft voll, Teilbaum wird übernommen
+    {
+        cout << "teste MCTS: Gewinn/Block, volle Arena, Wiederverwendung, gegen Zufall... \n";
+        Mcts engine(1, 3);
+        BitBoard w, bl;
+        BitBoard::fromMoves("121314", w);   // Spieler 0 gewinnt mit Spalte 1
+        BitBoard::fromMoves("12131", bl);   // Spieler 1 muss Spalte 1 blocken
+        MctsResult rw = engine.search(w, 0, 1000);
+        engine.clear();
+        MctsResult rb = engine.search(bl, 0, 1000);
+        assertTrue(rw.bestMove == 0 && rw.winRate == 1.0 && rb.bestMove == 0,
+                   "MCTS: Gewinnzug oder Block nicht gefunden.");
+
+        Mcts tiny(0, 3); // Mindestgröße: Arena läuft sofort voll
+        BitBoard empty;
+        MctsResult rt = tiny.search(empty, 0, 20000);
+        bool ok = rt.playouts == 20000 && rt.nodes <= tiny.capacity() && empty.isValidColumn(rt.bestMove);
+
+        MctsResult first = engine.search(empty, 0, 20000);
+        BitBoard next = empty;
+        next.dropDisc(first.bestMove);
+        next.dropDisc(first.bestMove);
+        MctsResult second = engine.search(next, 0, 1000);
+        ok = ok && second.reusedVisits > 0 && second.playouts == 1000;
+        assertTrue(ok, "MCTS: volle Arena oder Wiederverwendung fehlerhaft.");
+
+        // 2000 Playouts pro Zug schlagen Zufallszüge zuverlässig
+        mt19937 rng(8);
+        int mctsWins = 0;
+        for (int g = 0; g < 6; ++g) {
+            BitBoard b;
+            engine.clear();
+            const int me = g % 2;
+            int winner = -1;
+            while (winner < 0 && !b.isFull()) {
+                int p = b.currentPlayer();
+                int col;
+                if (p == me) col = engine.search(b, 0, 2000).bestMove;
+                else do { col = static_cast<int>(rng() % COLS); } while (!b.isValidColumn(col));
+                b.dropDisc(col);
+                if (b.checkWin(p)) winner = p;
+            }
+            if (winner == me) ++mctsWins;
+        }
+        assertTrue(mctsWins == 6, "MCTS: verliert gegen Zufallszüge.");
+    }
+
+    // Test 20: Batch-Playouts Lane für Lane gegen Board, skalar == AVX2
+    {
+        cout << "teste BatchPlayout: Lanes gegen Board, Kernel " << BatchPlayout::kernelName(BatchPlayout::Kernel::Auto) << "... \n";
+        const string starts[] = {"", "4", "4453", "334455"};
+        bool ok = true, same = true;
+        for (const auto& startMoves : starts) {
+            BitBoard start;
+            ok = ok && BitBoard::fromMoves(startMoves, start);
+            for (uint64_t seed = 1; seed <= 40 && ok; ++seed) {
+                BatchPlayout::Record rec, recScalar;
+                BatchPlayout::Totals t = BatchPlayout::runRecorded(start, seed, BatchPlayout::Kernel::Auto, rec);
+                BatchPlayout::runRecorded(start, seed, BatchPlayout::Kernel::Scalar, recScalar);
+                ok = t.games == BatchPlayout::LANES;
+                for (int lane = 0; lane < BatchPlayout::LANES && ok; ++lane) {
+                    same = same && rec.moves[lane] == recScalar.moves[lane]
+                                && rec.results[lane] == recScalar.results[lane];
+                    Board ref;
+                    const char sym[2] = {'X', 'O'};
+                    for (size_t i = 0; i < startMoves.size(); ++i) ref.dropDisc(startMoves[i] - '1', sym[i % 2]);
+                    int result = -1;
+                    int ply = static_cast<int>(startMoves.size());
+                    for (int col : rec.moves[lane]) {
+                        ok = ok && result == -1 && ref.dropDisc(col, sym[ply % 2]) != -1;
+                        if (ok && ref.checkWin(sym[ply % 2])) result = ply % 2 + 1;
+                        else if (ok && ref.isFull()) result = 0;
+                        ++ply;
+                    }
+                    ok = ok && result == rec.results[lane];
+                }
+            }
+        }
+        BitBoard empty;
+        BatchPlayout::Totals a = BatchPlayout::run(empty, 100000, 9, BatchPlayout::Kernel::Auto);
+        BatchPlayout::Totals b = BatchPlayout::run(empty, 100000, 9, BatchPlayout::Kernel::Scalar);
+        assertTrue(ok, "BatchPlayout: Lane-Partie stimmt nicht mit Board::dropDisc/checkWin überein.");
+        assertTrue(same && a.games == 100000 && a.wins[0] == b.wins[0] && a.wins[1] == b.wins[1]
+                   && a.draws == b.draws && a.moves == b.moves,
+                   "BatchPlayout: AVX2 und skalarer Kernel liefern verschiedene Partien.");
+    }
+
+    // Test 21: Logformat V3 – Round-Trip, Prüfsumme, V1/V2 lesen und konvertieren
+    {
+        cout << "teste GameLogger: V3 binär, Prüfsumme, Konvertierung V1/V2... \n";
+        const string players[2] = {"Anna", "Computer (MCTS)"};
+        const char symbols[2] = {'X', 'O'};
+        const vector<Move> moves = {{0, 3, 0}, {1, 3, 15}, {0, 4, 16}, {1, 6, 14999}, {0, 0, 123456789}};
+        auto same = [&](const vector<Move>& m, const string p[2], const char s[2], int r) {
+            bool eq = m.size() == moves.size() && p[0] == players[0] && p[1] == players[1]
+                   && s[0] == symbols[0] && s[1] == symbols[1] && r == 1;
+            for (size_t i = 0; eq && i < m.size(); ++i)
+                eq = m[i].playerIndex == moves[i].playerIndex && m[i].col == moves[i].col
+                  && m[i].moveTimeMs == moves[i].moveTimeMs;
+            return eq;
+        };
+
+        const string v3 = tempPath("c4_log_v3.log");
+        vector<Move> m;
+        string p[2];
+        char sym[2];
+        int r = -1;
+        bool ok = GameLogger::save(v3, moves, players, symbols, 1)
+               && GameLogger::load(v3, m, p, sym, r) && same(m, p, sym, r);
+        vector<Move> wrongOrder = {{1, 3, 0}};
+        ok = ok && !GameLogger::save(tempPath("c4_log_bad.log"), wrongOrder, players, symbols, 1);
+        assertTrue(ok, "GameLogger: V3 Round-Trip fehlerhaft.");
+
+        // Namen über 255 Byte: gekürzt, aber kein halbes UTF-8-Zeichen
+        {
+            GameLog g, back;
+            g.players[0] = string(254, 'a') + "\xC3\xA4";        // ä an Byte 255/256
+            g.players[1] = string(253, 'b') + "\xE2\x82\xAC";    // € an Byte 254-256
+            vector<uint8_t> data;
+            size_t offset = 0;
+            ok = GameLogger::encode(g, data, &offset) && GameLogger::decode(data.data(), data.size(), back)
+              && back.players[0] == string(254, 'a') && back.players[1] == string(253, 'b')
+              && back.movesOffset == offset;
+            assertTrue(ok, "GameLogger: langer Name mitten im UTF-8-Zeichen abgeschnitten.");
+        }
+
+        // ein Bit kippen => Prüfsumme passt nicht mehr
+        {
+            fstream f(v3, ios::in | ios::out | ios::binary);
+            char c;
+            f.seekg(30);
+            f.get(c);
+            f.seekp(30);
+            f.put(static_cast<char>(c ^ 4));
+        }
+        assertTrue(!GameLogger::load(v3, m, p, sym, r), "GameLogger: beschädigtes V3-Log wurde akzeptiert.");
+        remove(v3.c_str());
+
+    #if HAS_FILESYSTEM
+        const fs::path dir = fs::temp_directory_path() / "c4_log_convert";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const string v2 = (dir / "a.log").string();
+        const string v1 = (dir / "b.log").string();
+        GameLogger::save(v2, moves, players, symbols, 1, LogFormat::V2);
+        {
+            ofstream out(v1);
+            out << "CONNECT4_LOG_V1\nPLAYER0:Anna\nPLAYER1:Bert\nRESULT:0\nMOVE;0;3\nMOVE;1;2\n";
+        }
+        ok = GameLogger::load(v2, m, p, sym, r) && same(m, p, sym, r);
+        size_t sizeV2 = fs::file_size(v2);
+        stringstream log;
+        ok = ok && GameLogger::convertDirectory(dir.string(), log) == 0;
+        ok = ok && GameLogger::load(v2, m, p, sym, r) && same(m, p, sym, r) && fs::file_size(v2) < sizeV2;
+        GameLog g;
+        ok = ok && GameLogger::read(v1, g) && g.rows == ROWS && g.players[1] == "Bert"
+                && g.moves.size() == 2 && g.moves[1].col == 2 && g.moves[1].playerIndex == 1;
+        fs::remove_all(dir);
+        assertTrue(ok, "GameLogger: V1/V2 nicht lesbar oder Konvertierung fehlerhaft.");
+    #endif
+    }
+
+    // Test 22: Log-Katalog – Aufbau, Anhängen beim Speichern, Neuaufbau, Filter
+#if HAS_FILESYSTEM
+    {
+        cout << "teste LogCatalog: Aufbau, Anhängen, Neuaufbau, Filter... \n";
+        const fs::path dir = fs::temp_directory_path() / "c4_log_catalog";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const char symbols[2] = {'X', 'O'};
+        const string annaBert[2] = {"Anna", "Bert"};
+        const string bertCarl[2] = {"Bert", "Computer"};
+        const vector<Move> moves = {{0, 3, 100}, {1, 2, 200}, {0, 3, 300}};
+        GameLogger::save((dir / "a.log").string(), moves, annaBert, symbols, 1, LogFormat::V2);
+        GameLogger::save((dir / "b.log").string(), moves, bertCarl, symbols, 2);
+
+        LogCatalog catalog;
+        string status;
+        bool ok = catalog.open(dir.string(), &status) && catalog.size() == 2
+               && status.find("2 Logs gelesen") != string::npos;
+        ok = ok && catalog.open(dir.string(), &status) && status.find("aktuell") != string::npos;
+
+        // save trägt selbst ein: kein Neuaufbau nötig
+        catalog.close();
+        GameLogger::save((dir / "c.log").string(), moves, annaBert, symbols, 0);
+        ok = ok && catalog.open(dir.string(), &status) && catalog.size() == 3
+                && status.find("aktuell") != string::npos;
+
+        // movesOffset zeigt auf die Zugdaten (V2: erste MOVE-Zeile)
+        GameLog g;
+        for (size_t i = 0; ok && i < catalog.size(); ++i) {
+            const CatalogEntry& e = catalog.entry(i);
+            ok = GameLogger::read(catalog.path(e), g) && e.movesOffset == g.movesOffset
+              && e.moveCount == 3 && g.players[0] == e.players[0];
+        }
+        {
+            ifstream in((dir / "a.log").string());
+            string line;
+            for (size_t i = 0; ok && i < catalog.size(); ++i) {
+                if (string(catalog.entry(i).file) != "a.log") continue;
+                in.seekg(static_cast<streamoff>(catalog.entry(i).movesOffset));
+                ok = getline(in, line) && line == "MOVE;0;3;100";
+            }
+        }
+
+        // von außen angelegt => Neuaufbau, nur die neue Datei wird gelesen
+        catalog.close();
+        {
+            ofstream out((dir / "d.log").string());
+            out << "CONNECT4_LOG_V1\nPLAYER0:Dora\nPLAYER1:Emil\nRESULT:0\nMOVE;0;3\n";
+        }
+        ok = ok && catalog.open(dir.string(), &status) && catalog.size() == 4
+                && status.find("1 Logs gelesen") != string::npos;
+
+        LogCatalog::Filter f;
+        ok = ok && catalog.select(f).size() == 4;
+        f.player = "bErT";
+        ok = ok && catalog.select(f).size() == 3;
+        f.result = 0;
+        ok = ok && catalog.select(f).size() == 1;
+        f = LogCatalog::Filter{};
+        if (catalog.size() > 0) f.date = LogCatalog::formatTime(catalog.entry(0).timestamp).substr(0, 7);
+        ok = ok && catalog.select(f).size() == 4;
+        f.date = "1999";
+        ok = ok && catalog.select(f).empty();
+
+        // Name länger als das Feld: ganze UTF-8-Zeichen; Dateiname länger als
+        // das Feld: Eintrag mit LONG_NAME, path() findet die Datei trotzdem.
+        // Einmal per save eingetragen, einmal beim Neuaufbau
+        catalog.close();
+        const string longNames[2] = {string(30, 'a') + "ü", "Bert"};
+        const string longFile = (dir / (string(80, 'l') + ".log")).string();
+        GameLogger::save(longFile, moves, longNames, symbols, 1);
+        for (int pass = 0; ok && pass < 2; ++pass) {
+            if (pass == 1) fs::remove(dir / LogCatalog::FILE_NAME);
+            ok = catalog.open(dir.string(), &status) && catalog.size() == 5;
+            bool found = false;
+            for (size_t i = 0; ok && i < catalog.size(); ++i) {
+                const CatalogEntry& e = catalog.entry(i);
+                if (!(e.flags & CatalogEntry::LONG_NAME)) continue;
+                found = catalog.path(e) == longFile && string(e.players[0]) == string(30, 'a');
+            }
+            ok = ok && found;
+        }
+
+        // Speichern während eines Neuaufbaus: kein Log fehlt in einem
+        // Katalog, der sich für aktuell hält
+        catalog.close();
+        atomic<bool> stop{false};
+        thread saver([&]() {
+            for (int i = 0; !stop; ++i)
+                GameLogger::save((dir / ("s" + to_string(i) + ".log")).string(), moves, annaBert, symbols, 1);
+        });
+        for (int i = 0; i < 40; ++i) {
+            ofstream((dir / ("x" + to_string(i) + ".log")).string())
+                << "CONNECT4_LOG_V1\nPLAYER0:Dora\nPLAYER1:Emil\nRESULT:0\nMOVE;0;3\n";
+            LogCatalog other;
+            other.open(dir.string());
+        }
+        stop = true;
+        saver.join();
+        ok = ok && catalog.open(dir.string(), &status) && catalog.size() == listLogFiles(dir.string()).size();
+        catalog.close();
+        fs::remove_all(dir);
+        assertTrue(ok, "LogCatalog: Katalog unvollständig, veraltet oder Filter falsch.");
+    }
+#endif
+
+    // Test 23: Statistik-Snapshot – nur neue Zeilen, Neuaufbau bei kaputtem Snapshot/neuer CSV
+    {
+        cout << "teste Stats: Snapshot fortschreiben und verwerfen... \n";
+        const string csv = tempPath("c4_stats_snap.csv");
+        const string snap = Stats::snapshotPath(csv);
+        remove(csv.c_str());
+        remove(snap.c_str());
+
+        auto game = [](const string& a, const string& b, int result, long long ms) {
+            const string players[2] = {a, b};
+            return Stats::summarize(players, result, {{0, 3, ms}, {1, 2, ms * 2}, {0, 3, ms / 2}});
+        };
+        // vollständiges Neueinlesen als Referenz
+        auto fresh = [&]() {
+            remove(snap.c_str());
+            return Stats::loadAggregated(csv);
+        };
+        auto same = [](const vector<PlayerStats>& a, const vector<PlayerStats>& b) {
+            if (a.size() != b.size()) return false;
+            for (const PlayerStats& x : a) {
+                bool found = false;
+                for (const PlayerStats& y : b)
+                    found = found || (x.name == y.name && x.games == y.games && x.wins == y.wins
+                        && x.draws == y.draws && x.losses == y.losses && x.moves == y.moves
+                        && x.totalMoveMs == y.totalMoveMs && x.fastestMoveMs == y.fastestMoveMs
+                        && x.slowestMoveMs == y.slowestMoveMs);
+                if (!found) return false;
+            }
+            return true;
+        };
+
+        Stats::appendGames(csv, {game("Anna", "Bert", 1, 40), game("Bert", "Carl", 0, 7)});
+        vector<PlayerStats> first = Stats::loadAggregated(csv);
+        bool ok = first.size() == 3 && ifstream(snap).good();
+
+        Stats::appendGames(csv, {game("Carl", "Anna", 2, 900)});
+        {
+            // halbe Zeile (Schreiber noch nicht fertig) zählt noch nicht
+            ofstream out(csv, ios::app | ios::binary);
+            out << "Dora,Emil,1,5";
+        }
+        vector<PlayerStats> incremental = Stats::loadAggregated(csv);
+        ok = ok && same(incremental, fresh());
+        int annaGames = 0;
+        for (const PlayerStats& s : incremental) if (s.name == "Anna") annaGames = s.games;
+        ok = ok && annaGames == 2;
+        {
+            ofstream out(csv, ios::app | ios::binary);
+            out << ",2,2,5,5,5,5,5,5\n";
+        }
+        incremental = Stats::loadAggregated(csv);
+        ok = ok && incremental.size() == 5 && same(incremental, fresh());
+
+        // Snapshot beschädigt => stilles Neueinlesen
+        {
+            fstream f(snap, ios::in | ios::out | ios::binary);
+            f.seekp(20);
+            f.put('\x7f');
+        }
+        ok = ok && same(Stats::loadAggregated(csv), incremental);
+
+        // CSV neu angelegt (kürzer als der Snapshot-Offset) => Neueinlesen
+        remove(csv.c_str());
+        Stats::appendGames(csv, {game("Zoe", "Yann", 0, 1)});
+        ok = ok && Stats::loadAggregated(csv).size() == 2;
+
+        remove(csv.c_str());
+        remove(snap.c_str());
+        assertTrue(ok, "Stats: Snapshot liefert andere Werte als vollständiges Einlesen.");
+    }
+
+    // Test 24: stats.csv-Parser – kaputte Zeilen überspringen, Threads = ein Thread
+    {
+        cout << "teste Stats: CSV-Parser mit Fehlerzeilen und mehreren Threads... \n";
+        const string csv = tempPath("c4_stats_parse.csv");
+        const string snap = Stats::snapshotPath(csv);
+        remove(snap.c_str());
+        {
+            ofstream out(csv, ios::binary | ios::trunc);
+            out << "player0,player1,result,totalGameMs,moves0,moves1,totalMs0,totalMs1,fastest0,fastest1,slowest0,slowest1\n"
+                << "Anna,Bert,1,30,2,1,123456789012,7,-1,7,5,7\r\n"   // lange Zahl, -1, CRLF
+                << "Anna,Bert,x,30,2,1,10,7,3,7,5,7\n"                 // keine Zahl
+                << "Anna,Bert,1,30,2,1,10,7,3,7\n"                     // Felder fehlen
+                << "Anna,Bert,1,30,2,1,10,7,3,7,5,7,9\n"               // Feld zu viel
+                << "\n"
+                << "Bert,Anna,0,30,2,1,10,7,3,7,5,7\n";
+        }
+        CsvParseInfo info;
+        vector<PlayerStats> s = Stats::loadAggregated(csv, &info, 1);
+        bool ok = info.rows == 2 && info.badRows == 3 && info.firstBadOffset > 0 && s.size() == 2;
+        for (const PlayerStats& p : s) {
+            if (p.name == "Anna")
+                ok = ok && p.games == 2 && p.wins == 1 && p.draws == 1 && p.moves == 3
+                        && p.totalMoveMs == 123456789019 && p.fastestMoveMs == 5 && p.slowestMoveMs == 7;
+        }
+        {
+            ifstream in(csv, ios::binary);
+            in.seekg(info.firstBadOffset);
+            string line;
+            ok = ok && getline(in, line) && line.rfind("Anna,Bert,x,", 0) == 0;
+        }
+
+        // groß genug für mehrere Teilstücke: gleiche Summen wie mit einem Thread
+        vector<GameSummary> games;
+        mt19937 rng(5);
+        for (int i = 0; i < 40000; ++i) {
+            const string players[2] = {"P" + to_string(rng() % 37), "Spieler mit langem Namen " + to_string(rng() % 11)};
+            games.push_back(Stats::summarize(players, static_cast<int>(rng() % 4) - 1,
+                {{0, 3, static_cast<long long>(rng() % 100000)}, {1, 2, static_cast<long long>(rng() % 9)}}));
+        }
+        // Anhängen an eine Datei mit alter Kopfzeile: die Kopfzeile wird erneuert
+        Stats::appendGames(csv, games);
+        {
+            ifstream in(csv, ios::binary);
+            string header;
+            ok = ok && getline(in, header) && header.find(",hist0,hist1") != string::npos;
+        }
+        remove(snap.c_str());
+        vector<PlayerStats> one = Stats::loadAggregated(csv, &info, 1);
+        ok = ok && info.rows == 40002 && info.badRows == 3;
+        remove(snap.c_str());
+        vector<PlayerStats> four = Stats::loadAggregated(csv, &info, 4);
+        ok = ok && info.rows == 40002 && info.badRows == 3 && one.size() == four.size();
+        for (const PlayerStats& a : one) {
+            bool found = false;
+            for (const PlayerStats& b : four)
+                found = found || (a.name == b.name && a.games == b.games && a.wins == b.wins
+                    && a.losses == b.losses && a.totalMoveMs == b.totalMoveMs
+                    && a.fastestMoveMs == b.fastestMoveMs && a.slowestMoveMs == b.slowestMoveMs);
+            ok = ok && found;
+        }
+        remove(csv.c_str());
+        remove(snap.c_str());
+        assertTrue(ok, "Stats: CSV-Parser zählt falsch oder Threads liefern andere Summen.");
+    }
+
+    // Test 25: Zugzeiten-Histogramm – Fächer, Perzentile, Text, über stats.csv
+    {
+        cout << "teste LatencyHistogram: Fächer, Perzentile, Persistenz... \n";
+        bool ok = true;
+        for (long long v : {0LL, 1LL, 31LL, 32LL, 33LL, 63LL, 64LL, 1000LL, 14999LL, 123456789LL, (1LL << 31) - 1}) {
+            const int b = LatencyHistogram::bucketOf(v);
+            const long long lo = LatencyHistogram::bucketLow(b), hi = LatencyHistogram::bucketHigh(b);
+            ok = ok && b >= 0 && b < LatencyHistogram::BUCKETS && lo <= v && v <= hi
+                    && (hi - lo) * 16 <= lo + 15;   // höchstens 1/16 relativ
+        }
+        ok = ok && LatencyHistogram::bucketOf(1LL << 40) == LatencyHistogram::BUCKETS - 1;
+
+        LatencyHistogram a, b;
+        for (long long v = 1; v <= 1000; ++v) (v % 2 ? a : b).record(v);
+        ok = ok && a.count() == 500 && b.count() == 500;
+        a.merge(b);
+        const long long p50 = a.percentile(50), p90 = a.percentile(90), p99 = a.percentile(99);
+        ok = ok && a.count() == 1000 && abs(p50 - 500) <= 32 && abs(p90 - 900) <= 57 && abs(p99 - 990) <= 62;
+        ok = ok && LatencyHistogram().percentile(50) == -1;
+
+        string text;
+        a.appendText(text);
+        LatencyHistogram c;
+        ok = ok && c.addText(text) && c.count() == 1000 && c.percentile(90) == p90;
+        ok = ok && !c.addText("3:1;x") && !c.addText("99999:1") && !c.addText("3:") && c.count() == 1000;
+
+        // über stats.csv: Zeiten pro Zug landen beim richtigen Spieler
+        const string csv = tempPath("c4_stats_hist.csv");
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+        const string players[2] = {"Schnell", "Langsam"};
+        vector<GameSummary> games;
+        for (int g = 0; g < 50; ++g) {
+            vector<Move> moves;
+            for (int i = 0; i < 20; ++i) moves.push_back({i % 2, i % 7, i % 2 ? 2000 + g * 10 : 100 + i});
+            games.push_back(Stats::summarize(players, 1, moves));
+        }
+        Stats::appendGames(csv, games);
+        {
+            ofstream out(csv, ios::app);
+            // zweites Histogramm kaputt: ganze Zeile weg, auch das erste zählt nicht
+            out << "Schnell,Langsam,1,10,1,1,5,5,5,5,5,5,3:7,3:x\n";
+            out << "Schnell,Langsam,0,10,1,1,5,5,5,5,5,5\n";   // altes Format ohne Histogramme
+        }
+        for (int pass = 0; pass < 2; ++pass) {   // einmal frisch, einmal aus dem Snapshot
+            CsvParseInfo info;
+            for (const PlayerStats& s : Stats::loadAggregated(csv, &info, 1)) {
+                if (s.name == "Schnell") ok = ok && s.moveTimes.count() == 500 && abs(s.moveTimes.percentile(50) - 109) <= 4;
+                if (s.name == "Langsam") ok = ok && s.moveTimes.count() == 500 && s.moveTimes.percentile(99) >= 2400;
+            }
+            ok = ok && (pass == 1 || (info.rows == 51 && info.badRows == 1));
+        }
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+        assertTrue(ok, "LatencyHistogram: Fächer, Perzentile oder Persistenz fehlerhaft.");
+    }
+
+    // Test 26: StatsWriter – mehrere Schreiber auf eine Datei, Bündeln, Zeitgeber
+    {
+        cout << "teste StatsWriter: gesperrtes, gebündeltes Anhängen... \n";
+        const string csv = tempPath("c4_stats_writer.csv");
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+
+        // jeder Thread mit eigenem Writer (eigener Deskriptor => flock greift wie zwischen Prozessen)
+        const int producers = 4, perProducer = 1500;
+        vector<thread> threads;
+        for (int t = 0; t < producers; ++t) {
+            threads.emplace_back([&, t]() {
+                StatsWriter writer(csv, 64, 5);
+                const string players[2] = {"Schreiber " + to_string(t), "Gegner"};
+                for (int i = 0; i < perProducer; ++i)
+                    writer.add(Stats::summarize(players, 1 + i % 2, {{0, i % 7, i}, {1, 3, 2 * i}}));
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        CsvParseInfo info;
+        vector<PlayerStats> all = Stats::loadAggregated(csv, &info, 1);
+        bool ok = info.rows == static_cast<size_t>(producers * perProducer) && info.badRows == 0 && all.size() == 5;
+        {
+            ifstream in(csv);
+            string line;
+            int headers = 0;
+            while (getline(in, line)) headers += line.rfind("player0,", 0) == 0;
+            ok = ok && headers == 1;
+        }
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+
+        // Bündeln nach Zeilenzahl, Rest im Destruktor
+        const string players[2] = {"A", "B"};
+        const GameSummary g = Stats::summarize(players, 0, {{0, 3, 10}});
+        {
+            StatsWriter writer(csv, 10, 0);
+            for (int i = 0; i < 25; ++i) writer.add(g);
+            ok = ok && writer.writes() == 2 && writer.pendingRows() == 5;
+        }
+        ok = ok && Stats::loadAggregated(csv, &info, 1).size() == 2 && info.rows == 25;
+
+        // Zeitgeber schreibt auch ohne volle Ladung
+        {
+            StatsWriter writer(csv, 1000, 20);
+            writer.add(g);
+            for (int i = 0; i < 100 && writer.pendingRows() > 0; ++i) this_thread::sleep_for(chrono::milliseconds(10));
+            ok = ok && writer.pendingRows() == 0 && writer.writes() == 1 && !writer.failed();
+        }
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+        assertTrue(ok, "StatsWriter: Zeilen fehlen, verschränkt oder nicht gebündelt.");
+    }
+
+    // Test 27: Logs prüfen – Regeln, RESULT gegen Brett, ganzer Ordner
+    {
+        cout << "teste GameLogger::verify: Regeln, Ergebnis, Ordner... \n";
+        auto game = [](const string& cols, int result) {
+            GameLog g;
+            for (size_t i = 0; i < cols.size(); ++i) g.moves.push_back({static_cast<int>(i % 2), cols[i] - '1', 0});
+            g.result = result;
+            return g;
+        };
+        string why;
+        size_t valid = 0;
+        bool ok = GameLogger::verify(game("1212121", 1))              // senkrechter Vierer
+               && GameLogger::verify(game("4455", -1))                 // offen/abgebrochen
+               && GameLogger::verify(game("4455", 2))                  // Spieler 1 am Zug, Zeitlimit
+               && !GameLogger::verify(game("44553", 2), &why)          // Zeitlimit: Gewinner wäre Spieler 1
+               && !GameLogger::verify(game("1212121", 2), &why)
+               && !GameLogger::verify(game("12121212", 1), &why, &valid) && valid == 7
+               && !GameLogger::verify(game("1111111", -1), &why, &valid) && valid == 6
+               && why.find("Zug 7") != string::npos;
+        GameLog wrongPlayer = game("123", -1);
+        wrongPlayer.moves[1].playerIndex = 0;
+        ok = ok && !GameLogger::verify(wrongPlayer, &why, &valid) && valid == 1;
+
+        // volles Brett ohne Vierer: Remis
+        string draw;
+        {
+            const string order = "1234567";
+            BitBoard b;
+            mt19937 rng(3);
+            while (true) {
+                draw.clear();
+                b.reset();
+                bool won = false;
+                while (!b.isFull() && !won) {
+                    int c = order[rng() % 7] - '1';
+                    int r = b.dropDisc(c);
+                    if (r < 0) continue;
+                    draw += char('1' + c);
+                    won = b.checkWinAt(r, c);
+                }
+                if (!won) break;
+            }
+        }
+        ok = ok && GameLogger::verify(game(draw, 0)) && !GameLogger::verify(game(draw, 1));
+    #if HAS_FILESYSTEM
+        const fs::path dir = fs::temp_directory_path() / "c4_log_verify";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const string players[2] = {"A", "B"};
+        const char symbols[2] = {'X', 'O'};
+        const GameLog good[] = {game("1212121", 1), game(draw, 0), game("4455", -1)};
+        for (int i = 0; i < 3; ++i)
+            GameLogger::save((dir / ("ok" + to_string(i) + ".log")).string(), good[i].moves, players, symbols, good[i].result);
+        GameLog bad = game("1212121", 2);
+        GameLogger::save((dir / "bad0.log").string(), bad.moves, players, symbols, bad.result);
+        {
+            ofstream out((dir / "bad1.log").string());
+            out << "CONNECT4_LOG_V2\nRESULT:0\nMOVE;0;9;0\n";
+        }
+        stringstream log;
+        ok = ok && GameLogger::verifyDirectory(dir.string(), 2, log) == 2
+                && log.str().find("bad1.log") != string::npos && log.str().find("5 Logs") != string::npos;
+        fs::remove_all(dir);
+    #endif
+        assertTrue(ok, "GameLogger::verify erkennt Regelverstöße oder falsches RESULT nicht.");
+    }
+
+    // Test 28: Screen – Diff-Ausgabe ergibt auf einem nachgebildeten Terminal den Frame
+    {
+        cout << "teste Screen: Diff-Ausgabe gegen nachgebildetes Terminal... \n";
+        // versteht genau die Folgen, die Screen ausgibt: CSI r;c H, CSI H, CSI 2J, CSI J, \r, \n
+        vector<vector<string>> term(Screen::HEIGHT, vector<string>(Screen::WIDTH, " "));
+        int tr = 0, tc = 0;
+        auto apply = [&](const string& o) {
+            for (size_t i = 0; i < o.size();) {
+                if (o[i] == '\033') {
+                    size_t end = o.find_first_of("HJ", i);
+                    string args = o.substr(i + 2, end - i - 2);
+                    if (o[end] == 'H') {
+                        int r = 1, c = 1;
+                        if (!args.empty()) sscanf(args.c_str(), "%d;%d", &r, &c);
+                        tr = r - 1;
+                        tc = c - 1;
+                    } else {
+                        // 2J: alles, J: ab Cursor
+                        for (int r = (args == "2" ? 0 : tr); r < Screen::HEIGHT; ++r)
+                            for (int c = (args == "2" || r > tr ? 0 : tc); c < Screen::WIDTH; ++c) term[r][c] = " ";
+                    }
+                    i = end + 1;
+                } else if (o[i] == '\r') {
+                    tc = 0;
+                    ++i;
+                } else if (o[i] == '\n') {
+                    ++tr;
+                    ++i;
+                } else {
+                    size_t len = 1;
+                    while (i + len < o.size() && (static_cast<unsigned char>(o[i + len]) & 0xC0) == 0x80) ++len;
+                    term[tr][tc++] = o.substr(i, len);
+                    i += len;
+                }
+            }
+        };
+        auto matches = [&](const Screen& screen) {
+            for (int r = 0; r < Screen::HEIGHT; ++r) {
+                string row;
+                for (const string& cell : term[r]) row += cell;
+                while (!row.empty() && row.back() == ' ') row.pop_back();
+                if (row != screen.line(r)) return false;
+            }
+            return true;
+        };
+
+        Screen screen;
+        Board board;
+        mt19937 rng(28);
+        bool ok = true;
+        for (int frame = 0; frame < 300 && ok; ++frame) {
+            if (frame % 50 == 17) screen.invalidate();
+            if (frame % 40 == 0) board.reset();
+            int col = static_cast<int>(rng() % COLS);
+            if (board.getDropRow(col) >= 0 && rng() % 3 == 0) board.dropDisc(col, rng() % 2 ? 'X' : 'O');
+
+            screen.clear();
+            int row = board.draw(screen, 0, 'X', 'O', static_cast<int>(rng() % ROWS), col, 'X');
+            // Statuszeilen wechselnder Länge und Anzahl: alte Reste müssen verschwinden
+            for (int k = static_cast<int>(rng() % 4); k > 0; --k)
+                screen.text(row++, static_cast<int>(rng() % 5), string(rng() % 40, 'a' + k) + "→ü");
+            const string& o = screen.render();
+            apply(o);
+            ok = matches(screen);
+        }
+        // nur der fallende Stein ändert sich: zwei Zellen, kein ganzes Brett
+        screen.clear();
+        board.draw(screen, 0, 'X', 'O', 0, 3, 'X');
+        apply(screen.render());
+        screen.clear();
+        board.draw(screen, 0, 'X', 'O', 1, 3, 'X');
+        const string& ghost = screen.render();
+        const size_t ghostBytes = ghost.size();
+        apply(ghost);
+        ok = ok && matches(screen) && ghostBytes < 40;
+        assertTrue(ok, "Screen: Diff-Ausgabe weicht vom Frame ab oder ist zu groß.");
+    }
+
+    // Test 29: EventLoop – Zeitgeber nach Fälligkeit, gleiche Fälligkeit in Reihenfolge, stop()
+    {
+        cout << "teste EventLoop: Zeitgeber-Reihenfolge und stop()... \n";
+        EventLoop loop;
+        string order;
+        auto t0 = EventLoop::Clock::now();
+        loop.after(30, [&]() { order += 'd'; });
+        loop.after(10, [&]() { order += 'b'; });
+        loop.after(10, [&]() {
+            order += 'c';
+            // aus einem Rückruf angelegt, sofort fällig: läuft vor 'd'
+            loop.after(0, [&]() { order += 'x'; });
+        });
+        loop.after(0, [&]() { order += 'a'; });
+        loop.run();   // endet von selbst: kein Handler, keine Zeitgeber mehr
+        auto ms = chrono::duration_cast<chrono::milliseconds>(EventLoop::Clock::now() - t0).count();
+        bool ok = order == "abcxd" && ms >= 30 && loop.pendingTimers() == 0;
+
+        // stop() beendet run(), übrige Zeitgeber bleiben liegen
+        loop.after(0, [&]() { order += 's'; loop.stop(); });
+        loop.after(5, [&]() { order += '!'; });
+        loop.run();
+        ok = ok && order == "abcxds" && loop.pendingTimers() == 1;
+        assertTrue(ok, "EventLoop: Zeitgeber in falscher Reihenfolge (" + order + ") oder stop() wirkt nicht.");
+    }
+
+    // Test 30: EventLoop – post() aus anderem Thread weckt select(), Frist pünktlich
+    {
+        cout << "teste EventLoop: post() weckt, Frist pünktlich... \n";
+        EventLoop loop;
+        using Clock = EventLoop::Clock;
+        const auto t0 = Clock::now();
+        Clock::time_point fired, posted;
+        loop.at(t0 + chrono::milliseconds(60), [&]() { fired = Clock::now(); });
+        // hält die Schleife 2 s am Leben, wenn post() nicht weckt
+        loop.after(2000, [&]() {});
+        thread worker([&]() {
+            this_thread::sleep_for(chrono::milliseconds(100));
+            loop.post([&]() {
+                posted = Clock::now();
+                loop.stop();
+            });
+        });
+        loop.run();
+        worker.join();
+        const auto late = chrono::duration_cast<chrono::milliseconds>(fired - t0).count();
+        const auto wake = chrono::duration_cast<chrono::milliseconds>(posted - t0).count();
+        // nur Reihenfolge und grobe Schranken: auf geteilten CI-Maschinen
+        // kann jeder Aufwachzeitpunkt um einige 10 ms danebenliegen
+        const bool ok = fired != Clock::time_point{} && fired <= posted
+                     && late >= 60 && late < 500 && wake >= 100 && wake < 500;
+        assertTrue(ok, "EventLoop: Frist nach " + to_string(late) + " ms statt 60, post() nach "
+                       + to_string(wake) + " ms.");
+    }
+
+    // Test 31: Spielserver – Protokoll, Zeitlimit ohne Anfrage, Logs/Statistik, Socket
+    {
+        cout << "teste Spielserver: Protokoll, Zeitlimit, Socket... \n";
+        using Clock = GameServer::Clock;
+        bool ok = true;
+    #if HAS_FILESYSTEM
+        const fs::path dir = fs::temp_directory_path() / "c4_server_test";
+        fs::remove_all(dir);
+        GameServer::Options options;
+        options.socketPath.clear();
+        options.logDir = dir.string();
+        options.csvPath = (dir / "stats.csv").string();
+        options.turnLimitMs = 50;
+        {
+            GameServer server(options);
+            const auto t0 = Clock::now();
+            auto ask = [&](const string& line, Clock::time_point now) {
+                string out;
+                server.handle(line, now, out);
+                return out;
+            };
+            ok = ok && ask("NEW none", t0) == "OK 1 - TURN0\n";
+            for (char col : string("445566")) ask(string("MOVE 1 ") + col, t0);
+            ok = ok && ask("MOVE 1 7", t0) == "OK 1 4455667 WIN0\n"
+                    && ask("MOVE 1 1", t0) == "OK 1 4455667 WIN0\n";
+            // Computer beginnt und antwortet im selben Aufruf
+            const string engine = ask("NEW greedy 2 T", t0);
+            ok = ok && engine.size() == 13 && engine.compare(0, 5, "OK 2 ") == 0 && engine.compare(6, 7, " TURN1\n") == 0;
+            ok = ok && ask("MOVE 2 9", t0) == "ERR 2 Ungültige Spalte\n"
+                    && ask("MOVE 7 1", t0) == "ERR 7 Unbekannte Partie\n"
+                    && ask("NEW alphazero", t0) == "ERR - Unbekannter Gegner\n"
+                    && ask("HELLO", t0) == "ERR - Unbekannter Befehl\n";
+            ok = ok && ask("NEW none", t0) == "OK 3 - TURN0\n" && ask("RESIGN 3", t0) == "OK 3 - WIN1 RESIGN\n";
+            // Zeitlimit: über expire() ohne Anfrage, und ein zu später Zug
+            ok = ok && ask("NEW none", t0) == "OK 4 - TURN0\n" && ask("NEW none", t0) == "OK 5 - TURN0\n";
+            ok = ok && ask("MOVE 4 1", t0 + chrono::milliseconds(20)) == "OK 4 1 TURN1\n";
+            server.expire(t0 + chrono::milliseconds(60));
+            ok = ok && ask("STATE 4", t0 + chrono::milliseconds(60)) == "OK 4 1 TURN1\n"
+                    && ask("STATE 5", t0 + chrono::milliseconds(60)) == "OK 5 - WIN1 TIMEOUT\n"
+                    && ask("MOVE 4 2", t0 + chrono::milliseconds(71)) == "OK 4 1 WIN0 TIMEOUT\n";
+            // beendete Partien verschwinden nach einem weiteren Zeitlimit (Partie 2 lief auch ab)
+            server.expire(t0 + chrono::milliseconds(500));
+            ok = ok && ask("STATE 4", t0) == "ERR 4 Unbekannte Partie\n" && server.activeGames() == 0;
+            ok = ok && server.counters().gamesFinished == 5 && server.counters().timeouts == 3;
+        }
+        CsvParseInfo info;
+        Stats::loadAggregated(options.csvPath, &info, 1);
+        stringstream log;
+        ok = ok && info.rows == 5 && GameLogger::verifyDirectory(dir.string(), 1, log) == 0
+                && log.str().find("5 Logs") != string::npos;
+        fs::remove_all(dir);
+    #endif
+    #if defined(__linux__)
+        // über den Socket: Anfragen am Stück, Antworten in Reihenfolge
+        GameServer::Options socketOptions;
+        socketOptions.socketPath = tempPath("c4_test_server.sock");
+        socketOptions.logDir.clear();
+        socketOptions.csvPath.clear();
+        GameServer server(socketOptions);
+        ok = ok && server.listen();
+        thread serving([&]() { server.run(); });
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socketOptions.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        string reply;
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            const string request = "NEW none\nMOVE 1 4\r\nMOVE 1 4\nSTATE 1\nQUIT\n";
+            ok = ok && ::write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size());
+            char buf[256];
+            ssize_t n;
+            while ((n = ::read(fd, buf, sizeof(buf))) > 0) reply.append(buf, static_cast<size_t>(n));
+        }
+        if (fd >= 0) ::close(fd);
+        ok = ok && reply == "OK 1 - TURN0\nOK 1 4 TURN1\nOK 1 44 TURN0\nOK 1 44 TURN0\n";
+
+        // langsame Gegner: abgelehnt bzw. gedeckelt, eine zweite Verbindung
+        // bekommt ihre Antwort trotzdem sofort
+        auto connectClient = [&]() {
+            int c = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            timeval limit{5, 0};   // kaputter Server: Test schlägt fehl statt zu hängen
+            if (c >= 0) ::setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+            if (c >= 0 && ::connect(c, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                ::close(c);
+                c = -1;
+            }
+            return c;
+        };
+        auto readLines = [](int c, int lines) {
+            string text;
+            char ch;
+            while (lines > 0 && ::read(c, &ch, 1) == 1) {
+                text += ch;
+                lines -= ch == '\n';
+            }
+            return text;
+        };
+        const int slow = connectClient(), quick = connectClient();
+        ok = ok && slow >= 0 && quick >= 0;
+        if (slow >= 0 && quick >= 0) {
+            const string request = "NEW time:4000 2\nNEW mcts:100000000 2\nNEW search:42 2\nNEW search:"
+                                 + to_string(GameServer::MAX_SEARCH_DEPTH) + " 2\n";
+            ok = ok && ::write(slow, request.data(), request.size()) == static_cast<ssize_t>(request.size());
+            const auto sent = Clock::now();
+            ok = ok && ::write(quick, "NEW none\n", 9) == 9;
+            const string answer = readLines(quick, 1);
+            const auto waited = chrono::duration_cast<chrono::milliseconds>(Clock::now() - sent).count();
+            const string slowAnswer = readLines(slow, 4);
+            ok = ok && answer.compare(0, 3, "OK ") == 0 && answer.find(" - TURN0\n") != string::npos && waited < 500
+                    && slowAnswer.rfind("ERR - Gegner rechnet zu lange\nERR - Gegner rechnet zu lange\n"
+                                        "ERR - Gegner rechnet zu lange\nOK ", 0) == 0
+                    && slowAnswer.find(" TURN1\n") != string::npos;
+        }
+        if (slow >= 0) ::close(slow);
+        if (quick >= 0) ::close(quick);
+        server.stop();
+        serving.join();
+    #endif
+        assertTrue(ok, "GameServer: falsche Antwort, Zeitlimit oder Logs/Statistik fehlerhaft.");
+    }
+
+    // Test 32: Elo – bekannte Werte, Snapshot, Turnier unabhängig von Threads
+    {
+        cout << "teste Elo und Rundenturnier... \n";
+        auto player = [](const string& name, int wins, int draws, int losses) {
+            PlayerStats s;
+            s.name = name;
+            s.games = wins + draws + losses;
+            s.wins = wins; s.draws = draws; s.losses = losses;
+            return s;
+        };
+        // 9:1 plus gedachtes Remis = 9,5 aus 11: 400 * log10(9,5 / 1,5) ≈ 320,6 Abstand
+        vector<PlayerStats> pair = {player("A", 9, 0, 1), player("B", 1, 0, 9), player("C", 0, 0, 0)};
+        Stats::computeElo(pair, {{0, 1, 10}});
+        bool ok = fabs(pair[0].elo - 160.3) < 0.5 && fabs(pair[0].elo + pair[1].elo) < 1e-6
+                  && pair[2].elo == 0.0 && pair[2].eloError < 0 && pair[0].eloError > 0;
+        vector<PlayerStats> even = {player("A", 5, 0, 5), player("B", 5, 0, 5)};
+        Stats::computeElo(even, {{0, 1, 10}});
+        vector<PlayerStats> evenMore = {player("A", 50, 0, 50), player("B", 50, 0, 50)};
+        Stats::computeElo(evenMore, {{0, 1, 100}});
+        ok = ok && fabs(even[0].elo) < 1e-6 && fabs(even[1].elo) < 1e-6
+                && evenMore[0].eloError < even[0].eloError / 2;
+
+        // aus der CSV: gleiche Werte mit und ohne Snapshot
+        const string csv = tempPath("c4_elo_test.csv");
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+        vector<GameSummary> games;
+        for (int i = 0; i < 10; ++i) {
+            // Farben wechseln, A gewinnt alle außer der ersten
+            const bool aFirst = i % 2 == 0;
+            const string players[2] = {aFirst ? "A" : "B", aFirst ? "B" : "A"};
+            games.push_back(Stats::summarize(players, (i != 0) == aFirst ? 1 : 2, {}));
+        }
+        const string self[2] = {"A", "A"};
+        games.push_back(Stats::summarize(self, 1, {}));   // gegen sich selbst: zählt nicht für Elo
+        Stats::appendGames(csv, games);
+        auto eloOf = [](const vector<PlayerStats>& stats, const string& name) {
+            for (const PlayerStats& s : stats) if (s.name == name) return s.elo;
+            return -1e9;
+        };
+        // ohne Elo keine Paarungen im Snapshot: die Elo-Ansicht liest dann alles neu
+        const vector<PlayerStats> plain = Stats::loadAggregated(csv);
+        const vector<PlayerStats> parsed = Stats::loadAggregated(csv, nullptr, 0, true);
+        Stats::appendGames(csv, {Stats::summarize(self, 0, {})});
+        ok = ok && Stats::loadAggregated(csv).size() == 2;   // führt die Paarungen weiter
+        const vector<PlayerStats> cached = Stats::loadAggregated(csv, nullptr, 0, true);
+        ok = ok && eloOf(plain, "A") == 0.0 && fabs(eloOf(parsed, "A") - 160.3) < 0.5
+                && eloOf(cached, "A") == eloOf(parsed, "A") && eloOf(cached, "B") == eloOf(parsed, "B");
+        remove(csv.c_str());
+        remove(Stats::snapshotPath(csv).c_str());
+
+        Tournament::Options options;
+        Policy random, greedy;
+        Policy::parse("random", random);
+        Policy::parse("greedy", greedy);
+        options.engines = {random, greedy, greedy};
+        options.games = 6;
+        options.csvPath = tempPath("c4_tournament_test.csv");
+        remove(options.csvPath.c_str());
+        stringstream log;
+        options.threads = 1;
+        const Tournament::Summary one = Tournament::run(options, log);
+        options.threads = 3;
+        const Tournament::Summary three = Tournament::run(options, log);
+        ok = ok && one.games == 18 && three.games == 18 && one.standings.size() == 3
+                && Tournament::names(options.engines)[2] == "Greedy 2";
+        for (size_t i = 0; ok && i < one.standings.size(); ++i)
+            ok = one.standings[i].name == three.standings[i].name && one.standings[i].wins == three.standings[i].wins
+                 && one.standings[i].elo == three.standings[i].elo;
+        ok = ok && one.standings.back().name == "Random" && log.str().find("Elo-Rangliste") != string::npos;
+        CsvParseInfo info;
+        Stats::loadAggregated(options.csvPath, &info, 1);
+        ok = ok && info.rows == 36 && info.badRows == 0;
+        remove(options.csvPath.c_str());
+        remove(Stats::snapshotPath(options.csvPath).c_str());
+        assertTrue(ok, "Elo/Turnier: falsche Wertung, Snapshot abweichend oder von der Thread-Anzahl abhängig.");
+    }
+
+    // Test 33: Brettgrößen – Gewinnlinien je Größe, 7x6 wie BitBoard, Logs mit Größe
+    {
+        cout << "teste GameBoard<Rows, Cols>: 5x4, 8x7, Abgleich mit BitBoard, Logs... \n";
+        static_assert(Board::LINE_COUNT == 69, "7x6 hat 69 Vierer-Linien");
+        static_assert(GameBoard<4, 5>::LINE_COUNT == 4 * 2 + 1 * 5 + 2 * 1 * 2, "5x4: falsche Linienzahl");
+        static_assert(GameBoard<7, 8>::LINE_COUNT == 7 * 5 + 4 * 8 + 2 * 4 * 5, "8x7: falsche Linienzahl");
+
+        // Zugfolge (Spalten 1..9) abwechselnd X/O; true = letzter Zug gewinnt
+        auto wins = [](auto board, const string& cols) {
+            bool won = false;
+            for (size_t i = 0; i < cols.size(); ++i) {
+                const int col = cols[i] - '1';
+                const int row = board.dropDisc(col, i % 2 ? 'O' : 'X');
+                if (row < 0) return false;
+                won = board.checkWinAt(row, col);
+                if (won && i + 1 != cols.size()) return false;
+            }
+            return won && board.checkWin((cols.size() - 1) % 2 ? 'O' : 'X');
+        };
+        using Small = GameBoard<4, 5>;
+        using Large = GameBoard<7, 8>;
+        bool ok = wins(Small(), "1122334") && wins(Small(), "1212121")          // waagrecht, senkrecht
+               && wins(Small(), "12233434544") && wins(Small(), "54433232122")     // beide Diagonalen
+               && !wins(Small(), "121212") && wins(Large(), "5566778") && wins(Large(), "8787878")
+               && wins(Large(), "56677878188") && !wins(Small(), "6");
+        Small full;
+        for (int i = 0; i < 20; ++i) full.dropDisc(i / 4, ((i % 4) / 2 + i / 4) % 2 ? 'O' : 'X');
+        ok = ok && full.isFull() && !full.checkWin('X') && !full.checkWin('O') && !full.isValidColumn(4);
+        assertTrue(ok, "GameBoard: Gewinn oder volles Brett bei 5x4/8x7 falsch erkannt.");
+
+        // 7x6: dieselben Ergebnisse wie BitBoard in Zufallspartien
+        mt19937 rng(33);
+        ok = true;
+        for (int g = 0; g < 2000 && ok; ++g) {
+            Board board;
+            BitBoard bits;
+            while (ok) {
+                int col = static_cast<int>(rng() % COLS);
+                if (!board.isValidColumn(col)) continue;
+                const int player = bits.currentPlayer();
+                const int row = board.dropDisc(col, player ? 'O' : 'X');
+                ok = row == bits.getDropRow(col);
+                bits.dropDisc(col);
+                const bool won = board.checkWinAt(row, col);
+                ok = ok && won == bits.checkWin(player) && won == board.checkWin(player ? 'O' : 'X')
+                        && board.isFull() == bits.isFull();
+                if (won || board.isFull()) break;
+            }
+        }
+        assertTrue(ok, "GameBoard<6, 7>: weicht von BitBoard ab.");
+
+        // Logs mit Brettgröße: V3 speichert sie, verify spielt auf dem passenden Brett nach
+        const string log = tempPath("c4_board_8x7.log");
+        const string players[2] = {"Anna", "Bert"};
+        const char symbols[2] = {'X', 'O'};
+        vector<Move> moves;
+        for (char c : string("5566778")) moves.push_back({static_cast<int>(moves.size() % 2), c - '1', 0});
+        GameLog g;
+        ok = GameLogger::save(log, moves, players, symbols, 1, LogFormat::V3, 7, 8)
+             && GameLogger::read(log, g) && g.rows == 7 && g.cols == 8 && GameLogger::verify(g);
+        g.result = 2;
+        ok = ok && !GameLogger::verify(g);
+        g.rows = 7; g.cols = 9;
+        string why;
+        ok = ok && !GameLogger::verify(g, &why) && why.find("Brettgröße") != string::npos;
+        ok = ok && !GameLogger::save(tempPath("c4_board_v2.log"), moves, players, symbols, 1, LogFormat::V2, 7, 8)
+                && !withBoardSize(7, 9, [](auto) {}) && !withBoardSize(6, 8, [](auto) {});
+        int seenCols = 0;
+        ok = ok && withBoardSize(4, 5, [&](auto board) { seenCols = decltype(board)::WIDTH; }) && seenCols == 5;
+        remove(log.c_str());
+        assertTrue(ok, "GameLogger: Log mit Brettgröße falsch gespeichert oder geprüft.");
+
+        // Rahmen passt sich der Spaltenzahl an, 7x6 unverändert
+        Screen screen;
+        screen.clear();
+        Small().draw(screen, 0, 'X', 'O');
+        Screen standard;
+        standard.clear();
+        Board().draw(standard, 0, 'X', 'O');
+        assertTrue(screen.line(1) == "    1   2   3   4   5" && screen.line(2) == "  ╔═══╦═══╦═══╦═══╦═══╗"
+                   && standard.line(1) == "    1   2   3   4   5   6   7"
+                   && standard.line(4) == "  ╠═══╬═══╬═══╬═══╬═══╬═══╬═══╣",
+                   "GameBoard::draw: Rahmen passt nicht zur Spaltenzahl.");
+    }
+
+    // Test 34: Kanonische Schlüssel – Spiegelpaare, Zobrist, Solver teilt TT-Einträge
+    {
+        cout << "teste canonicalKey und ZobristKey: Spiegelung, Eröffnungen, TT... \n";
+        mt19937 rng(34);
+        bool ok = true;
+        for (int i = 0; i < 300 && ok; ++i) {
+            // Partie und ihr Spiegelbild Zug für Zug
+            BitBoard b, m;
+            ZobristKey zb, zm;
+            const int plies = static_cast<int>(rng() % 30);
+            while (b.moveCount() < plies) {
+                const int col = static_cast<int>(rng() % COLS);
+                if (!b.isValidColumn(col)) continue;
+                const int player = b.currentPlayer();
+                zb.drop(player, b.dropDisc(col), col);
+                zm.drop(player, m.dropDisc(COLS - 1 - col), COLS - 1 - col);
+            }
+            bool mb = false, mm = false, zmb = false, zmm = false;
+            const uint64_t key = b.canonicalKey(&mb);
+            ok = key == m.canonicalKey(&mm) && BitBoard::fromKey(key).canonicalKey() == key
+                 && (mb != mm || b.key() == m.key())
+                 && zb.value() == ZobristKey::of(b).value() && zb.mirroredValue() == zm.value()
+                 && zb.canonical(&zmb) == zm.canonical(&zmm) && (zmb != zmm || zb.value() == zm.value());
+        }
+        assertTrue(ok, "canonicalKey/ZobristKey: Spiegelbild bekommt einen anderen Schlüssel.");
+
+        // Eröffnungen bis Halbzug 6: Spiegelung halbiert fast, Zobrist ohne Kollision
+        unordered_set<uint64_t> raw, canonical, zobrist;
+        auto expand = [&](auto&& self, const BitBoard& b, int plies) -> void {
+            if (!raw.insert(b.key()).second) return;
+            canonical.insert(b.canonicalKey());
+            zobrist.insert(ZobristKey::of(b).canonical());
+            for (int c = 0; plies > 0 && c < COLS; ++c) {
+                BitBoard child = b;
+                if (child.dropDisc(c) >= 0) self(self, child, plies - 1);
+            }
+        };
+        expand(expand, BitBoard(), 6);
+        assertTrue(canonical.size() == zobrist.size() && canonical.size() * 2 < raw.size() + 100
+                   && canonical.size() * 2 > raw.size(),
+                   "canonicalKey: Eröffnungen nicht auf etwa die Hälfte zusammengefasst.");
+
+        // Solver: frühe Stellungen (Spiegelbilder teilen TT-Einträge) gleich
+        // bewertet wie ohne TT; der beste Zug wird zurückgespiegelt
+        TranspositionTable table(16);
+        Solver solver(&table);
+        ok = true;
+        for (int i = 0; i < 3 && ok; ++i) {
+            const BitBoard b = randomOpenPosition(rng, 12);
+            const BitBoard m = BitBoard::fromKey(BitBoard::mirrorColumns(b.key()));
+            const SearchResult first = solver.solve(b);
+            const SearchResult second = solver.solve(m);
+            ok = first.score == second.score && Solver().solve(m).score == first.score
+                 && b.isValidColumn(COLS - 1 - second.bestMove);
+        }
+        assertTrue(ok, "Solver: Spiegelbild mit geteilter TT anders bewertet.");
+    }
+
+    // Test 35: Stellungsdatenbank – Zähler, Spiegelbild, Nachtragen, Neuaufbau
+#if HAS_FILESYSTEM
+    {
+        cout << "teste PositionDb: Zähler, Spiegelung, inkrementell, Neuaufbau... \n";
+        const fs::path dir = fs::temp_directory_path() / "c4_position_db";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const string players[2] = {"A", "B"};
+        const char symbols[2] = {'X', 'O'};
+        auto save = [&](const string& name, const string& cols, int result) {
+            vector<Move> moves;
+            for (char c : cols) moves.push_back({static_cast<int>(moves.size() % 2), c - '1', 0});
+            return GameLogger::save((dir / name).string(), moves, players, symbols, result);
+        };
+        auto position = [](const string& cols) {
+            BitBoard b;
+            for (char c : cols) b.dropDisc(c - '1');
+            return b;
+        };
+        bool ok = save("a.log", "4455667", 1) && save("b.log", "43", 2) && save("c.log", "45", 0)
+                  && save("d.log", "453", -1);
+        {
+            ofstream junk((dir / "junk.log").string());
+            junk << "kein Log\n";
+        }
+        vector<Move> wide = {{0, 7, 0}};
+        ok = ok && GameLogger::save((dir / "wide.log").string(), wide, players, symbols, -1, LogFormat::V3, 7, 8);
+
+        // der Katalog im selben Ordner bleibt aktuell, obwohl positions.db dazukommt
+        LogCatalog catalog;
+        string catalogStatus;
+        ok = ok && catalog.open(dir.string());
+        catalog.close();
+
+        stringstream log;
+        size_t added = 0;
+        PositionDb db;
+        PositionDb::Info start, one, left, right;
+        ok = ok && PositionDb::update(dir.string(), 2, log, &added) && added == 5
+                && catalog.open(dir.string(), &catalogStatus) && catalogStatus.find("aktuell") != string::npos
+                && db.open(dir.string())
+                && db.games() == 4 && db.lookup(BitBoard(), start) && db.lookup(position("4"), one)
+                && db.lookup(position("43"), left) && db.lookup(position("45"), right)
+                && !db.lookup(position("1"), start);
+        // leeres Brett: X am Zug, a gewinnt X, b gewinnt O, c remis, d offen
+        ok = ok && start.visits == 4 && start.wins == 1 && start.losses == 1 && start.draws == 1
+                && start.next[3] == 4;
+        ok = ok && one.visits == 4 && one.wins == 1 && one.losses == 1 && one.next[2] == 1 && one.next[3] == 1
+                && one.next[4] == 2;
+        // 43 und 45 sind Spiegelbilder: ein Eintrag, Folgezug gespiegelt
+        ok = ok && left.visits == 3 && right.visits == 3 && right.next[2] == 1 && left.next[4] == 1
+                && left.next[2] == 0;
+        db.close();
+        assertTrue(ok, "PositionDb: falsche Zähler oder Spiegelung.");
+
+        // neues Log: nur dieses wird gelesen; unlesbare lösen kein Nachtragen aus
+        string status;
+        ok = save("e.log", "4455667", 1) && db.open(dir.string(), &status)
+             && status.find("1 Logs neu") != string::npos && db.games() == 5 && db.lookup(BitBoard(), start)
+             && start.visits == 5 && start.wins == 2;
+        db.close();
+        ok = ok && db.open(dir.string(), &status) && status.find("neu") == string::npos;
+        db.close();
+        // Ordner unverändert: open() sieht die Logs nicht an, eine nur im Log
+        // selbst geänderte Zeit fällt erst mit der nächsten Ordneränderung auf
+        fs::last_write_time(dir / "c.log", fs::last_write_time(dir / "c.log") - chrono::hours(1));
+        ok = ok && db.open(dir.string(), &status) && status.find("neu") == string::npos;
+        db.close();
+        ofstream((dir / "notiz.txt").string()) << "x\n";
+        ok = ok && db.open(dir.string(), &status) && status.find("6 Logs neu") != string::npos && db.games() == 5;
+        db.close();
+        // geändertes Log: alles neu zählen
+        ok = ok && save("b.log", "4444", -1) && PositionDb::update(dir.string(), 1, log, &added) && added == 6
+                && db.open(dir.string()) && db.games() == 5 && db.lookup(position("45"), right)
+                && right.visits == 2;
+        db.close();
+
+        // mehrere Replays öffnen gleichzeitig: jedes neue Log zählt genau einmal
+        ok = ok && catalog.open(dir.string());   // nach dem überschriebenen b.log neu aufgebaut
+        catalog.close();
+        ok = ok && save("f.log", "1", -1) && save("g.log", "2", -1) && save("h.log", "3", -1);
+        vector<thread> readers;
+        for (int t = 0; t < 4; ++t)
+            readers.emplace_back([&]() {
+                PositionDb mine;
+                mine.open(dir.string());
+            });
+        for (auto& t : readers) t.join();
+        ok = ok && db.open(dir.string(), &status) && status.find("neu") == string::npos && db.games() == 8
+                && db.lookup(BitBoard(), start) && start.visits == 8;
+        db.close();
+        ok = ok && catalog.open(dir.string(), &catalogStatus) && catalogStatus.find("aktuell") != string::npos
+                && catalog.size() == 9;
+        catalog.close();
+        fs::remove_all(dir);
+        assertTrue(ok, "PositionDb: Nachtragen, Neuaufbau oder gleichzeitiges Öffnen fehlerhaft.");
+    }
+#endif
+
     cout << "Bestanden: " << passed << " | Fehlgeschlagen: " << failed << "\n";
     cout << "=================================\n\n";
+    return failed == 0;
 }
@@ -10,5 +10,6 @@ private:
     void assertTrue(bool cond, const std::string &msg);
 
 public:
-    void run();
+    // Rückgabe: true, wenn alle Tests bestanden sind
+    bool run();
 };
@@ -0,0 +1,138 @@
+#include "eventloop.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+using namespace std;
+
+EventLoop::EventLoop() {
+    if (pipe(wakeFds) != 0) {
+        wakeFds[0] = wakeFds[1] = -1;   // dann wirkt post() erst beim nächsten Aufwachen
+        return;
+    }
+    if (wakeFds[0] >= FD_SETSIZE) {      // passt nicht in ein fd_set
+        for (int& fd : wakeFds) {
+            ::close(fd);
+            fd = -1;
+        }
+        return;
+    }
+    for (int fd : wakeFds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+}
+
+EventLoop::~EventLoop() {
+    for (int fd : wakeFds)
+        if (fd >= 0) ::close(fd);
+}
+
+void EventLoop::at(Clock::time_point due, function<void()> fn) {
+    timers.push({due, nextSeq++, move(fn)});
+}
+
+void EventLoop::post(function<void()> fn) {
+    {
+        lock_guard<mutex> lock(postMutex);
+        posted.push_back(move(fn));
+    }
+    const char wake = 1;
+    if (wakeFds[1] >= 0 && ::write(wakeFds[1], &wake, 1) < 0) {
+        // Pipe voll: die Schleife ist ohnehin schon geweckt
+    }
+}
+
+void EventLoop::runPosted() {
+    char drain[64];
+    while (wakeFds[0] >= 0 && ::read(wakeFds[0], drain, sizeof(drain)) > 0) {}
+    vector<function<void()>> work;
+    {
+        lock_guard<mutex> lock(postMutex);
+        work.swap(posted);
+    }
+    for (auto& fn : work) {
+        if (!running) break;
+        fn();
+    }
+}
+
+void EventLoop::readInput() {
+    char buf[256];
+    ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) return;
+    if (n <= 0) {
+        // Eingabe zu: Zeitgeber laufen weiter, gelesen wird nichts mehr
+        eof = true;
+        if (closedHandler) closedHandler();
+        return;
+    }
+    for (ssize_t i = 0; i < n && running; ++i) {
+        if (keyHandler) {
+            keyHandler(buf[i]);
+        } else if (lineHandler) {
+            if (buf[i] != '\n') {
+                if (buf[i] != '\r') partialLine += buf[i];
+                continue;
+            }
+            string line;
+            line.swap(partialLine);
+            lineHandler(line);
+        }
+    }
+}
+
+void EventLoop::run() {
+    running = true;
+    while (running) {
+        // fällige Zeitgeber zuerst, auch solche, die ein Rückruf gerade angelegt hat
+        while (running && !timers.empty() && timers.top().due <= Clock::now()) {
+            Timer t = timers.top();
+            timers.pop();
+            t.fn();
+        }
+        if (!running) break;
+        if (timers.empty() && !readsInput()) break;
+
+        // ohne fällige Arbeit schläft select() bis zum nächsten Zeitgeber: kein Takt im Leerlauf
+        timeval timeout{};
+        timeval* timeoutPtr = nullptr;
+        if (!timers.empty()) {
+            auto wait = chrono::duration_cast<chrono::microseconds>(timers.top().due - Clock::now()).count();
+            // select() schläft eher etwas zu lang (~0,1 %): lange Wartezeiten etwas
+            // kürzer ansetzen, der Rest folgt mit einem zweiten, kurzen select()
+            if (wait > 20000) wait -= wait / 64;
+            wait = max<long long>(0, wait);
+            timeout.tv_sec = static_cast<time_t>(wait / 1000000);
+            timeout.tv_usec = static_cast<suseconds_t>(wait % 1000000);
+            timeoutPtr = &timeout;
+        }
+
+        // select() wie in MainMenu::readKey: poll() kann auf macOS keine
+        // Terminals (POLLNVAL), das sähe hier wie Eingabeende aus
+        fd_set set;
+        FD_ZERO(&set);
+        int maxFd = -1;
+        if (wakeFds[0] >= 0) {
+            FD_SET(wakeFds[0], &set);
+            maxFd = wakeFds[0];
+        }
+        const bool input = readsInput();
+        if (input) {
+            FD_SET(STDIN_FILENO, &set);
+            maxFd = max(maxFd, static_cast<int>(STDIN_FILENO));
+        }
+
+        int rv = select(maxFd + 1, &set, nullptr, nullptr, timeoutPtr);
+        if (rv < 0 && errno != EINTR) break;
+        if (rv <= 0) continue;
+
+        if (wakeFds[0] >= 0 && FD_ISSET(wakeFds[0], &set)) runPosted();
+        if (running && input && FD_ISSET(STDIN_FILENO, &set)) readInput();
+    }
+    running = false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+// Einfädige Ereignisschleife: Zeitgeber (z.B. Animationsframes, Zeitlimit)
+// und Eingaben von stdin, gewartet wird mit select() wie in MainMenu::readKey.
+// Alle Rückrufe laufen nacheinander im Thread von run(); sie dürfen neue
+// Zeitgeber anlegen und stop() aufrufen. Andere Threads reichen Arbeit
+// per post() herein.
+//
+// stdin wird direkt mit read() gelesen. Damit nichts ungesehen im
+// stdio-Puffer liegt, muss stdin ungepuffert sein (setvbuf, siehe main).
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // fn zum Zeitpunkt due bzw. frühestens nach delayMs;
+    // gleiche Fälligkeit: in Reihenfolge des Anlegens
+    void at(Clock::time_point due, std::function<void()> fn);
+    void after(long long delayMs, std::function<void()> fn) {
+        at(Clock::now() + std::chrono::milliseconds(delayMs), std::move(fn));
+    }
+
+    // Aus beliebigem Thread: fn so bald wie möglich im Thread von run()
+    void post(std::function<void()> fn);
+
+    // Eingabe: jede Taste an onKey (Terminal im RawMode) oder, ohne
+    // Tasten-Handler, ganze Zeilen an onLine. Ohne beide wird stdin nicht gelesen
+    void onKey(std::function<void(char)> fn) { keyHandler = std::move(fn); }
+    void onLine(std::function<void(const std::string&)> fn) { lineHandler = std::move(fn); }
+    // Eingabeende; Zeitgeber laufen danach weiter
+    void onClosed(std::function<void()> fn) { closedHandler = std::move(fn); }
+
+    // Bis stop() oder bis nichts mehr kommen kann: keine Zeitgeber und
+    // keine Eingabe (kein Handler bzw. Eingabe zu). post() hält run() nicht am Leben
+    void run();
+    void stop() { running = false; }
+
+    bool inputClosed() const { return eof; }
+    size_t pendingTimers() const { return timers.size(); }
+
+private:
+    struct Timer {
+        Clock::time_point due;
+        uint64_t seq;
+        std::function<void()> fn;
+        bool operator>(const Timer& o) const { return due != o.due ? due > o.due : seq > o.seq; }
+    };
+
+    bool readsInput() const { return !eof && (keyHandler || lineHandler); }
+    void readInput();
+    void runPosted();
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::function<void(char)> keyHandler;
+    std::function<void(const std::string&)> lineHandler;
+    std::function<void()> closedHandler;
+    std::string partialLine;
+    uint64_t nextSeq = 0;
+    bool running = false;
+    bool eof = false;
+
+    // post(): Warteschlange plus Weck-Pipe für select()
+    std::mutex postMutex;
+    std::vector<std::function<void()>> posted;
+    int wakeFds[2] = {-1, -1};
+};
@@ -0,0 +1,62 @@
+#include "mappedfile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : ptr(other.ptr), len(other.len), opened(other.opened) {
+    other.ptr = nullptr;
+    other.len = 0;
+    other.opened = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        ptr = other.ptr;
+        len = other.len;
+        opened = other.opened;
+        other.ptr = nullptr;
+        other.len = 0;
+        other.opened = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    len = static_cast<size_t>(st.st_size);
+    if (len > 0) {
+        void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            len = 0;
+            return false;
+        }
+        ptr = p;
+    }
+    ::close(fd); // Mapping bleibt auch ohne offenen Deskriptor gültig
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) munmap(ptr, len);
+    ptr = nullptr;
+    len = 0;
+    opened = false;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Datei read-only in den Speicher einblenden (mmap). Kein Parsen, kein
+// Kopieren: der Inhalt ist direkt über data()/size() lesbar.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const uint8_t* data() const { return static_cast<const uint8_t*>(ptr); }
+    size_t size() const { return len; }
+
+private:
+    void* ptr = nullptr;
+    size_t len = 0;
+    bool opened = false;
+};
@@ -0,0 +1,19 @@
+#include "rawmode.h"
+
+#include <unistd.h>
+
+RawMode::RawMode() {
+    if (tcgetattr(STDIN_FILENO, &oldState) != 0) return;
+
+    termios raw = oldState;
+    // Raw-ish mode (no echo, no canonical line buffering)
+    raw.c_lflag &= ~(ECHO | ICANON);
+    raw.c_cc[VMIN]  = 0; // non-blocking read with timeout via select/poll
+    raw.c_cc[VTIME] = 0;
+
+    enabled = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+}
+
+RawMode::~RawMode() {
+    if (enabled) tcsetattr(STDIN_FILENO, TCSANOW, &oldState);
+}
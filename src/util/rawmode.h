@@ -0,0 +1,19 @@
+#pragma once
+
+#include <termios.h>
+
+// Terminal für die Dauer des Objekts ohne Echo und ohne Zeilenpuffer
+// (jede Taste kommt sofort); ist stdin kein Terminal, passiert nichts
+class RawMode {
+public:
+    RawMode();
+    ~RawMode();
+    RawMode(const RawMode&) = delete;
+    RawMode& operator=(const RawMode&) = delete;
+
+    bool active() const { return enabled; }
+
+private:
+    bool enabled = false;
+    termios oldState{};
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Schnelle, reproduzierbare Zufallszahlen für Simulationen (Selbstspiel,
+// Playouts). Nicht für Kryptographie.
+
+// Mischt einen Startwert (z.B. Seed + Partie-Index) zu einem guten Zustand
+constexpr uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// xorshift64*: Zustand darf nie 0 sein
+inline uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+// Index eines zufällig gewählten gesetzten Bits (bits != 0)
+inline int randomBitIndex(uint64_t bits, uint64_t& state) {
+    int k = static_cast<int>(nextRandom(state) % static_cast<uint64_t>(__builtin_popcountll(bits)));
+    while (k-- > 0) bits &= bits - 1;
+    return __builtin_ctzll(bits);
+}
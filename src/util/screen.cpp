@@ -0,0 +1,164 @@
+#include "screen.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+    constexpr uint32_t BLANK = ' ';
+    // bis zu so vielen unveränderten Zellen werden mitgeschrieben statt übersprungen
+    constexpr int MAX_GAP = 4;
+}
+
+Screen& Screen::terminal() {
+    static Screen screen;
+    return screen;
+}
+
+Screen::Screen()
+    : next(WIDTH * HEIGHT, BLANK), shown(WIDTH * HEIGHT, BLANK), nextWidth(HEIGHT, 0), shownWidth(HEIGHT, 0) {
+    out.reserve(WIDTH * HEIGHT * 4);
+}
+
+void Screen::clear() {
+    for (int r = 0; r < used; ++r) {
+        fill_n(&next[r * WIDTH], nextWidth[r], BLANK);
+        nextWidth[r] = 0;
+    }
+    used = 0;
+    cursorWanted = {-1, -1};
+}
+
+int Screen::text(int row, int col, string_view utf8, int endCol) {
+    if (row < 0 || row >= HEIGHT) return col;
+    endCol = min(endCol, WIDTH);
+    uint32_t* cells = &next[row * WIDTH];
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(utf8.data());
+    const unsigned char* end = p + utf8.size();
+    for (; p < end && col < endCol; ++col) {
+        uint32_t cell = *p++;
+        if (cell >= 0x80) {
+            // Folgebytes (10xxxxxx) an den Codepunkt hängen
+            for (int shift = 8; p < end && (*p & 0xC0) == 0x80 && shift < 32; shift += 8)
+                cell |= uint32_t(*p++) << shift;
+        }
+        if (col >= 0) cells[col] = cell;
+    }
+    nextWidth[row] = max(nextWidth[row], col);
+    used = max(used, row + 1);
+    return col;
+}
+
+int Screen::lines(int row, int col, string_view utf8) {
+    while (true) {
+        size_t nl = utf8.find('\n');
+        text(row++, col, utf8.substr(0, nl));
+        if (nl == string_view::npos) return row;
+        utf8.remove_prefix(nl + 1);
+    }
+}
+
+string Screen::line(int row) const {
+    string s;
+    if (row < 0 || row >= HEIGHT) return s;
+    const uint32_t* cells = &next[row * WIDTH];
+    int end = nextWidth[row];
+    while (end > 0 && cells[end - 1] == BLANK) --end;
+    for (int c = 0; c < end; ++c) appendCell(s, cells[c]);
+    return s;
+}
+
+void Screen::appendCell(string& out, uint32_t cell) {
+    do {
+        out += static_cast<char>(cell & 0xFF);
+        cell >>= 8;
+    } while (cell);
+}
+
+void Screen::moveTo(int row, int col) {
+    if (row == cursorRow && col == cursorCol) return;
+    if (col == 0 && row == cursorRow + 1) {
+        out += "\r\n";
+    } else {
+        out += "\033[";
+        out += to_string(row + 1);
+        if (col > 0) {
+            out += ';';
+            out += to_string(col + 1);
+        }
+        out += 'H';
+    }
+    cursorRow = row;
+    cursorCol = col;
+}
+
+const string& Screen::render() {
+    out.clear();
+    if (!valid) {
+        out += "\033[H\033[2J";
+        for (int r = 0; r < shownUsed; ++r) {
+            fill_n(&shown[r * WIDTH], shownWidth[r], BLANK);
+            shownWidth[r] = 0;
+        }
+        shownUsed = 0;
+        cursorRow = cursorCol = 0;
+        valid = true;
+    } else {
+        // seit dem letzten Frame kann per cout geschrieben worden sein: erster Sprung absolut
+        cursorRow = -2;
+    }
+
+    for (int r = 0; r < used; ++r) {
+        const uint32_t* now = &next[r * WIDTH];
+        uint32_t* old = &shown[r * WIDTH];
+        // hinter beiden Breiten ist alles leer
+        const int width = max(nextWidth[r], shownWidth[r]);
+        shownWidth[r] = nextWidth[r];
+        if (memcmp(now, old, width * sizeof(uint32_t)) == 0) continue;
+        for (int c = 0; c < width; ++c) {
+            if (now[c] == old[c]) continue;
+            if (r == cursorRow && c > cursorCol && c - cursorCol <= MAX_GAP) {
+                // kurze Lücke: die gleichen Zellen nochmal schreiben ist billiger als ein Sprung
+                for (int k = cursorCol; k < c; ++k) appendCell(out, now[k]);
+                cursorCol = c;
+            } else {
+                moveTo(r, c);
+            }
+            appendCell(out, now[c]);
+            old[c] = now[c];
+            ++cursorCol;
+        }
+    }
+
+    // Cursor unter den Frame, Rest (alte Zeilen, Eingaben) löschen
+    moveTo(used, 0);
+    out += "\033[J";
+    for (int r = used; r < shownUsed; ++r) {
+        fill_n(&shown[r * WIDTH], shownWidth[r], BLANK);
+        shownWidth[r] = 0;
+    }
+    shownUsed = used;
+    if (cursorWanted.first >= 0) moveTo(cursorWanted.first, cursorWanted.second);
+    return out;
+}
+
+size_t Screen::present(int fd) {
+    render();
+    cout.flush();   // was per cout davor stand, muss zuerst raus
+    size_t done = 0;
+    while (done < out.size()) {
+        ssize_t n = ::write(fd, out.data() + done, out.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            valid = false;   // Terminal in unbekanntem Zustand
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
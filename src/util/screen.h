@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Bildschirm als Zeichenraster. Ein Frame wird komplett in den Puffer
+// gezeichnet (clear + text), present() vergleicht ihn mit dem zuletzt
+// ausgegebenen und schreibt nur die geänderten Zellen, mit Cursor-Sprüngen,
+// in einem einzigen write. Danach steht der Cursor unter dem Frame, alles
+// darunter (Eingaben, Meldungen per cout) ist gelöscht.
+//
+// Jeder UTF-8-Codepunkt belegt eine Zelle; das passt für Box Drawing,
+// ● ○ und die Pfeile, nicht für doppelt breite Zeichen.
+class Screen {
+public:
+    static constexpr int WIDTH = 160;
+    static constexpr int HEIGHT = 60;
+
+    // Gemeinsamer Bildschirm des Terminals (stdout)
+    static Screen& terminal();
+
+    Screen();
+
+    // Neuer Frame: Puffer leeren, der zuletzt ausgegebene bleibt für den Vergleich
+    void clear();
+
+    // Text ab (row, col); schneidet bei endCol (höchstens am Rand) ab.
+    // Rückgabe: Spalte hinter dem Text
+    int text(int row, int col, std::string_view utf8, int endCol = WIDTH);
+
+    // Mehrere Zeilen ('\n' getrennt) ab row. Rückgabe: erste freie Zeile
+    int lines(int row, int col, std::string_view utf8);
+
+    // Cursor nach present() hier statt unter dem Frame (z.B. Eingabefeld);
+    // gilt bis zum nächsten clear()
+    void cursorAt(int row, int col) { cursorWanted = {row, col}; }
+
+    // Zeilen, die der aktuelle Frame belegt
+    int height() const { return used; }
+
+    // Zeile row des aktuellen Frames als UTF-8, ohne Leerzeichen am Ende
+    std::string line(int row) const;
+
+    // Diff zum letzten Frame als Escape-Folge (gilt danach als ausgegeben)
+    const std::string& render();
+
+    // render() und ein write auf fd. Rückgabe: geschriebene Bytes
+    size_t present(int fd = 1);
+
+    // Inhalt des Terminals unbekannt (clearScreen, fremde Ausgabe):
+    // der nächste present() zeichnet alles neu
+    void invalidate() { valid = false; }
+
+private:
+    // Zelle = UTF-8-Bytes eines Codepunkts, ab dem niedrigsten Byte gepackt
+    static void appendCell(std::string& out, uint32_t cell);
+    void moveTo(int row, int col);
+
+    std::vector<uint32_t> next;   // wird gezeichnet
+    std::vector<uint32_t> shown;  // steht im Terminal
+    std::vector<int> nextWidth;   // je Zeile: dahinter nur Leerzeichen
+    std::vector<int> shownWidth;
+    int used = 0;
+    int shownUsed = 0;
+    bool valid = false;
+    int cursorRow = 0;
+    int cursorCol = 0;
+    std::pair<int, int> cursorWanted{-1, -1};
+    std::string out;
+};
@@ -1,4 +1,5 @@
 #include "util.h"
+#include "screen.h"
 
 #include <cctype>
 #include <iostream>
@@ -6,8 +7,8 @@
 #include <algorithm>
 #include <string>
 #include <vector>
-#include <chrono>
-#include <thread>
+
+#include <sys/stat.h>
 
 #if __has_include(<filesystem>)
   #include <filesystem>
@@ -39,6 +40,13 @@ bool isNumber(const string& s) {
     return true;
 }
 
+size_t utf8Length(const string& s, size_t maxBytes) {
+    if (s.size() <= maxBytes) return s.size();
+    size_t len = maxBytes;
+    while (len > 0 && (static_cast<unsigned char>(s[len]) & 0xC0) == 0x80) --len;
+    return len;
+}
+
 void pressEnterToContinue() {
     cout << "Weiter mit Enter...";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -47,15 +55,6 @@ void pressEnterToContinue() {
     getline(cin, dummy);
 }
 
-void showCountdown(int seconds) {
-    using namespace std;
-    for (int i = seconds; i > 0; --i) {
-        cout << "\rZeitlimit: " << i << "s " << flush;
-        this_thread::sleep_for(chrono::seconds(1));
-    }
-    cout << "\rZeitlimit: 0s \n";
-}
-
 vector<string> listLogFiles(const string& folder) {
     vector<string> files;
 
@@ -80,8 +79,19 @@ vector<string> listLogFiles(const string& folder) {
     return files;
 }
 
+int64_t dirMtimeNs(const string& folder) {
+    struct stat st{};
+    if (stat(folder.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return -1;
+#ifdef __APPLE__
+    return int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    return int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
 void clearScreen() {
     cout << "\033[2J\033[H\033[3J" << flush;
+    Screen::terminal().invalidate();
 }
 
 void pressEnterToGoToMain() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,12 +8,16 @@
 void clearInputLine();
 void clearInputLine2();
 bool isNumber(const std::string& s);
+// Länge von s, gekürzt auf höchstens maxBytes, aber nie mitten in einem
+// UTF-8-Zeichen
+size_t utf8Length(const std::string& s, size_t maxBytes);
 void pressEnterToContinue();
-void showCountdown(int seconds);
 void clearScreen();
 void pressEnterToGoToMain();
 void waitEnterAfterCin();
 void waitEnterPlain();
 
 std::vector<std::string> listLogFiles(const std::string& folder = "logs/");
+// Änderungszeit eines Ordners in Nanosekunden, -1 = Ordner fehlt
+int64_t dirMtimeNs(const std::string& folder);
 